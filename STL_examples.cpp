@@ -1,7 +1,47 @@
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <execution>
 #include <random>
 #include <iterator>
+#include <set>
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <map>
+#include <forward_list>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <cstdio>
+#include <cstring>
+
+#include "arena.h"
+#include "dary_heap.h"
+#include "eytzinger_index.h"
+#include "external_sort.h"
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "parallel_algorithms.h"
+#include "parallel_reduce.h"
+#include "parallel_scan.h"
+#include "permutation.h"
+#include "pipeline.h"
+#include "radix_sort.h"
+#include "random_sampling.h"
+#include "selection.h"
+#include "set_operations.h"
+#include "sort_by_key.h"
+#include "simd_byte_set.h"
+#include "simd_compaction.h"
+#include "simd_compare.h"
+#include "simd_minmax.h"
+#include "simd_search.h"
+#include "simd_unique.h"
+#include "substring_search.h"
 
 // Examples for each STL algorithm. Verified with Google test suite. While code duplication is rampant,
 // The goal is to provide self-fulfilling examples that can be pulled individually
@@ -15,6 +55,74 @@
 // I would hit (command + f) on my keyboard and type:
 //       TEST(stable_sort
 
+// Report mode: with STL_EXAMPLES_REPORT=1, prints the time of each TEST family,
+// next to the counts of instrumentation.h made while it ran, when it is built
+// with -DSTL_EXAMPLES_INSTRUMENT=ON.
+class ReportListener : public testing::EmptyTestEventListener {
+public:
+    void OnTestSuiteStart(const testing::TestSuite&) override {
+        start_ = stl_examples::instrument::snapshot();
+    }
+
+    void OnTestSuiteEnd(const testing::TestSuite& suite) override {
+        const stl_examples::instrument::Counts counts = stl_examples::instrument::snapshot() - start_;
+        std::printf("[ report   ] %s: %lld ms %s\n", suite.name(), static_cast<long long>(suite.elapsed_time()),
+                    stl_examples::instrument::to_string(counts).c_str());
+    }
+
+private:
+    stl_examples::instrument::Counts start_;
+};
+
+const bool report_listener_added = [] {
+    // Google Test takes ownership of the listener.
+    if (stl_examples::instrument::report_mode()) testing::UnitTest::GetInstance()->listeners().Append(new ReportListener);
+    return true;
+}();
+
+// Runs fn() at each SIMD level this machine supports, the level being in the
+// trace of any failure. The simd:: tests compare every level with std this way.
+template<class Fn>
+void ForEachSimdLevel(Fn fn) {
+    namespace simd = stl_examples::simd;
+    for (const simd::Level level : simd::supported_levels()) {
+        const simd::ScopedLevel scoped_level(level);
+        SCOPED_TRACE("simd level " + std::to_string(static_cast<int>(level)));
+        fn();
+    }
+}
+
+// True if a and b hold the same bytes: NaNs compare equal, and -0.0 differs from
+// 0.0, so that the simd results match std to the bit.
+template<class T>
+bool BitwiseEqual(const std::vector<T>& a, const std::vector<T>& b) {
+    if (a.size() != b.size()) return false;
+    if (a.empty()) return true;
+    return std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// n random values of T: over its whole range for integers, and in [-1e6, 1e6]
+// for floating point. Given [lo, hi], integers drawn uniformly from it instead.
+template<class T, class Gen>
+std::vector<T> RandomVector(Gen& gen, std::size_t n) {
+    std::vector<T> v(n);
+    if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_real_distribution<T> values(-1e6, 1e6);
+        std::generate(v.begin(), v.end(), [&]{ return values(gen); });
+    } else {
+        std::generate(v.begin(), v.end(), [&]{ return static_cast<T>(gen()); });
+    }
+    return v;
+}
+
+template<class T, class Gen>
+std::vector<T> RandomVector(Gen& gen, std::size_t n, int lo, int hi) {
+    std::uniform_int_distribution<int> values(lo, hi);
+    std::vector<T> v(n);
+    std::generate(v.begin(), v.end(), [&]{ return static_cast<T>(values(gen)); });
+    return v;
+}
+
 // Non-modifying sequence operations.
 TEST(any_of, ExampleOne) {
     const std::vector<int> numbers{1,2,3,4,4,5};
@@ -104,6 +212,15 @@ TEST(count_if, ExampleOne) {
     EXPECT_EQ(num_lowercase_letters, 3);
 }
 
+TEST(count_if, ExampleTwoSimd) {
+    // simd::count_if compares 32 or 64 chars at once when the predicate is
+    // a simd::equal_to or simd::in_range. See simd_search.h.
+    namespace simd = stl_examples::simd;
+    const std::vector<char> v{'1', '2', '3', 'a', 'b', 'c', '4', '5'};
+    const auto num_lowercase_letters = simd::count_if(v.cbegin(), v.cend(), simd::in_range<char>{'a', 'z'});
+    EXPECT_EQ(num_lowercase_letters, 3);
+}
+
 TEST(mismatch, ExampleOneUsingInequality) {
     const std::vector<int> v1{1,2,3,4,42};
     const std::vector<int> v2{1,2,3,4,5};
@@ -124,6 +241,79 @@ TEST(mismatch, ExampleTwoUsingComparator) {
     EXPECT_EQ(*v2_miss, 41);
 }
 
+template<class T>
+void ExpectSimdCompareMatchesStd(const std::vector<T>& a, const std::vector<T>& b) {
+    namespace simd = stl_examples::simd;
+    const std::size_t n = std::min(a.size(), b.size());
+    const auto expected_mismatch = std::mismatch(a.cbegin(), a.cbegin() + n, b.cbegin()).first - a.cbegin();
+    const bool expected_equal = std::equal(a.cbegin(), a.cend(), b.cbegin(), b.cend());
+    const bool expected_less = std::lexicographical_compare(a.cbegin(), a.cend(), b.cbegin(), b.cend());
+    ForEachSimdLevel([&] {
+        EXPECT_EQ(simd::mismatch(a.cbegin(), a.cbegin() + n, b.cbegin()).first - a.cbegin(), expected_mismatch);
+        EXPECT_EQ(simd::mismatch(a.cbegin(), a.cend(), b.cbegin(), b.cend()).first - a.cbegin(), expected_mismatch);
+        EXPECT_EQ(simd::equal(a.cbegin(), a.cbegin() + n, b.cbegin()), expected_mismatch == static_cast<std::ptrdiff_t>(n));
+        EXPECT_EQ(simd::equal(a.cbegin(), a.cend(), b.cbegin(), b.cend()), expected_equal);
+        EXPECT_EQ(simd::lexicographical_compare(a.cbegin(), a.cend(), b.cbegin(), b.cend()), expected_less);
+        EXPECT_EQ(simd::lexicographical_compare(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::less<T>()), expected_less);
+    });
+}
+
+template<class T>
+void ExpectSimdCompareMatchesStd() {
+    std::mt19937 gen(24);
+    for (const std::size_t size : {0, 1, 7, 31, 32, 33, 64, 100, 257, 1000}) {
+        SCOPED_TRACE(size);
+        std::vector<T> a = RandomVector<T>(gen, size, -200, 200);
+        ExpectSimdCompareMatchesStd(a, a);
+        // A difference at each position, up or down, and a shorter or longer range.
+        for (std::size_t at = 0; at < size; at += 1 + size / 8) {
+            std::vector<T> b = a;
+            b[at] = static_cast<T>(b[at] + 1);
+            ExpectSimdCompareMatchesStd(a, b);
+            ExpectSimdCompareMatchesStd(b, a);
+        }
+        ExpectSimdCompareMatchesStd(a, std::vector<T>(a.cbegin(), a.cbegin() + size / 2));
+        ExpectSimdCompareMatchesStd(std::vector<T>(a.cbegin(), a.cbegin() + size / 2), a);
+        if constexpr (std::is_floating_point_v<T>) {
+            // A NaN is never equal, but neither before nor after; -0.0 equals 0.0.
+            if (size > 2) {
+                std::vector<T> b = a;
+                a[size / 2] = b[size / 2] = std::numeric_limits<T>::quiet_NaN();
+                a[0] = T{0}, b[0] = -T{0};
+                ExpectSimdCompareMatchesStd(a, b);
+                b[size - 1] = static_cast<T>(b[size - 1] - 1);
+                ExpectSimdCompareMatchesStd(a, b);
+            }
+        }
+    }
+}
+
+TEST(mismatch, ExampleThreeSimdMatchesStd) {
+    ExpectSimdCompareMatchesStd<char>();
+    ExpectSimdCompareMatchesStd<signed char>();
+    ExpectSimdCompareMatchesStd<unsigned char>();
+    ExpectSimdCompareMatchesStd<std::int16_t>();
+    ExpectSimdCompareMatchesStd<int>();
+    ExpectSimdCompareMatchesStd<unsigned>();
+    ExpectSimdCompareMatchesStd<std::int64_t>();
+    ExpectSimdCompareMatchesStd<std::uint64_t>();
+    ExpectSimdCompareMatchesStd<float>();
+    ExpectSimdCompareMatchesStd<double>();
+}
+
+TEST(mismatch, ExampleFourSimdWithComparator) {
+    // Any other predicate is still honoured, by the std algorithm.
+    namespace simd = stl_examples::simd;
+    const std::vector<int> v1{0,1,2,3,42};
+    const std::vector<int> v2{1,2,3,4,41};
+    const auto lessThan = [](int a, int b)->bool{ return a < b; };
+    const auto [v1_miss, v2_miss] = simd::mismatch(v1.cbegin(), v1.cend(), v2.cbegin(), lessThan);
+    EXPECT_EQ(*v1_miss, 42);
+    EXPECT_EQ(*v2_miss, 41);
+    EXPECT_TRUE(simd::equal(v1.cbegin(), v1.cend() - 1, v2.cbegin(), [](int a, int b){ return a + 1 == b; }));
+    EXPECT_TRUE(simd::lexicographical_compare(v2.cbegin(), v2.cend(), v1.cbegin(), v1.cend(), std::greater<>()));
+}
+
 TEST(find, ExampleOne) {
     const std::vector<int> v{1,2,3,4,5};
     const auto value = std::find(v.cbegin(), v.cend(), 3);
@@ -139,6 +329,60 @@ TEST(find, ExampleTwoEmptySet) {
     EXPECT_TRUE(value == v.cend());
 }
 
+TEST(find, ExampleThreeParallel) {
+    // Most algorithms take an execution policy as their first argument.
+    // std::execution::par allows the search to be split across threads.
+    std::vector<int> v(100000, 1);
+    v[54321] = 3;
+    const auto value = std::find(std::execution::par, v.cbegin(), v.cend(), 3);
+    EXPECT_EQ(value - v.cbegin(), 54321);
+}
+
+TEST(find, ExampleFourSimd) {
+    namespace simd = stl_examples::simd;
+    std::vector<int> v(1000, 1);
+    v[777] = 3;
+    const auto value = simd::find(v.cbegin(), v.cend(), 3);
+    EXPECT_EQ(value - v.cbegin(), 777);
+    EXPECT_TRUE(simd::find(v.cbegin(), v.cend(), 4) == v.cend());
+}
+
+template<class T>
+void ExpectSimdSearchMatchesStd() {
+    namespace simd = stl_examples::simd;
+    std::mt19937 gen(42);
+    for (const std::size_t size : {0, 1, 31, 64, 65, 200, 1000}) {
+        std::vector<T> v = RandomVector<T>(gen, size, 0, 7);
+        if (size > 0) v[size - 1] = std::numeric_limits<T>::max();
+        const simd::equal_to<T> equal_to{static_cast<T>(5)};
+        const simd::in_range<T> in_range{static_cast<T>(2), std::numeric_limits<T>::max()};
+        ForEachSimdLevel([&] {
+            EXPECT_EQ(simd::find(v.cbegin(), v.cend(), 5), std::find(v.cbegin(), v.cend(), 5));
+            EXPECT_EQ(simd::find(v.cbegin(), v.cend(), -1), std::find(v.cbegin(), v.cend(), -1));
+            EXPECT_EQ(simd::find_if(v.cbegin(), v.cend(), in_range), std::find_if(v.cbegin(), v.cend(), in_range));
+            EXPECT_EQ(simd::find_if_not(v.cbegin(), v.cend(), equal_to), std::find_if_not(v.cbegin(), v.cend(), equal_to));
+            EXPECT_EQ(simd::count(v.cbegin(), v.cend(), 5), std::count(v.cbegin(), v.cend(), 5));
+            EXPECT_EQ(simd::count_if(v.cbegin(), v.cend(), in_range), std::count_if(v.cbegin(), v.cend(), in_range));
+            EXPECT_EQ(simd::any_of(v.cbegin(), v.cend(), equal_to), std::any_of(v.cbegin(), v.cend(), equal_to));
+            EXPECT_EQ(simd::all_of(v.cbegin(), v.cend(), in_range), std::all_of(v.cbegin(), v.cend(), in_range));
+            EXPECT_EQ(simd::none_of(v.cbegin(), v.cend(), in_range), std::none_of(v.cbegin(), v.cend(), in_range));
+        });
+    }
+}
+
+TEST(find, ExampleFiveSimdMatchesStd) {
+    // Every element type and SIMD level gives the same answers as the std algorithms.
+    ExpectSimdSearchMatchesStd<char>();
+    ExpectSimdSearchMatchesStd<std::int8_t>();
+    ExpectSimdSearchMatchesStd<std::uint8_t>();
+    ExpectSimdSearchMatchesStd<std::int16_t>();
+    ExpectSimdSearchMatchesStd<std::uint16_t>();
+    ExpectSimdSearchMatchesStd<int>();
+    ExpectSimdSearchMatchesStd<unsigned>();
+    ExpectSimdSearchMatchesStd<std::int64_t>();
+    ExpectSimdSearchMatchesStd<std::uint64_t>();
+}
+
 TEST(find_if, ExampleOne) {
     const std::vector<int> v{-1,-2,3,-4,-5};
     auto isGreaterThanZero = [](int i)->bool{ return i > 0; };
@@ -163,6 +407,19 @@ TEST(find_end, ExampleOne) {
     EXPECT_EQ(last_sequence_iterator - v.cbegin(), 8); // Iterator begins at last sub-sequence.
 }
 
+TEST(find_end, ExampleTwoBackward) {
+    // substring::find_end runs the filter of substring::simd_searcher from the end
+    // of the text, so that it stops at the last match instead of passing every one.
+    namespace substring = stl_examples::substring;
+    const std::string log = "12:00 ERROR disk full\n12:01 INFO retry\n12:02 ERROR disk full\n12:03 INFO ok\n";
+    const std::string pattern = "ERROR disk";
+    ForEachSimdLevel([&] {
+        EXPECT_EQ(substring::find_end(log.cbegin(), log.cend(), pattern.cbegin(), pattern.cend()) - log.cbegin(), 45);
+        // As with std::find_end, an empty pattern is not found.
+        EXPECT_EQ(substring::find_end(log.cbegin(), log.cend(), pattern.cend(), pattern.cend()), log.cend());
+    });
+}
+
 // Note that find_first_of() is looking for ANY of the elements
 // in the search range. This is different from search(), which is looking
 // for the entire sequence.
@@ -197,6 +454,70 @@ TEST(find_first_of, ExampleTwoWithPredicate) {
     EXPECT_EQ(iterator - v.cbegin(), 5);
 }
 
+TEST(find_first_of, ExampleThreeByteSet) {
+    // A simd::byte_set is compiled once and then looks up 64 bytes at a time
+    // with AVX-512, however many bytes it holds. See simd_byte_set.h.
+    namespace simd = stl_examples::simd;
+    const simd::byte_set delimiters(" ,;");
+    const std::string line = "alpha, beta;gamma  delta";
+    std::vector<std::string> tokens;
+    for (auto it = line.cbegin(); it != line.cend(); ) {
+        const auto end = simd::find_first_of(it, line.cend(), delimiters);
+        tokens.emplace_back(it, end);
+        it = simd::find_first_not_of(end, line.cend(), delimiters);
+    }
+    EXPECT_EQ(tokens, (std::vector<std::string>{"alpha", "beta", "gamma", "delta"}));
+    EXPECT_TRUE(delimiters(';'));
+    EXPECT_FALSE(delimiters('a'));
+}
+
+TEST(find_first_of, ExampleFourIgnoreCase) {
+    // With case_folding::ascii, the set holds both cases of its letters, and
+    // equal_ignore_case compares chars that way, without std::tolower's locale.
+    namespace simd = stl_examples::simd;
+    const std::vector<char> v{'1', '2', 'W', 'O', 'R', 'D', '3', '3'};
+    const simd::byte_set letters("wrd", simd::case_folding::ascii);
+    EXPECT_EQ(simd::find_first_of(v.cbegin(), v.cend(), letters) - v.cbegin(), 2);
+    EXPECT_EQ(simd::find_first_not_of(v.cbegin() + 2, v.cend(), letters) - v.cbegin(), 3);
+
+    const std::vector<char> sequence{'w', 'r', 'd'};
+    const auto iterator = std::find_first_of(v.cbegin(), v.cend(), sequence.cbegin(), sequence.cend(), simd::equal_ignore_case());
+    EXPECT_EQ(iterator - v.cbegin(), 2);
+    const std::string word = "word";
+    EXPECT_EQ(std::search(v.cbegin(), v.cend(), word.cbegin(), word.cend(), simd::equal_ignore_case()) - v.cbegin(), 2);
+    EXPECT_EQ(simd::ascii_to_lower('Q'), 'q');
+    EXPECT_EQ(simd::ascii_to_lower('['), '[');
+    EXPECT_EQ(simd::ascii_to_lower('\xC9'), '\xC9');
+}
+
+// Compares the byte_set lookups with the bitmap, for every byte value, at every SIMD level.
+TEST(find_first_of, ExampleFiveByteSetMatchesStd) {
+    namespace simd = stl_examples::simd;
+    std::mt19937 gen(22);
+    for (int trial = 0; trial < 200; ++trial) {
+        std::string chars(trial % 40, ' ');
+        for (char& c : chars) c = static_cast<char>(gen());
+        const simd::byte_set set(chars, trial % 2 == 0 ? simd::case_folding::none : simd::case_folding::ascii);
+        for (int c = 0; c < 256; ++c) {
+            const bool expected = chars.find(static_cast<char>(c)) != std::string::npos ||
+                                  (trial % 2 != 0 && std::isalpha(c) && chars.find(static_cast<char>(c ^ 0x20)) != std::string::npos);
+            ASSERT_EQ(set.contains(static_cast<unsigned char>(c)), expected) << c;
+        }
+
+        std::string text(gen() % 300, ' ');
+        for (char& c : text) c = static_cast<char>(gen());
+        SCOPED_TRACE(trial);
+        const auto expected_in = std::find_if(text.cbegin(), text.cend(), set) - text.cbegin();
+        const auto expected_out = std::find_if_not(text.cbegin(), text.cend(), set) - text.cbegin();
+        const auto expected_of = std::find_first_of(text.cbegin(), text.cend(), chars.cbegin(), chars.cend()) - text.cbegin();
+        ForEachSimdLevel([&] {
+            EXPECT_EQ(simd::find_first_of(text.cbegin(), text.cend(), set) - text.cbegin(), expected_in);
+            EXPECT_EQ(simd::find_first_not_of(text.cbegin(), text.cend(), set) - text.cbegin(), expected_out);
+            EXPECT_EQ(simd::find_first_of(text.cbegin(), text.cend(), chars.cbegin(), chars.cend()) - text.cbegin(), expected_of);
+        });
+    }
+}
+
 TEST(adjacent_find, ExampleOne) {
     const std::vector<int> v{1,2,3,4,4,5};
     // Given no predicate, this will find the first adjacent pair and return
@@ -216,6 +537,17 @@ TEST(adjacent_find, ExampleTwoWithPredicate) {
     EXPECT_EQ(iterator - v.cbegin(), 3);
 }
 
+TEST(adjacent_find, ExampleThreeSimd) {
+    // simd::adjacent_find compares a vector of elements with the same vector
+    // shifted by one, 8 int64s at a time with AVX-512. See simd_unique.h.
+    namespace simd = stl_examples::simd;
+    std::vector<std::int64_t> ids(100);
+    std::iota(ids.begin(), ids.end(), 1000);
+    EXPECT_EQ(simd::adjacent_find(ids.cbegin(), ids.cend()), ids.cend());
+    ids[58] = ids[57];
+    EXPECT_EQ(simd::adjacent_find(ids.cbegin(), ids.cend()) - ids.cbegin(), 57);
+}
+
 TEST(search, ExampleTwoWithPredicate) {
     const std::vector<char> v{'w', 'o', 'r', 'd', '1', 'W', 'O', 'R', 'D', '3', '3'};
     const std::vector<char> sequence = {'w', 'o', 'r', 'd'};
@@ -227,6 +559,89 @@ TEST(search, ExampleTwoWithPredicate) {
     EXPECT_EQ(iterator - v.cbegin(), 5);
 }
 
+TEST(search, ExampleThreeSearchers) {
+    // The searchers of substring_search.h plug into std::search, as std::boyer_moore_searcher does.
+    namespace substring = stl_examples::substring;
+    const std::string log = "GET /index.html 200\nGET /login 302\nPOST /login 500\n";
+    const std::string pattern = "/login 500";
+    const auto expected = std::search(log.cbegin(), log.cend(), std::boyer_moore_searcher(pattern.cbegin(), pattern.cend()));
+    EXPECT_EQ(expected - log.cbegin(), 40);
+    EXPECT_EQ(std::search(log.cbegin(), log.cend(), substring::horspool_searcher(pattern.cbegin(), pattern.cend())), expected);
+    EXPECT_EQ(std::search(log.cbegin(), log.cend(), substring::two_way_searcher(pattern.cbegin(), pattern.cend())), expected);
+    EXPECT_EQ(std::search(log.cbegin(), log.cend(), substring::simd_searcher(pattern.cbegin(), pattern.cend())), expected);
+    EXPECT_EQ(substring::search(log.cbegin(), log.cend(), pattern.cbegin(), pattern.cend()), expected);
+}
+
+// Compares the substring searches with the std ones, on texts of a few letters,
+// where partial matches are everywhere, at every SIMD level.
+TEST(search, ExampleFourSubstringMatchesStd) {
+    namespace substring = stl_examples::substring;
+    std::mt19937 gen(21);
+    for (int trial = 0; trial < 2000; ++trial) {
+        const int letters = 1 + trial % 4;
+        std::string text(gen() % 300, 'a');
+        std::string pattern(trial % 7 == 0 ? gen() % 80 : gen() % 12, 'a');
+        for (char& c : text) c = static_cast<char>('a' + gen() % letters);
+        for (char& c : pattern) c = static_cast<char>('a' + gen() % letters);
+        if (!pattern.empty() && pattern.size() < text.size() && gen() % 2 == 0) {
+            text.replace(gen() % (text.size() - pattern.size() + 1), pattern.size(), pattern);
+        }
+        SCOPED_TRACE(text + " / " + pattern);
+        const auto expected = std::search(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend());
+        const auto expected_end = std::find_end(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend());
+        ForEachSimdLevel([&] {
+            EXPECT_EQ(std::search(text.cbegin(), text.cend(), substring::horspool_searcher(pattern.cbegin(), pattern.cend())), expected);
+            EXPECT_EQ(std::search(text.cbegin(), text.cend(), substring::two_way_searcher(pattern.cbegin(), pattern.cend())), expected);
+            EXPECT_EQ(std::search(text.cbegin(), text.cend(), substring::simd_searcher(pattern.cbegin(), pattern.cend())), expected);
+            EXPECT_EQ(substring::find_end(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend()), expected_end);
+        });
+    }
+}
+
+TEST(search, ExampleFivePathological) {
+    // A pattern of 'a's ending in 'b', in a text of 'a's: the first and last bytes
+    // match at nearly every position, so simd_searcher hands the text over to the
+    // two-way algorithm, which stays linear.
+    namespace substring = stl_examples::substring;
+    std::string text(1 << 20, 'a');
+    std::string pattern(1000, 'a');
+    pattern.back() = 'b';
+    text.replace(text.size() - pattern.size(), pattern.size(), pattern);
+    ForEachSimdLevel([&] {
+        const auto match = substring::search(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend());
+        EXPECT_EQ(text.cend() - match, 1000);
+    });
+}
+
+TEST(search_n, ExampleOne) {
+    // search_n() finds the first run of 'count' elements equal to a value.
+    const std::vector<int> v{1,0,0,2,0,0,0,3};
+    const auto iterator = std::search_n(v.cbegin(), v.cend(), 3, 0);
+    EXPECT_EQ(iterator - v.cbegin(), 4);
+    EXPECT_EQ(std::search_n(v.cbegin(), v.cend(), 4, 0), v.cend());
+}
+
+TEST(search_n, ExampleTwoRunLengthAware) {
+    // substring::search_n checks the last element of each window of 'count'
+    // elements first: if it differs from the value, the whole window is skipped.
+    namespace substring = stl_examples::substring;
+    std::mt19937 gen(22);
+    for (const int letters : {1, 2, 3}) {
+        std::vector<int> v(500);
+        std::generate(v.begin(), v.end(), [&]{ return static_cast<int>(gen() % letters); });
+        const std::deque<int> d(v.cbegin(), v.cend());
+        for (int count = 0; count < 12; ++count) {
+            SCOPED_TRACE(count);
+            const auto expected = std::search_n(v.cbegin(), v.cend(), count, 0) - v.cbegin();
+            ForEachSimdLevel([&] {
+                EXPECT_EQ(substring::search_n(v.cbegin(), v.cend(), count, 0) - v.cbegin(), expected);
+                EXPECT_EQ(substring::search_n(d.cbegin(), d.cend(), count, 0) - d.cbegin(), expected);
+                EXPECT_EQ(substring::search_n(v.cbegin(), v.cend(), count, 0, std::equal_to<>()) - v.cbegin(), expected);
+            });
+        }
+    }
+}
+
 // Modifying sequence operations.
 
 // Note that copy_n() also exists that takes in another
@@ -252,6 +667,76 @@ TEST(copy_if, ExampleOne) {
     EXPECT_EQ(from, to);
 }
 
+TEST(copy_if, ExampleTwoFusedPipeline) {
+    // Each element goes through the filter, the square and the sum before the
+    // next one is read, so there is no vector between the steps.
+    namespace pipeline = stl_examples::pipeline;
+    const std::vector<int> v{1,2,3,-4,-5,6};
+    const auto isPositive = [](int i){ return i > 0; };
+    const auto square = [](int i){ return static_cast<long>(i) * i; };
+    const long total = v | std::views::filter(isPositive) | std::views::transform(square) | pipeline::reduce(0L);
+    EXPECT_EQ(total, 1 + 4 + 9 + 36);
+
+    const std::vector<long> squares = v | std::views::filter(isPositive) | std::views::transform(square) | pipeline::to_vector;
+    EXPECT_EQ(squares, (std::vector<long>{1, 4, 9, 36}));
+
+    // A scan stage gives the running totals, like std::inclusive_scan.
+    const std::vector<long> totals = v | std::views::filter(isPositive) | std::views::transform(square) | pipeline::scan() | pipeline::to_vector;
+    EXPECT_EQ(totals, (std::vector<long>{1, 5, 14, 50}));
+    // Stages after the scan see the running totals.
+    const auto running_max = v | pipeline::scan([](int a, int b){ return std::max(a, b); }) | std::views::take_while(isPositive) | pipeline::to_vector;
+    EXPECT_EQ(running_max, (std::vector<int>{1, 2, 3, 3, 3, 6}));
+    const std::vector<int> empty;
+    EXPECT_TRUE((empty | pipeline::scan() | pipeline::to_vector).empty());
+}
+
+TEST(copy_if, ExampleThreeArena) {
+    // Growing a vector through back_inserter reallocates as it goes; the arena
+    // variant reserves the most the output can hold, and allocates once.
+    namespace arena = stl_examples::arena;
+    std::vector<int> from(1000);
+    std::iota(from.begin(), from.end(), -500);
+    const auto isPositive = [](int i){ return i > 0; };
+
+    arena::CountingResource counting;
+    std::pmr::vector<int> grown(&counting);
+    std::copy_if(from.cbegin(), from.cend(), std::back_inserter(grown), isPositive);
+    EXPECT_GT(counting.allocations(), 1);
+    EXPECT_EQ(counting.bytes_in_use(), grown.capacity() * sizeof(int));
+    EXPECT_GE(counting.peak_bytes(), counting.bytes_in_use());
+
+    counting.reset();
+    const std::pmr::vector<int> positive = arena::copy_if(&counting, from.cbegin(), from.cend(), isPositive);
+    EXPECT_EQ(positive, grown);
+    EXPECT_EQ(counting.allocations(), 1);
+    EXPECT_EQ(counting.bytes_allocated(), from.size() * sizeof(int));
+
+    // With an arena on the stack over null_memory_resource, which throws
+    // std::bad_alloc when asked for memory, a whole pipeline runs without
+    // touching the heap.
+    std::array<std::byte, 8192> buffer;
+    arena::CountingResource heap(std::pmr::null_memory_resource());
+    std::pmr::monotonic_buffer_resource request(buffer.data(), buffer.size(), &heap);
+    const auto squares = arena::copy_if(&request, from.cbegin(), from.cend(), isPositive)
+                         | std::views::transform([](int i){ return i * i; })
+                         | stl_examples::pipeline::to_pmr_vector(&request);
+    EXPECT_EQ(squares.size(), 499);
+    EXPECT_EQ(squares.back(), 499 * 499);
+    EXPECT_EQ(heap.allocations(), 0);
+    // The buffer is now too small for another copy.
+    EXPECT_THROW(arena::copy_if(&request, from.cbegin(), from.cend(), isPositive), std::bad_alloc);
+}
+
+TEST(copy_if, ExampleFourSimd) {
+    // simd::copy_if packs the matching elements together without branching on
+    // each one, 16 ints at a time with AVX-512. See simd_compaction.h.
+    namespace simd = stl_examples::simd;
+    const std::vector<int> from{1,2,3,-4,-5,6};
+    std::vector<int> to(from.size());
+    to.erase(simd::copy_if(from.cbegin(), from.cend(), to.begin(), simd::in_range<int>{1, 1000}), to.end());
+    EXPECT_EQ(to, (std::vector<int>{1,2,3,6}));
+}
+
 TEST(copy_backward, ExampleOne) {
     const std::vector<int> from{1,2,3,4,5};
     std::vector<int> to(10);
@@ -319,6 +804,24 @@ TEST(remove, ExampleOne) {
 
 }
 
+TEST(remove, ExampleTwoSimd) {
+    // simd::remove is simd::remove_if with simd::equal_to. See simd_compaction.h.
+    namespace simd = stl_examples::simd;
+    std::string s = "H_e_l_l_o";
+    s.erase(simd::remove(s.begin(), s.end(), '_'), s.end());
+    EXPECT_EQ(s, "Hello");
+
+    // As with std::remove, nothing compares equal to a value that does not fit
+    // the element type, or to a NaN.
+    std::vector<int> v{1,0,2,0,3};
+    EXPECT_EQ(simd::remove(v.begin(), v.end(), 0.5) - v.begin(), 5);
+    v.erase(simd::remove(v.begin(), v.end(), 0L), v.end());
+    EXPECT_EQ(v, (std::vector<int>{1,2,3}));
+    std::vector<double> d{1.0, std::numeric_limits<double>::quiet_NaN(), -0.0};
+    EXPECT_EQ(simd::remove(d.begin(), d.end(), std::numeric_limits<double>::quiet_NaN()) - d.begin(), 3);
+    EXPECT_EQ(simd::remove(d.begin(), d.end(), 0.0) - d.begin(), 2);
+}
+
 // Note that remove_if_copy() also exists, which copies the range,
 // omitting anything that doesn't fit the criteria.
 TEST(remove_if, ExampleOne) {
@@ -333,6 +836,72 @@ TEST(remove_if, ExampleOne) {
     EXPECT_EQ(s2, "hello");
 }
 
+// Compares the simd compaction algorithms with the std ones on 'v', at every SIMD level.
+template<class T, class Pred>
+void ExpectSimdCompactionMatchesStd(const std::vector<T>& v, Pred pred) {
+    namespace simd = stl_examples::simd;
+    std::vector<T> expected_copy(v.size());
+    expected_copy.erase(std::copy_if(v.cbegin(), v.cend(), expected_copy.begin(), pred), expected_copy.end());
+    std::vector<T> expected_stable = v;
+    const auto expected_point = std::stable_partition(expected_stable.begin(), expected_stable.end(), pred) - expected_stable.begin();
+    std::vector<T> expected_removed = v;
+    expected_removed.erase(std::remove_if(expected_removed.begin(), expected_removed.end(), pred), expected_removed.end());
+
+    ForEachSimdLevel([&] {
+        // Exactly the room needed, so that writing past the output would be caught by sanitizers.
+        std::vector<T> copy(expected_copy.size());
+        EXPECT_EQ(simd::copy_if(v.cbegin(), v.cend(), copy.begin(), pred), copy.end());
+        EXPECT_TRUE(BitwiseEqual(copy, expected_copy));
+
+        std::vector<T> removed = v;
+        removed.erase(simd::remove_if(removed.begin(), removed.end(), pred), removed.end());
+        EXPECT_TRUE(BitwiseEqual(removed, expected_removed));
+
+        std::vector<T> stable = v;
+        EXPECT_EQ(simd::stable_partition(stable.begin(), stable.end(), pred) - stable.begin(), expected_point);
+        EXPECT_TRUE(BitwiseEqual(stable, expected_stable));
+
+        std::vector<T> partitioned = v;
+        const auto point = simd::partition(partitioned.begin(), partitioned.end(), pred);
+        EXPECT_EQ(point - partitioned.begin(), expected_point);
+        EXPECT_TRUE(std::is_partitioned(partitioned.cbegin(), partitioned.cend(), pred));
+        EXPECT_EQ(simd::partition_point(stable.cbegin(), stable.cend(), pred) - stable.cbegin(), expected_point);
+    });
+}
+
+template<class T>
+void ExpectSimdCompactionMatchesStd() {
+    namespace simd = stl_examples::simd;
+    std::mt19937 gen(19);
+    for (const std::size_t size : {0, 1, 7, 16, 33, 200, 1001}) {
+        SCOPED_TRACE(size);
+        std::vector<T> v = RandomVector<T>(gen, size, 0, 7);
+        if (size > 1) v[size - 1] = std::numeric_limits<T>::max();
+        if (size > 2) v[size - 2] = std::numeric_limits<T>::lowest();
+        if constexpr (std::is_floating_point_v<T>) {
+            if (size > 4) v[size / 2] = std::numeric_limits<T>::quiet_NaN();
+            if (size > 5) v[size / 3] = -T{0};
+            ExpectSimdCompactionMatchesStd(v, simd::equal_to<T>{T{0}});
+        }
+        ExpectSimdCompactionMatchesStd(v, simd::equal_to<T>{static_cast<T>(5)});
+        ExpectSimdCompactionMatchesStd(v, simd::in_range<T>{static_cast<T>(2), std::numeric_limits<T>::max()});
+        ExpectSimdCompactionMatchesStd(v, simd::in_range<T>{std::numeric_limits<T>::lowest(), static_cast<T>(3)});
+        ExpectSimdCompactionMatchesStd(v, [](T x){ return x > static_cast<T>(4); });
+    }
+}
+
+TEST(remove_if, ExampleTwoSimdMatchesStd) {
+    // Every element type and SIMD level gives the same answers as the std algorithms.
+    ExpectSimdCompactionMatchesStd<char>();
+    ExpectSimdCompactionMatchesStd<std::int16_t>();
+    ExpectSimdCompactionMatchesStd<int>();
+    ExpectSimdCompactionMatchesStd<unsigned>();
+    ExpectSimdCompactionMatchesStd<std::int64_t>();
+    ExpectSimdCompactionMatchesStd<std::uint64_t>();
+    ExpectSimdCompactionMatchesStd<float>();
+    ExpectSimdCompactionMatchesStd<double>();
+}
+
 TEST(transform, ExampleOne) {
     std::string s("R1EM3OV3E N3UMBE3RS");
     const auto turnNumberIntoUnderline = [](unsigned char c)->unsigned char {
@@ -348,6 +917,43 @@ TEST(transform, ExampleOne) {
     EXPECT_EQ(s, "REMOVE NUMBERS");
 }
 
+TEST(transform, ExampleTwoParallel) {
+    // std::execution::par_unseq additionally allows each thread to vectorize,
+    // so the function must not take locks or allocate.
+    std::vector<int> v(100000);
+    std::iota(v.begin(), v.end(), 0);
+    std::transform(std::execution::par_unseq, v.cbegin(), v.cend(), v.begin(), [](int i){ return i * 2; });
+    EXPECT_EQ(v[0], 0);
+    EXPECT_EQ(v[99999], 199998);
+}
+
+TEST(transform, ExampleThreeParallelPipeline) {
+    // The same stages, run on chunks of the range on the TBB threads. The chunks
+    // are combined in order, so the result does not depend on the thread count.
+    namespace pipeline = stl_examples::pipeline;
+    std::vector<int> v(1000003);
+    std::mt19937 gen(16);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::generate(v.begin(), v.end(), [&]{ return dist(gen); });
+    const auto stages = std::views::filter([](int i){ return i % 3 == 0; }) | std::views::transform([](int i){ return static_cast<double>(i) * 0.5; });
+
+    const double expected_total = v | stages | pipeline::reduce(0.0);
+    const std::vector<double> expected = v | stages | pipeline::to_vector;
+    std::optional<double> first_total;
+    for (const int threads : {1, 2, 4}) {
+        SCOPED_TRACE(threads);
+        const stl_examples::parallel::ThreadLimit limit(threads);
+        const double total = pipeline::parallel_reduce(v, stages, 0.0);
+        EXPECT_NEAR(total, expected_total, 1e-6);
+        if (!first_total) first_total = total;
+        EXPECT_EQ(total, *first_total);
+        EXPECT_EQ(pipeline::parallel_to_vector(v, stages), expected);
+    }
+    const std::vector<int> empty;
+    EXPECT_EQ(pipeline::parallel_reduce(empty, stages, 1.5), 1.5);
+    EXPECT_TRUE(pipeline::parallel_to_vector(empty, stages).empty());
+}
+
 // Note: replace_copy() also exists.
 TEST(replace, ExampleOne) {
     std::vector<int> v{1,2,3,3,3,4,4,5,5};
@@ -446,6 +1052,74 @@ TEST(shuffle, ExampleOne) {
     // std::transform(v.begin(), v.end(), v.begin(), printElement);
 }
 
+TEST(shuffle, ExampleTwoFastGenerators) {
+    // The reference outputs of xoshiro256++ from the state {1, 2, 3, 4},
+    // and of the PCG32 demo program, seeded with (42, 54).
+    stl_examples::sampling::Xoshiro256pp xoshiro(std::array<std::uint64_t, 4>{1, 2, 3, 4});
+    for (const std::uint64_t expected : {41943041ull, 58720359ull, 3588806011781223ull, 3591011842654386ull}) {
+        EXPECT_EQ(xoshiro(), expected);
+    }
+    stl_examples::sampling::Pcg32 pcg(42, 54);
+    for (const std::uint32_t expected : {0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu}) {
+        EXPECT_EQ(pcg(), expected);
+    }
+
+    // The same seed and stream give the same sequence; another stream, another one.
+    stl_examples::sampling::Xoshiro256pp a(2024, 1);
+    stl_examples::sampling::Xoshiro256pp b(2024, 1);
+    stl_examples::sampling::Xoshiro256pp c(2024, 2);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a(), b());
+    EXPECT_NE(a(), c());
+
+    // They are standard generators, so std::shuffle takes them too.
+    std::vector<int> v(100);
+    std::iota(v.begin(), v.end(), 0);
+    std::vector<int> shuffled = v;
+    std::shuffle(shuffled.begin(), shuffled.end(), a);
+    EXPECT_TRUE(std::is_permutation(shuffled.begin(), shuffled.end(), v.begin()));
+    EXPECT_NE(shuffled, v);
+}
+
+TEST(shuffle, ExampleThreeParallel) {
+    // Large enough to be shuffled in blocks and merged.
+    const std::size_t n = 300'000;
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+
+    std::vector<int> expected = v;
+    stl_examples::sampling::shuffle(expected.begin(), expected.end(), 7);
+    for (const int threads : {1, 2, 4}) {
+        SCOPED_TRACE(threads);
+        const stl_examples::parallel::ThreadLimit limit(threads);
+        std::vector<int> shuffled = v;
+        stl_examples::sampling::shuffle(shuffled.begin(), shuffled.end(), 7);
+        // The order depends on the seed, not on the number of threads.
+        EXPECT_EQ(shuffled, expected);
+    }
+    std::vector<int> other = v;
+    stl_examples::sampling::shuffle<stl_examples::sampling::Pcg32>(other.begin(), other.end(), 8);
+    EXPECT_NE(other, expected);
+
+    std::vector<int> sorted = expected;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, v);
+    // The blocks were mixed: about half of the first half stays there.
+    const auto stayed = std::count_if(expected.begin(), expected.begin() + n / 2, [&](int x){ return x < static_cast<int>(n / 2); });
+    EXPECT_NEAR(static_cast<double>(stayed) / (n / 2), 0.5, 0.01);
+
+    // Each of the 6 orders of 3 elements is equally likely.
+    std::map<std::vector<int>, int> counts;
+    for (std::uint64_t seed = 0; seed < 60'000; ++seed) {
+        std::vector<int> small{0, 1, 2};
+        stl_examples::sampling::shuffle(small.begin(), small.end(), seed);
+        ++counts[small];
+    }
+    EXPECT_EQ(counts.size(), 6u);
+    for (const auto& [order, count] : counts) EXPECT_NEAR(count, 10'000, 500);
+}
+
 TEST(sample, ExampleOne) {
     std::string s = "0123456789";
     std::string destination;
@@ -461,6 +1135,82 @@ TEST(sample, ExampleOne) {
     // std::transform(destination.begin(), destination.end(), destination.begin(), printElement);
 }
 
+TEST(sample, ExampleTwoReservoir) {
+    // A stream of unknown length, read once.
+    std::istringstream stream("3 1 4 1 5 9 2 6 5 3 5 8 9 7 9 3 2 3 8 4 6 2 6 4 3 3 8 3 2 7 9 5");
+    std::vector<int> destination(5);
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    const auto end = stl_examples::sampling::reservoir_sample(std::istream_iterator<int>(stream), std::istream_iterator<int>(),
+                                                              destination.begin(), destination.size(), gen);
+    EXPECT_EQ(end, destination.end());
+    for (const int digit : destination) EXPECT_TRUE(digit >= 1 && digit <= 9);
+
+    // When the stream is shorter than the sample, all of it is taken, in order.
+    const std::vector<int> few{1, 2, 3};
+    std::vector<int> all(10);
+    const auto all_end = stl_examples::sampling::reservoir_sample(few.begin(), few.end(), all.begin(), all.size(), gen);
+    EXPECT_EQ(std::vector<int>(all.begin(), all_end), few);
+
+    // Every element is equally likely to be chosen, whether the skipped ones
+    // are jumped over (a vector) or stepped through (a forward_list).
+    std::vector<int> v(20);
+    std::iota(v.begin(), v.end(), 0);
+    const std::forward_list<int> list(v.begin(), v.end());
+    std::vector<int> from_vector(20);
+    std::vector<int> from_list(20);
+    std::vector<int> sample(5);
+    for (int trial = 0; trial < 20'000; ++trial) {
+        stl_examples::sampling::reservoir_sample(v.begin(), v.end(), sample.begin(), sample.size(), gen);
+        for (const int x : sample) ++from_vector[x];
+        stl_examples::sampling::reservoir_sample(list.begin(), list.end(), sample.begin(), sample.size(), gen);
+        for (const int x : sample) ++from_list[x];
+    }
+    for (int x = 0; x < 20; ++x) {
+        EXPECT_NEAR(from_vector[x], 5'000, 300);
+        EXPECT_NEAR(from_list[x], 5'000, 300);
+    }
+}
+
+TEST(sample, ExampleThreeWeighted) {
+    const std::string items = "abcdef";
+    const std::vector<double> weights{1, 0, 2, 3, 0, 4};
+    stl_examples::sampling::Xoshiro256pp gen(42);
+
+    // Elements of weight zero are never chosen, so at most 4 can be.
+    std::string destination(6, ' ');
+    const auto end = stl_examples::sampling::weighted_sample(items.begin(), items.end(), weights.begin(),
+                                                             destination.begin(), destination.size(), gen);
+    destination.erase(end, destination.end());
+    std::sort(destination.begin(), destination.end());
+    EXPECT_EQ(destination, "acdf");
+
+    // A single draw chooses each element in proportion to its weight.
+    std::map<char, int> counts;
+    char chosen = ' ';
+    for (int trial = 0; trial < 40'000; ++trial) {
+        stl_examples::sampling::weighted_sample(items.begin(), items.end(), weights.begin(), &chosen, 1, gen);
+        ++counts[chosen];
+    }
+    EXPECT_EQ(counts.count('b') + counts.count('e'), 0u);
+    EXPECT_NEAR(counts['a'], 4'000, 400);
+    EXPECT_NEAR(counts['c'], 8'000, 400);
+    EXPECT_NEAR(counts['d'], 12'000, 400);
+    EXPECT_NEAR(counts['f'], 16'000, 400);
+
+    // For draws with replacement, an AliasTable takes constant time per draw.
+    const stl_examples::sampling::AliasTable table(weights.begin(), weights.end());
+    std::vector<int> draws(weights.size());
+    for (int trial = 0; trial < 100'000; ++trial) ++draws[table(gen)];
+    EXPECT_EQ(draws[1] + draws[4], 0);
+    EXPECT_NEAR(draws[0], 10'000, 600);
+    EXPECT_NEAR(draws[2], 20'000, 600);
+    EXPECT_NEAR(draws[3], 30'000, 600);
+    EXPECT_NEAR(draws[5], 40'000, 600);
+
+    const std::vector<double> zeros(3, 0.0);
+    EXPECT_THROW(stl_examples::sampling::AliasTable(zeros.begin(), zeros.end()), std::invalid_argument);
+}
+
 // Note: unique_copy also exists.
 TEST(unique, ExampleOneSorted) {
     std::vector<int> v{1,1,1,2,2,2,3,3,3,4,4,5,5,5};
@@ -488,6 +1238,86 @@ TEST(unique, ExampleTwoUnsorted) {
     EXPECT_EQ(v, new_v);
 }
 
+// Compares simd::unique, adjacent_find, and unique_erase with the std algorithms
+// on 'v', at every SIMD level.
+template<class T>
+void ExpectSimdUniqueMatchesStd(const std::vector<T>& v) {
+    namespace simd = stl_examples::simd;
+    const auto expected_pair = std::adjacent_find(v.cbegin(), v.cend()) - v.cbegin();
+    std::vector<T> expected = v;
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    std::vector<std::size_t> expected_runs;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        if (i == 0 || !(v[i] == v[i - 1])) expected_runs.push_back(0);
+        ++expected_runs.back();
+    }
+
+    ForEachSimdLevel([&] {
+        EXPECT_EQ(simd::adjacent_find(v.cbegin(), v.cend()) - v.cbegin(), expected_pair);
+
+        std::vector<T> unique = v;
+        unique.erase(simd::unique(unique.begin(), unique.end()), unique.end());
+        EXPECT_TRUE(BitwiseEqual(unique, expected));
+
+        std::vector<T> erased = v;
+        EXPECT_EQ(simd::unique_erase(erased), expected_runs);
+        EXPECT_TRUE(BitwiseEqual(erased, expected));
+    });
+}
+
+template<class T>
+void ExpectSimdUniqueMatchesStd() {
+    std::mt19937 gen(20);
+    for (const std::size_t size : {0, 1, 2, 9, 17, 64, 65, 200, 1001}) {
+        SCOPED_TRACE(size);
+        // Long runs, short runs, and no runs at all.
+        for (const int max_value : {3, 100, 1'000'000}) {
+            std::vector<T> v = RandomVector<T>(gen, size, 0, max_value);
+            ExpectSimdUniqueMatchesStd(v);
+            std::sort(v.begin(), v.end());
+            if constexpr (std::is_floating_point_v<T>) {
+                if (size > 4) v[size / 2] = v[size / 2 + 1] = std::numeric_limits<T>::quiet_NaN();
+                if (size > 8) v[size / 4] = -T{0}, v[size / 4 + 1] = T{0};
+            }
+            ExpectSimdUniqueMatchesStd(v);
+        }
+    }
+}
+
+TEST(unique, ExampleThreeSimdMatchesStd) {
+    ExpectSimdUniqueMatchesStd<char>();
+    ExpectSimdUniqueMatchesStd<std::int16_t>();
+    ExpectSimdUniqueMatchesStd<int>();
+    ExpectSimdUniqueMatchesStd<unsigned>();
+    ExpectSimdUniqueMatchesStd<std::int64_t>();
+    ExpectSimdUniqueMatchesStd<std::uint64_t>();
+    ExpectSimdUniqueMatchesStd<float>();
+    ExpectSimdUniqueMatchesStd<double>();
+}
+
+TEST(unique, ExampleFourEraseWithRunLengths) {
+    // simd::unique_erase removes the duplicates in the same pass that counts them:
+    // on sorted IDs, each run length is the number of occurrences of the ID.
+    namespace simd = stl_examples::simd;
+    std::vector<std::uint64_t> ids{7,7,7,9,12,12,40};
+    EXPECT_EQ(simd::unique_erase(ids), (std::vector<std::size_t>{3,1,2,1}));
+    EXPECT_EQ(ids, (std::vector<std::uint64_t>{7,9,12,40}));
+
+    // Other containers take the same single pass, one element at a time.
+    std::list<std::string> words{"a", "a", "b", "a"};
+    EXPECT_EQ(simd::unique_erase(words), (std::vector<std::size_t>{2,1,1}));
+    EXPECT_EQ(words, (std::list<std::string>{"a", "b", "a"}));
+
+    // The overload that fills a vector of run lengths reuses its memory from one batch to the next.
+    std::vector<std::size_t> runs{100, 200, 300, 400, 500, 600};
+    std::vector<std::uint64_t> batch{1,1,2,3,3,3};
+    simd::unique_erase(batch, runs);
+    EXPECT_EQ(runs, (std::vector<std::size_t>{2,1,3}));
+    batch.clear();
+    simd::unique_erase(batch, runs);
+    EXPECT_TRUE(runs.empty());
+}
+
 // Partitioning operations.
 TEST(is_partitioned, ExampleOne) {
     const auto isLessThanZero = [](int i)->bool{ return i < 0; };
@@ -524,6 +1354,31 @@ TEST(stable_partition, ExampleOne) {
 
 }
 
+TEST(stable_partition, ExampleTwoParallel) {
+    // Large ranges are split into blocks on the TBB threads: each block counts its
+    // matches, and the counts before it tell it where to write. The result is the
+    // same for any number of threads.
+    namespace simd = stl_examples::simd;
+    std::vector<int> v(1000003);
+    std::mt19937 gen(20);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::generate(v.begin(), v.end(), [&]{ return dist(gen); });
+    const auto isLessThanZero = [](int i)->bool{ return i < 0; };
+    auto expected = v;
+    const auto expected_point = std::stable_partition(expected.begin(), expected.end(), isLessThanZero) - expected.begin();
+
+    for (const int threads : {1, 2, 4}) {
+        SCOPED_TRACE(threads);
+        const stl_examples::parallel::ThreadLimit limit(threads);
+        auto partitioned = v;
+        EXPECT_EQ(simd::stable_partition(partitioned.begin(), partitioned.end(), isLessThanZero) - partitioned.begin(), expected_point);
+        EXPECT_EQ(partitioned, expected);
+        partitioned = v;
+        EXPECT_EQ(simd::stable_partition(partitioned.begin(), partitioned.end(), simd::in_range<int>{-1000, -1}) - partitioned.begin(), expected_point);
+        EXPECT_EQ(partitioned, expected);
+    }
+}
+
 TEST(partition_point, ExampleOne) {
     const auto isLessThanZero = [](int i)->bool{ return i < 0; };
     std::vector<int> v{-1,1,-2,2,-3,3, -4};
@@ -546,6 +1401,23 @@ TEST(partition_point, ExampleOne) {
     EXPECT_EQ(negatives, expected_negatives);
 }
 
+TEST(partition_point, ExampleTwoBranchless) {
+    // simd::partition_point picks each half with a conditional move rather than
+    // a branch, which the processor would mispredict half the time.
+    namespace simd = stl_examples::simd;
+    const auto isLessThanZero = [](int i)->bool{ return i < 0; };
+    for (const int size : {0, 1, 2, 3, 8, 100, 1025}) {
+        for (int negatives = 0; negatives <= size; negatives += std::max(1, size / 7)) {
+            std::vector<int> v(size, 1);
+            std::fill(v.begin(), v.begin() + negatives, -1);
+            EXPECT_EQ(simd::partition_point(v.cbegin(), v.cend(), isLessThanZero) - v.cbegin(), negatives);
+        }
+    }
+    // Other iterators use std::partition_point.
+    const std::forward_list<int> list{-2, -1, 1, 2};
+    EXPECT_EQ(*simd::partition_point(list.cbegin(), list.cend(), isLessThanZero), 1);
+}
+
 // Sorting operations.
 TEST(is_sorted, ExampleOne) {
     const std::vector<int> v1{1,2,3,4,5};
@@ -571,6 +1443,112 @@ TEST(sort, ExampleTwoWithPredicate) {
     EXPECT_EQ(v, sorted_v);
 }
 
+TEST(sort, ExampleThreeParallel) {
+    std::vector<int> v(100000);
+    std::iota(v.rbegin(), v.rend(), 0);
+    std::sort(std::execution::par, v.begin(), v.end());
+    EXPECT_TRUE(std::is_sorted(v.cbegin(), v.cend()));
+}
+
+TEST(sort, ExampleFourMappedFile) {
+    // Sorts a file in place through a writable mapping, then searches it
+    // through a read-only one: no std::vector holds the data in between.
+    namespace fs = std::filesystem;
+    using stl_examples::MappedFile;
+    const fs::path path = fs::temp_directory_path() / ("stl_examples_mapped_" + std::to_string(std::random_device()()) + ".bin");
+    std::vector<int> v(100'000);
+    std::iota(v.rbegin(), v.rend(), 0);
+    {
+        auto file = MappedFile<int>::create(path, v.size());
+        std::copy(v.cbegin(), v.cend(), file.begin());
+    }
+    {
+        MappedFile<int> file(path, {.advice = stl_examples::Advice::random, .huge_pages = true});
+        static_assert(std::ranges::contiguous_range<MappedFile<int>>);
+        std::sort(file.begin(), file.end());
+    }
+
+    {
+        const MappedFile<const int> file(path, {.advice = stl_examples::Advice::sequential, .populate = true});
+        ASSERT_EQ(file.size(), v.size());
+        EXPECT_TRUE(std::is_sorted(file.begin(), file.end()));
+        EXPECT_EQ(std::find(file.begin(), file.end(), 4242) - file.begin(), 4242);
+        EXPECT_EQ(std::count_if(file.begin(), file.end(), [](int i){ return i % 10 == 0; }), 10'000);
+        file.advise(stl_examples::Advice::random);
+        EXPECT_EQ(*std::lower_bound(file.begin(), file.end(), 77'777), 77'777);
+    }
+
+    // The sorted order reached the file itself.
+    std::vector<int> on_disk(v.size());
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(on_disk.data()),
+                                               static_cast<std::streamsize>(on_disk.size() * sizeof(int)));
+    EXPECT_TRUE(std::is_sorted(on_disk.cbegin(), on_disk.cend()));
+
+    // An empty file maps to an empty range; a partial record is an error.
+    const auto empty = MappedFile<int>::create(path, 0);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+    std::ofstream(path, std::ios::binary).write("abc", 3);
+    EXPECT_THROW(MappedFile<const int>{path}, std::invalid_argument);
+    fs::remove(path);
+    EXPECT_THROW(MappedFile<const int>{path}, std::system_error);
+}
+
+TEST(radix_sort, ExampleOne) {
+    // radix_sort() orders integers and floats by their bits, one byte at a
+    // time, without comparing elements. See radix_sort.h.
+    std::vector<int> v{1,-3,2,4,-2147483648,4,5,2147483647};
+    stl_examples::radix_sort(v.begin(), v.end());
+
+    const std::vector<int> sorted_v{-2147483648,-3,1,2,4,4,5,2147483647};
+    EXPECT_EQ(v, sorted_v);
+}
+
+TEST(radix_sort, ExampleTwoDescendingFloats) {
+    std::vector<double> v{1.5, -3.25, 0.0, 1e300, -1e-300, 2.0};
+    stl_examples::radix_sort(v.begin(), v.end(), stl_examples::SortOrder::descending);
+
+    const std::vector<double> sorted_v{1e300, 2.0, 1.5, 0.0, -1e-300, -3.25};
+    EXPECT_EQ(v, sorted_v);
+}
+
+TEST(radix_sort, ExampleThreeWithKey) {
+    // Sorting by a key is stable: "b" and "d" keep their relative order.
+    std::vector<std::pair<std::int64_t, std::string>> v{{3, "a"}, {-1, "b"}, {7, "c"}, {-1, "d"}};
+    stl_examples::radix_sort(v.begin(), v.end(), [](const auto& p){ return p.first; });
+
+    const std::vector<std::pair<std::int64_t, std::string>> sorted_v{{-1, "b"}, {-1, "d"}, {3, "a"}, {7, "c"}};
+    EXPECT_EQ(v, sorted_v);
+}
+
+template<class T>
+void ExpectRadixSortMatchesStdSort() {
+    std::mt19937_64 gen(42);
+    for (const std::size_t size : {0, 1, 63, 64, 1000, 100000}) {
+        std::vector<T> v = RandomVector<T>(gen, size);
+        std::vector<T> ascending = v;
+        std::sort(ascending.begin(), ascending.end());
+        std::vector<T> descending = v;
+        std::sort(descending.begin(), descending.end(), std::greater<T>());
+
+        stl_examples::radix_sort(v.begin(), v.end());
+        EXPECT_EQ(v, ascending);
+        stl_examples::radix_sort(v.begin(), v.end(), stl_examples::SortOrder::descending);
+        EXPECT_EQ(v, descending);
+    }
+}
+
+TEST(radix_sort, ExampleFourMatchesStdSort) {
+    ExpectRadixSortMatchesStdSort<std::int8_t>();
+    ExpectRadixSortMatchesStdSort<std::uint16_t>();
+    ExpectRadixSortMatchesStdSort<int>();
+    ExpectRadixSortMatchesStdSort<unsigned>();
+    ExpectRadixSortMatchesStdSort<std::int64_t>();
+    ExpectRadixSortMatchesStdSort<std::uint64_t>();
+    ExpectRadixSortMatchesStdSort<float>();
+    ExpectRadixSortMatchesStdSort<double>();
+}
+
 TEST(is_sorted_until, ExampleOne) {
     std::vector<int> v{1, 2, 3, 4, 3, 5, 6};
     const auto iterator1 = std::is_sorted_until(v.cbegin(), v.cend());
@@ -593,6 +1571,74 @@ TEST(partial_sort, ExampleOne) {
     EXPECT_EQ(v, partial_sorted_v);
 }
 
+// Checks selection::top_k and TopK against std::partial_sort_copy, for every
+// k of interest and at every SIMD level. Equivalent elements may come in any
+// order, and either of them may be chosen, as with std.
+template<class T, class Compare>
+void ExpectTopKMatchesStd(const std::vector<T>& v, Compare comp) {
+    const auto equivalent = [&](const std::vector<T>& a, const std::vector<T>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [&](const T& x, const T& y){ return !comp(x, y) && !comp(y, x); });
+    };
+    for (const std::size_t k : {std::size_t{0}, std::size_t{1}, std::size_t{100}, v.size(), v.size() + 5}) {
+        SCOPED_TRACE(k);
+        std::vector<T> expected(k);
+        expected.erase(std::partial_sort_copy(v.begin(), v.end(), expected.begin(), expected.end(), comp), expected.end());
+        ForEachSimdLevel([&] {
+            std::vector<T> top(k);
+            top.erase(stl_examples::selection::top_k(v.begin(), v.end(), top.begin(), top.end(), comp), top.end());
+            EXPECT_TRUE(equivalent(top, expected));
+
+            // The same, from chunks of a stream.
+            stl_examples::selection::TopK<T, Compare> stream(k, comp);
+            for (std::size_t i = 0; i < v.size(); i += 1000) {
+                stream.push(v.begin() + i, v.begin() + std::min(v.size(), i + 1000));
+            }
+            EXPECT_TRUE(equivalent(stream.sorted(), expected));
+        });
+    }
+}
+
+TEST(partial_sort, ExampleTwoTopK) {
+    // The 3 smallest, as partial_sort puts them first, without changing the input.
+    const std::vector<int> v{1,8,3,2,8,9,4};
+    std::vector<int> smallest(3);
+    stl_examples::selection::top_k(v.begin(), v.end(), smallest.begin(), smallest.end());
+    EXPECT_EQ(smallest, (std::vector<int>{1,2,3}));
+
+    // The 3 largest of a stream, one element at a time.
+    stl_examples::selection::TopK<int, std::greater<>> largest(3);
+    std::istringstream stream("1 8 3 2 8 9 4");
+    std::for_each(std::istream_iterator<int>(stream), std::istream_iterator<int>(), [&](int x){ largest.push(x); });
+    EXPECT_EQ(largest.sorted(), (std::vector<int>{9,8,8}));
+    EXPECT_EQ(largest.threshold(), 8);
+
+    // In place, like std::partial_sort.
+    std::vector<int> w = v;
+    stl_examples::selection::partial_sort(w.begin(), w.begin() + 3, w.end());
+    EXPECT_EQ(std::vector<int>(w.begin(), w.begin() + 3), (std::vector<int>{1,2,3}));
+
+    // Larger inputs, with the SIMD prefilter for arithmetic types, and without
+    // it for other comparisons.
+    std::mt19937_64 gen(11);
+    std::vector<std::int64_t> numbers(30'011);
+    for (auto& x : numbers) x = static_cast<std::int64_t>(gen() % 1'000'000) - 500'000;
+    ExpectTopKMatchesStd(numbers, std::less<>());
+    ExpectTopKMatchesStd(numbers, std::greater<std::int64_t>());
+    ExpectTopKMatchesStd(numbers, [](std::int64_t a, std::int64_t b){ return std::abs(a) < std::abs(b); });
+
+    std::vector<std::uint32_t> unsigned_numbers(numbers.size());
+    std::transform(numbers.begin(), numbers.end(), unsigned_numbers.begin(), [](std::int64_t x){ return static_cast<std::uint32_t>(x); });
+    ExpectTopKMatchesStd(unsigned_numbers, std::less<>());
+    ExpectTopKMatchesStd(unsigned_numbers, std::greater<>());
+
+    std::vector<double> scores(numbers.size());
+    std::transform(numbers.begin(), numbers.end(), scores.begin(), [](std::int64_t x){ return x / 7.0; });
+    ExpectTopKMatchesStd(scores, std::greater<>());
+    std::vector<float> few_scores(numbers.size());
+    std::transform(numbers.begin(), numbers.end(), few_scores.begin(), [](std::int64_t x){ return static_cast<float>(x % 16); });
+    ExpectTopKMatchesStd(few_scores, std::less<>());
+}
+
 // A simple struct encapsulating the the name
 // and age of a person. This will be used in stable_sort.
 struct Person {
@@ -631,6 +1677,123 @@ TEST(stable_sort, ExampleOne) {
     EXPECT_EQ(v, sorted_v);
 }
 
+TEST(stable_sort, ExampleTwoByKey) {
+    // The same sort, but each Person is moved once: their ages are sorted
+    // with their positions, then the people are moved to their places.
+    std::vector<Person> v = {
+            {108, "Zaphod"},
+            {32, "Arthur"},
+            {108, "Ford"},
+    };
+    stl_examples::stable_sort_by_key(v.begin(), v.end(), &Person::age);
+
+    const std::vector<Person> sorted_v = {
+            {32, "Arthur"},
+            {108, "Zaphod"},
+            {108, "Ford"},
+    };
+    EXPECT_EQ(v, sorted_v);
+
+    // Any key and comparison: here by name, in descending order.
+    stl_examples::stable_sort_by_key(v.begin(), v.end(), [](const Person& p){ return p.name; }, std::greater<>());
+    const std::vector<Person> by_name = {
+            {108, "Zaphod"},
+            {108, "Ford"},
+            {32, "Arthur"},
+    };
+    EXPECT_EQ(v, by_name);
+
+    // Large enough to be permuted in blocks, with many equal keys to check stability.
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> age(-50, 99);
+    for (const std::size_t n : {0, 1, 1000, 300'007}) {
+        SCOPED_TRACE(n);
+        std::vector<Person> people(n);
+        for (std::size_t i = 0; i < n; ++i) people[i] = {age(gen), std::to_string(i)};
+
+        auto expected = people;
+        std::stable_sort(expected.begin(), expected.end());
+        auto sorted = people;
+        stl_examples::stable_sort_by_key(sorted.begin(), sorted.end(), &Person::age);
+        EXPECT_EQ(sorted, expected);
+
+        expected = people;
+        std::stable_sort(expected.begin(), expected.end(), [](const Person& a, const Person& b){ return a.age > b.age; });
+        sorted = people;
+        stl_examples::stable_sort_by_key(sorted.begin(), sorted.end(), [](const Person& p){ return p.age * 0.5; }, std::greater<>());
+        EXPECT_EQ(sorted, expected);
+    }
+}
+
+TEST(stable_sort, ExampleThreeInstrumented) {
+    // What std::sort and std::stable_sort do to the same people. The counts are
+    // only made when built with -DSTL_EXAMPLES_INSTRUMENT=ON; see instrumentation.h.
+    namespace instrument = stl_examples::instrument;
+    using instrument::Event;
+    std::mt19937 gen(18);
+    std::uniform_int_distribution<int> age(0, 99);
+    std::vector<instrument::Counted<Person>> people;
+    for (int i = 0; i < 1000; ++i) people.emplace_back(Person{age(gen), std::to_string(i)});
+    auto sorted = people;
+    auto stable = people;
+
+    const instrument::Counts start = instrument::snapshot();
+    std::sort(sorted.begin(), sorted.end());
+    const instrument::Counts middle = instrument::snapshot();
+    std::stable_sort(stable.begin(), stable.end());
+    const instrument::Counts sort_counts = middle - start;
+    const instrument::Counts stable_sort_counts = instrument::snapshot() - middle;
+    EXPECT_TRUE(std::is_sorted(sorted.cbegin(), sorted.cend()));
+    EXPECT_TRUE(std::is_sorted(stable.cbegin(), stable.cend()));
+
+    if constexpr (instrument::enabled) {
+        // Both make on the order of n log2(n), about 10'000 comparisons.
+        EXPECT_GT(sort_counts[Event::comparisons], 1000);
+        EXPECT_LT(sort_counts[Event::comparisons], 30000);
+        EXPECT_GT(stable_sort_counts[Event::comparisons], 1000);
+        EXPECT_LT(stable_sort_counts[Event::comparisons], 30000);
+        // Neither copies a person; std::sort swaps them in place, while
+        // std::stable_sort moves them through a buffer it allocates.
+        EXPECT_EQ(sort_counts[Event::copies], 0);
+        EXPECT_EQ(stable_sort_counts[Event::copies], 0);
+        EXPECT_GT(sort_counts[Event::swaps], 0);
+        EXPECT_EQ(sort_counts[Event::allocations], 0);
+        EXPECT_GT(stable_sort_counts[Event::moves], 0);
+        EXPECT_EQ(stable_sort_counts[Event::allocations], 1);
+    } else {
+        EXPECT_EQ(sort_counts, instrument::Counts());
+        EXPECT_EQ(stable_sort_counts, instrument::Counts());
+    }
+}
+
+TEST(stable_sort, ExampleFourByKeyEdgeCases) {
+    // -0.0 and 0.0 are equal keys under std::less, so they keep their order.
+    std::vector<std::pair<double, int>> zeros{{0.0, 1}, {-0.0, 2}, {0.0, 3}, {-1.0, 4}};
+    auto expected = zeros;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
+    stl_examples::stable_sort_by_key(zeros.begin(), zeros.end(), [](const auto& p){ return p.first; });
+    EXPECT_EQ(zeros, expected);
+    stl_examples::stable_sort_by_key(zeros.begin(), zeros.end(), [](const auto& p){ return p.first; }, std::greater<>());
+    std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b){ return a.first > b.first; });
+    EXPECT_EQ(zeros, expected);
+
+    // Records larger than a permutation block are moved one by one.
+    struct Blob {
+        int key;
+        std::array<char, (std::size_t{1} << 21) + 64> payload;
+    };
+    std::vector<Blob> blobs(3);
+    for (int i = 0; i < 3; ++i) {
+        blobs[i].key = 2 - i;
+        blobs[i].payload.fill(static_cast<char>('a' + i));
+    }
+    stl_examples::stable_sort_by_key(blobs.begin(), blobs.end(), &Blob::key);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(blobs[i].key, i);
+        EXPECT_EQ(blobs[i].payload.back(), static_cast<char>('c' - i));
+    }
+}
+
 TEST(nth_element, ExampleOne) {
     // Similar to partial_sort(), it'll get the first 5 elements
     // according to the provided comparator. The only difference
@@ -642,6 +1805,42 @@ TEST(nth_element, ExampleOne) {
     EXPECT_EQ(v, greatest_five);
 }
 
+TEST(nth_element, ExampleTwoFloydRivest) {
+    // The same selection, with Floyd–Rivest's sampling. Which elements go on
+    // either side is specified, but not their order: only that is checked.
+    std::vector<int> v{1, 3, 9, 9, 3, 2, 5, 8, 7, 3, 2};
+    stl_examples::selection::nth_element(v.begin(), v.begin() + 5, v.end(), std::greater<int>());
+    EXPECT_EQ(v[5], 3);
+    EXPECT_TRUE(std::all_of(v.begin(), v.begin() + 5, [](int x){ return x >= 3; }));
+    EXPECT_TRUE(std::all_of(v.begin() + 6, v.end(), [](int x){ return x <= 3; }));
+
+    std::mt19937 gen(5);
+    for (const std::size_t n : {1, 2, 601, 100'000}) {
+        std::vector<int> random(n);
+        for (auto& x : random) x = static_cast<int>(gen());
+        std::vector<int> few_unique(n);
+        for (auto& x : few_unique) x = static_cast<int>(gen() % 16);
+        std::vector<int> ascending(n);
+        std::iota(ascending.begin(), ascending.end(), 0);
+        std::vector<int> descending(ascending.rbegin(), ascending.rend());
+
+        for (const std::vector<int>* input : {&random, &few_unique, &ascending, &descending}) {
+            std::vector<int> sorted = *input;
+            std::sort(sorted.begin(), sorted.end());
+            for (const std::size_t k : {std::size_t{0}, n / 100, n / 2, n - 1}) {
+                SCOPED_TRACE(testing::Message() << "n = " << n << ", k = " << k);
+                std::vector<int> w = *input;
+                stl_examples::selection::nth_element(w.begin(), w.begin() + k, w.end());
+                EXPECT_EQ(w[k], sorted[k]);
+                EXPECT_TRUE(std::all_of(w.begin(), w.begin() + k, [&](int x){ return x <= w[k]; }));
+                EXPECT_TRUE(std::all_of(w.begin() + k, w.end(), [&](int x){ return x >= w[k]; }));
+                std::sort(w.begin(), w.end());
+                EXPECT_EQ(w, sorted);
+            }
+        }
+    }
+}
+
 // Binary search operations (on sorted ranges).
 TEST(lower_bound, ExampleOne) {
     const std::vector<int> data{1,2,3,4,5,6,7,8,9,9,10};
@@ -679,6 +1878,51 @@ TEST(equal_range, ExampleOne) {
     EXPECT_EQ(upper - data.cbegin(), 9);
 }
 
+TEST(equal_range, ExampleTwoEytzinger) {
+    // The same queries on a cache-friendly copy of the data, see eytzinger_index.h.
+    const std::vector<int> data{1,2,3,3,4,4,5,5,5,6,7,8};
+    const stl_examples::EytzingerIndex index(data.cbegin(), data.cend());
+
+    const auto [lower, upper] = index.equal_range(5);
+    EXPECT_EQ(lower, 6);
+    EXPECT_EQ(upper, 9);
+    EXPECT_EQ(index.lower_bound(4), 4);
+    EXPECT_EQ(index.upper_bound(8), data.size());
+    EXPECT_TRUE(index.binary_search(3));
+    EXPECT_FALSE(index.binary_search(11));
+    EXPECT_EQ(index.find(7), 10);
+    EXPECT_EQ(index.find(0), data.size());
+}
+
+TEST(equal_range, ExampleThreeEytzingerMatchesStd) {
+    // Every size up to a few complete trees, with duplicates, and keys
+    // below, between and above the elements.
+    std::mt19937 gen(3);
+    for (std::size_t n = 0; n <= 300; ++n) {
+        std::vector<int> data(n);
+        std::uniform_int_distribution<int> value(0, static_cast<int>(n));
+        for (int& x : data) x = 2 * value(gen);
+        std::sort(data.begin(), data.end());
+        const stl_examples::EytzingerIndex index(data.cbegin(), data.cend());
+
+        for (int key = -1; key <= 2 * static_cast<int>(n) + 1; ++key) {
+            SCOPED_TRACE("n = " + std::to_string(n) + ", key = " + std::to_string(key));
+            const auto [lower, upper] = std::equal_range(data.cbegin(), data.cend(), key);
+            EXPECT_EQ(index.lower_bound(key), static_cast<std::size_t>(lower - data.cbegin()));
+            EXPECT_EQ(index.upper_bound(key), static_cast<std::size_t>(upper - data.cbegin()));
+            EXPECT_EQ(index.binary_search(key), std::binary_search(data.cbegin(), data.cend(), key));
+            EXPECT_EQ(index.find(key), lower != upper ? index.lower_bound(key) : n);
+        }
+    }
+
+    // A descending range, with the matching comparator.
+    const std::vector<double> descending{9.5, 7.0, 7.0, 3.25, -1.0};
+    const stl_examples::EytzingerIndex index(descending.cbegin(), descending.cend(), std::greater<>());
+    EXPECT_EQ(index.lower_bound(7.0), 1);
+    EXPECT_EQ(index.upper_bound(7.0), 3);
+    EXPECT_EQ(index.lower_bound(-5.0), 5);
+}
+
 // Other operations (on sorted ranges).
 TEST(merge, ExampleOne) {
     std::vector<int> v1{0, 1, 2, 3, 3, 4, 5};
@@ -691,6 +1935,100 @@ TEST(merge, ExampleOne) {
     EXPECT_EQ(destination, merged);
 }
 
+// A fixed-width record, as stored in the files sorted by external_sort.
+struct FileRecord {
+    std::uint32_t key;
+    std::uint32_t sequence;
+    char payload[24];
+};
+
+TEST(merge, ExampleTwoExternalSort) {
+    // Sorts a file through a memory budget of a few kilobytes: the records are
+    // sorted in chunks, spilled to temporary files, and the files merged k ways.
+    namespace fs = std::filesystem;
+    const fs::path directory = fs::temp_directory_path() / ("stl_examples_external_sort_" + std::to_string(std::random_device()()));
+    fs::create_directories(directory);
+    const auto by_key = [](const FileRecord& a, const FileRecord& b){ return a.key < b.key; };
+    const auto write_file = [](const fs::path& path, const std::vector<FileRecord>& records) {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(records.data()),
+                                                    static_cast<std::streamsize>(records.size() * sizeof(FileRecord)));
+    };
+    const auto read_file = [](const fs::path& path) {
+        std::vector<FileRecord> records(fs::file_size(path) / sizeof(FileRecord));
+        std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(records.data()),
+                                                   static_cast<std::streamsize>(records.size() * sizeof(FileRecord)));
+        return records;
+    };
+    const auto keys_and_sequences = [](const std::vector<FileRecord>& records) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        for (const FileRecord& r : records) pairs.emplace_back(r.key, r.sequence);
+        return pairs;
+    };
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<std::uint32_t> key(0, 999);
+    for (const std::size_t n : {0, 1, 5000, 100'003}) {
+        std::vector<FileRecord> records(n);
+        for (std::size_t i = 0; i < n; ++i) records[i] = {key(gen), static_cast<std::uint32_t>(i), "payload"};
+        write_file(directory / "input.bin", records);
+        // Equal keys keep their order, as with std::stable_sort.
+        std::stable_sort(records.begin(), records.end(), by_key);
+
+        // One chunk; runs merged at once; and runs merged in several passes.
+        for (const std::size_t budget : {std::size_t{16} << 20, std::size_t{256} << 10, std::size_t{16} << 10}) {
+            SCOPED_TRACE("n = " + std::to_string(n) + ", budget = " + std::to_string(budget));
+            const stl_examples::ExternalSortOptions options{.memory_budget = budget, .temp_directory = directory,
+                                                            .min_io_size = 1024};
+            const auto stats = stl_examples::external_sort<FileRecord>(directory / "input.bin", directory / "output.bin",
+                                                                       options, by_key);
+            EXPECT_EQ(keys_and_sequences(read_file(directory / "output.bin")), keys_and_sequences(records));
+            EXPECT_EQ(stats.records, n);
+            EXPECT_EQ(stats.bytes, n * sizeof(FileRecord));
+            EXPECT_EQ(stats.runs > 1, n * sizeof(FileRecord) > budget / 3);
+            EXPECT_EQ(stats.runs == 0, n == 0);
+            EXPECT_GE(stats.megabytes_per_second(), 0);
+            // Only the input and the output are left: the runs were removed.
+            EXPECT_EQ(std::distance(fs::directory_iterator(directory), fs::directory_iterator()), 2);
+        }
+    }
+
+    // A file that is not a whole number of records.
+    std::ofstream(directory / "input.bin", std::ios::binary).write("abc", 3);
+    EXPECT_THROW(stl_examples::external_sort<FileRecord>(directory / "input.bin", directory / "output.bin", {}, by_key),
+                 std::invalid_argument);
+    fs::remove_all(directory);
+}
+
+TEST(merge, ExampleThreeArena) {
+    // The outputs of merge, set_union and partial_sum, each allocated once
+    // from a monotonic arena, and handed back all at once by release().
+    namespace arena = stl_examples::arena;
+    const std::vector<int> v1{0, 1, 2, 3, 3, 4, 5};
+    const std::vector<int> v2{0, 2, 3, 4, 4, 5};
+    arena::CountingResource counting;
+    std::pmr::monotonic_buffer_resource request(&counting);
+
+    const std::pmr::vector<int> merged = arena::merge(&request, v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend());
+    EXPECT_EQ(merged, (std::pmr::vector<int>{0,0,1,2,2,3,3,3,4,4,4,5,5}));
+    const std::pmr::vector<int> union_t = arena::set_union(&request, v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend());
+    EXPECT_EQ(union_t, (std::pmr::vector<int>{0,1,2,3,3,4,4,5}));
+    const std::pmr::vector<int> sums = arena::partial_sum(&request, v1.cbegin(), v1.cend());
+    EXPECT_EQ(sums, (std::pmr::vector<int>{0,1,3,6,9,13,18}));
+    const std::pmr::vector<int> descending = arena::merge(&request, v1.crbegin(), v1.crend(), v2.crbegin(), v2.crend(), std::greater<>());
+    EXPECT_TRUE(std::is_sorted(descending.cbegin(), descending.cend(), std::greater<>()));
+
+    // The arena took one block from upstream for all of them.
+    EXPECT_EQ(counting.allocations(), 1);
+    EXPECT_GT(counting.bytes_in_use(), 0);
+    request.release();
+    EXPECT_EQ(counting.bytes_in_use(), 0);
+
+    // Input iterators cannot be measured ahead, so their output grows as usual.
+    std::istringstream numbers("1 2 3 4");
+    const std::pmr::vector<int> read = arena::partial_sum(&request, std::istream_iterator<int>(numbers), std::istream_iterator<int>());
+    EXPECT_EQ(read, (std::pmr::vector<int>{1,3,6,10}));
+}
+
 // Taken from cppreference.com, we can use std::merge_sort and
 // std::inplace_merge to implement the sorting algorithm merge_sort.
 template<class Iter>
@@ -713,6 +2051,73 @@ TEST(inplace_merge, ExampleOne) {
     EXPECT_EQ(v, v_sorted);
 }
 
+TEST(inplace_merge, ExampleTwoParallelMergeSort) {
+    // The same sort, with the halves sorted on TBB threads and a single
+    // scratch buffer instead of one allocation per std::inplace_merge.
+    std::vector<int> v{9, 3, -4, 4, 8, 9, 2, 2};
+    stl_examples::parallel_merge_sort(v.begin(), v.end());
+
+    const std::vector<int> v_sorted{-4, 2, 2, 3, 4, 8, 9, 9};
+    EXPECT_EQ(v, v_sorted);
+
+    // Like std::stable_sort, people of the same age keep their order.
+    std::vector<Person> people = {
+            {108, "Zaphod"},
+            {32, "Arthur"},
+            {108, "Ford"},
+    };
+    stl_examples::parallel_merge_sort(people.begin(), people.end());
+
+    const std::vector<Person> sorted_people = {
+            {32, "Arthur"},
+            {108, "Zaphod"},
+            {108, "Ford"},
+    };
+    EXPECT_EQ(people, sorted_people);
+}
+
+TEST(inplace_merge, ExampleThreeParallelMatchesStableSort) {
+    // Large enough for the parallel merges, with many equal keys to check stability.
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> age(0, 99);
+    for (const std::size_t n : {0, 1, 33, 1000, 100003}) {
+        std::vector<Person> people(n);
+        for (std::size_t i = 0; i < n; ++i) people[i] = {age(gen), std::to_string(i)};
+        auto expected = people;
+        std::stable_sort(expected.begin(), expected.end());
+
+        for (const std::size_t threads : {1, 4}) {
+            const stl_examples::parallel::ThreadLimit limit(threads);
+            auto sorted = people;
+            stl_examples::parallel_merge_sort(sorted.begin(), sorted.end());
+            EXPECT_EQ(sorted, expected) << "n = " << n << ", threads = " << threads;
+        }
+    }
+}
+
+TEST(inplace_merge, ExampleFourInstrumented) {
+    // std::inplace_merge moves one half into a buffer, if it can allocate one,
+    // then merges back with at most n - 1 comparisons.
+    namespace instrument = stl_examples::instrument;
+    using instrument::Event;
+    std::vector<instrument::Counted<int>> v;
+    for (int i = 0; i < 1000; ++i) v.emplace_back(i < 500 ? 2 * i : 2 * (i - 500) + 1);
+
+    const instrument::Counts start = instrument::snapshot();
+    std::inplace_merge(v.begin(), v.begin() + 500, v.end());
+    const instrument::Counts counts = instrument::snapshot() - start;
+    EXPECT_TRUE(std::is_sorted(v.cbegin(), v.cend()));
+
+    if constexpr (instrument::enabled) {
+        EXPECT_EQ(counts[Event::allocations], 1);
+        EXPECT_LE(counts[Event::comparisons], 999);
+        EXPECT_EQ(counts[Event::copies], 0);
+        EXPECT_GE(counts[Event::moves], 1000);
+    } else {
+        EXPECT_EQ(counts, instrument::Counts());
+    }
+}
+
 // Set operations (on sorted ranges).
 TEST(includes, ExampleOne) {
     // std::includes returns true if the first sorted range
@@ -755,6 +2160,21 @@ TEST(set_intersection, ExampleOne) {
     EXPECT_EQ(intersection, expected_intersection);
 }
 
+TEST(set_intersection, ExampleTwoGalloping) {
+    // Intersects a short posting list with a much longer one: the adaptive
+    // version skips through the long list by exponential search.
+    std::vector<unsigned> documents(100'000);
+    std::iota(documents.begin(), documents.end(), 0u);
+    const std::vector<unsigned> rare_term{17, 4'096, 50'000, 99'999, 100'000};
+    std::vector<unsigned> intersection;
+
+    stl_examples::adaptive::set_intersection(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(),
+                                             std::back_inserter(intersection));
+
+    const std::vector<unsigned> expected_intersection{17, 4'096, 50'000, 99'999};
+    EXPECT_EQ(intersection, expected_intersection);
+}
+
 TEST(set_symmetric_difference, ExampleOne) {
     // Takes the symmetric difference between two sorted ranges.
     const std::vector<int> v1{1,2,3,4,5,6};
@@ -792,6 +2212,135 @@ TEST(set_union, ExampleTwoWithDuplicates) {
     EXPECT_EQ(union_t, expected_union);
 }
 
+TEST(set_union, ExampleThreeParallel) {
+    // The output must be a forward iterator (not std::back_inserter),
+    // so the destination is sized up front and trimmed afterwards.
+    const std::vector<int> v1{1,1,2,3,4,5,6};
+    const std::vector<int> v2{1,1,1,4,5,6,7,8,9};
+    std::vector<int> union_t(v1.size() + v2.size());
+
+    const auto last = std::set_union(std::execution::par, v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(),
+                                     union_t.begin());
+    union_t.erase(last, union_t.end());
+
+    const std::vector<int> expected_union{1,1,1,2,3,4,5,6,7,8,9};
+    EXPECT_EQ(union_t, expected_union);
+}
+
+// Runs every adaptive set operation on a and b (sorted by comp) and compares
+// the output, element for element, with the std algorithm.
+template<class T, class Compare = std::less<>>
+void ExpectSetOperationsMatchStd(const std::vector<T>& a, const std::vector<T>& b, Compare comp = {}) {
+    namespace adaptive = stl_examples::adaptive;
+    for (int swap = 0; swap < 2; ++swap) {
+        const std::vector<T>& first = swap ? b : a;
+        const std::vector<T>& second = swap ? a : b;
+        SCOPED_TRACE("sizes " + std::to_string(first.size()) + " and " + std::to_string(second.size()));
+        std::vector<T> expected, result;
+
+        std::set_intersection(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(expected), comp);
+        adaptive::set_intersection(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result), comp);
+        EXPECT_EQ(result, expected);
+
+        expected.clear();
+        result.clear();
+        std::set_union(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(expected), comp);
+        adaptive::set_union(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result), comp);
+        EXPECT_EQ(result, expected);
+
+        expected.clear();
+        result.clear();
+        std::set_difference(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(expected), comp);
+        adaptive::set_difference(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result), comp);
+        EXPECT_EQ(result, expected);
+
+        expected.clear();
+        result.clear();
+        std::set_symmetric_difference(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(expected), comp);
+        adaptive::set_symmetric_difference(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result), comp);
+        EXPECT_EQ(result, expected);
+
+        EXPECT_EQ(adaptive::includes(first.cbegin(), first.cend(), second.cbegin(), second.cend(), comp),
+                  std::includes(first.cbegin(), first.cend(), second.cbegin(), second.cend(), comp));
+    }
+}
+
+TEST(set_union, ExampleFourAdaptiveMatchesStd) {
+    namespace adaptive = stl_examples::adaptive;
+
+    // The duplicates of ExampleTwoWithDuplicates, in ranges skewed enough to gallop.
+    std::vector<int> v1{1,1,2,3,4,5,6};
+    std::vector<int> v2(1000, 0);
+    v2.insert(v2.end(), {1,1,1,4,5,6,7,8,9});
+    std::vector<int> union_t;
+    adaptive::set_union(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), std::back_inserter(union_t));
+    std::vector<int> expected_union(1000, 0);
+    expected_union.insert(expected_union.end(), {1,1,1,2,3,4,5,6,7,8,9});
+    EXPECT_EQ(union_t, expected_union);
+
+    // Sizes from equal to 1000 times apart, with few or many duplicates, through
+    // every SIMD level (the block intersection handles 32-bit integers).
+    std::mt19937 gen(9);
+    ForEachSimdLevel([&] {
+        for (const int max_value : {50, 1'000'000}) {
+            for (const auto& [n1, n2] : {std::pair{0, 100}, {1, 1000}, {10, 10'000}, {77, 100}, {1000, 1000}, {5000, 4000}}) {
+                SCOPED_TRACE("max value = " + std::to_string(max_value));
+                const auto sorted_values = [&](int n) {
+                    std::vector<int> v = RandomVector<int>(gen, n, 0, max_value);
+                    std::sort(v.begin(), v.end());
+                    return v;
+                };
+                const std::vector<int> a = sorted_values(n1);
+                const std::vector<int> b = sorted_values(n2);
+                ExpectSetOperationsMatchStd(a, b);
+                ExpectSetOperationsMatchStd(std::vector<unsigned>(a.cbegin(), a.cend()), std::vector<unsigned>(b.cbegin(), b.cend()));
+                ExpectSetOperationsMatchStd(std::vector<std::int64_t>(a.cbegin(), a.cend()), std::vector<std::int64_t>(b.cbegin(), b.cend()));
+            }
+        }
+    });
+
+    // Equivalent elements that differ: the same copies must be kept as by std.
+    std::vector<std::pair<int, int>> tagged1, tagged2;
+    for (int i = 0; i < 2000; ++i) tagged1.emplace_back(i / 7, i);
+    for (int i = 0; i < 40; ++i) tagged2.emplace_back(i * 5 / 3, -i);
+    ExpectSetOperationsMatchStd(tagged1, tagged2, [](const auto& x, const auto& y){ return x.first < y.first; });
+}
+
+TEST(set_union, ExampleFiveAdaptiveNodeContainers) {
+    // Iterators of std::set and std::list cannot gallop: the std algorithm is used,
+    // even for sizes skewed enough to gallop.
+    namespace adaptive = stl_examples::adaptive;
+    std::set<int> rare_term{3, 500, 999};
+    std::list<int> documents(1000);
+    std::iota(documents.begin(), documents.end(), 0);
+    std::vector<int> expected, result;
+
+    std::set_intersection(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(expected));
+    adaptive::set_intersection(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(result));
+    EXPECT_EQ(result, expected);
+
+    expected.clear();
+    result.clear();
+    std::set_union(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(expected));
+    adaptive::set_union(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(result));
+    EXPECT_EQ(result, expected);
+
+    expected.clear();
+    result.clear();
+    std::set_difference(documents.cbegin(), documents.cend(), rare_term.cbegin(), rare_term.cend(), std::back_inserter(expected));
+    adaptive::set_difference(documents.cbegin(), documents.cend(), rare_term.cbegin(), rare_term.cend(), std::back_inserter(result));
+    EXPECT_EQ(result, expected);
+
+    expected.clear();
+    result.clear();
+    std::set_symmetric_difference(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(expected));
+    adaptive::set_symmetric_difference(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend(), std::back_inserter(result));
+    EXPECT_EQ(result, expected);
+
+    EXPECT_TRUE(adaptive::includes(documents.cbegin(), documents.cend(), rare_term.cbegin(), rare_term.cend()));
+    EXPECT_FALSE(adaptive::includes(rare_term.cbegin(), rare_term.cend(), documents.cbegin(), documents.cend()));
+}
+
 // Heap operations.
 TEST(is_heap, ExampleOne) {
     // Checks if the elements in the range are a max heap.
@@ -857,6 +2406,157 @@ TEST(sort_heap, ExampleOne) {
     EXPECT_EQ(v, sorted_v);
 }
 
+TEST(make_heap, ExampleTwoDaryHeap) {
+    // A 4-ary max heap: the children of v[i] are v[4i+1] to v[4i+4].
+    // See dary_heap.h.
+    namespace dary = stl_examples::dary;
+    std::vector<int> v{1,2,3,4,5,6,5,4};
+    dary::make_heap<4>(v.begin(), v.end());
+
+    const std::vector<int> expected_heap{6,5,3,4,5,2,1,4};
+    EXPECT_EQ(v, expected_heap);
+    EXPECT_TRUE(dary::is_heap<4>(v.cbegin(), v.cend()));
+
+    v.push_back(9);
+    dary::push_heap<4>(v.begin(), v.end());
+    EXPECT_EQ(v.front(), 9);
+
+    dary::pop_heap<4>(v.begin(), v.end());
+    EXPECT_EQ(v.back(), 9);
+    v.pop_back();
+
+    dary::sort_heap<4>(v.begin(), v.end());
+    const std::vector<int> sorted_v{1,2,3,4,4,5,5,6};
+    EXPECT_EQ(v, sorted_v);
+}
+
+template<std::size_t D>
+void ExpectDaryHeapMatchesStd() {
+    namespace dary = stl_examples::dary;
+    std::mt19937 gen(11);
+    for (const std::size_t n : {0, 1, 2, 9, 100, 1001}) {
+        SCOPED_TRACE("D = " + std::to_string(D) + ", n = " + std::to_string(n));
+        const std::vector<int> v = RandomVector<int>(gen, n, 0, 50);
+
+        // Built all at once, and one push at a time.
+        std::vector<int> heap = v;
+        dary::make_heap<D>(heap.begin(), heap.end(), std::greater<>());
+        EXPECT_TRUE(dary::is_heap<D>(heap.cbegin(), heap.cend(), std::greater<>()));
+        std::vector<int> pushed;
+        for (const int x : v) {
+            pushed.push_back(x);
+            dary::push_heap<D>(pushed.begin(), pushed.end(), std::greater<>());
+            ASSERT_TRUE(dary::is_heap<D>(pushed.cbegin(), pushed.cend(), std::greater<>()));
+        }
+
+        // Popping yields the elements in order, like sort_heap.
+        std::vector<int> expected = v;
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        dary::sort_heap<D>(heap.begin(), heap.end(), std::greater<>());
+        EXPECT_EQ(heap, expected);
+        std::vector<int> popped;
+        for (auto last = pushed.end(); last != pushed.begin(); --last) {
+            dary::pop_heap<D>(pushed.begin(), last, std::greater<>());
+            popped.push_back(*(last - 1));
+        }
+        std::reverse(expected.begin(), expected.end());
+        EXPECT_EQ(popped, expected);
+    }
+
+    // The first position that breaks the heap, as for std::is_heap_until.
+    const std::vector<int> v{9, 5, 4, 1, 1, 3, 2, 6, 8, 0, 7};
+    const auto until = dary::is_heap_until<D>(v.cbegin(), v.cend());
+    const auto parent = [&](auto it){ return v.cbegin() + (it - v.cbegin() - 1) / D; };
+    for (auto it = v.cbegin() + 1; it != until; ++it) EXPECT_GE(*parent(it), *it);
+    if (until != v.cend()) {
+        EXPECT_LT(*parent(until), *until);
+    }
+}
+
+TEST(sort_heap, ExampleTwoDaryHeapMatchesStd) {
+    ExpectDaryHeapMatchesStd<2>();
+    ExpectDaryHeapMatchesStd<4>();
+    ExpectDaryHeapMatchesStd<8>();
+
+    // With two children per node, the layout is the one std uses.
+    std::vector<int> v{1,2,3,4,5,6,5,4};
+    stl_examples::dary::make_heap<2>(v.begin(), v.end());
+    EXPECT_TRUE(std::is_heap(v.cbegin(), v.cend()));
+}
+
+TEST(push_heap, ExampleTwoIndexedPriorityQueue) {
+    // Shortest paths from vertex 0 with Dijkstra's algorithm: each vertex is queued
+    // once, and its distance is lowered in place when a shorter path is found.
+    struct Edge { std::size_t to; int weight; };
+    const std::vector<std::vector<Edge>> graph{
+            {{1, 4}, {2, 1}},
+            {{3, 1}},
+            {{1, 2}, {3, 5}},
+            {},
+    };
+    std::vector<int> distance(graph.size(), std::numeric_limits<int>::max());
+    stl_examples::IndexedPriorityQueue<int> queue(graph.size());
+    distance[0] = 0;
+    queue.push(0, 0);
+    while (!queue.empty()) {
+        const std::size_t u = queue.top();
+        queue.pop();
+        for (const Edge& e : graph[u]) {
+            const int d = distance[u] + e.weight;
+            if (d >= distance[e.to]) continue;
+            distance[e.to] = d;
+            if (queue.contains(e.to)) queue.decrease_key(e.to, d);
+            else queue.push(e.to, d);
+        }
+    }
+    const std::vector<int> expected_distance{0, 3, 1, 4};
+    EXPECT_EQ(distance, expected_distance);
+}
+
+TEST(push_heap, ExampleThreeIndexedPriorityQueueMatchesReference) {
+    // Random pushes, pops, erases and priority changes, checked against a std::set.
+    std::mt19937 gen(13);
+    constexpr std::size_t capacity = 500;
+    stl_examples::IndexedPriorityQueue<int> queue(capacity);
+    std::set<std::pair<int, std::size_t>> reference;
+    std::vector<int> priority(capacity);
+    for (int step = 0; step < 20000; ++step) {
+        const std::size_t id = gen() % capacity;
+        const int p = static_cast<int>(gen() % 1000);
+        switch (gen() % 4) {
+            case 0:
+                if (queue.contains(id)) break;
+                queue.push(id, p);
+                reference.insert({p, id});
+                priority[id] = p;
+                break;
+            case 1:
+                if (queue.empty()) break;
+                ASSERT_EQ(queue.top_priority(), reference.begin()->first);
+                reference.erase({queue.top_priority(), queue.top()});
+                queue.pop();
+                break;
+            case 2:
+                if (!queue.contains(id)) break;
+                queue.erase(id);
+                reference.erase({priority[id], id});
+                break;
+            case 3:
+                if (!queue.contains(id)) break;
+                reference.erase({priority[id], id});
+                if (p <= priority[id]) queue.decrease_key(id, p);
+                else queue.update(id, p);
+                reference.insert({p, id});
+                priority[id] = p;
+                break;
+        }
+        ASSERT_EQ(queue.size(), reference.size());
+        for (std::size_t i = 0; i < capacity; i += 37) {
+            ASSERT_EQ(queue.contains(i), reference.count({priority[i], i}) == 1);
+        }
+    }
+}
+
 // Minimum, maximum operations.
 TEST(max, ExampleOne) {
     EXPECT_EQ(std::max(1,2), 2);
@@ -895,6 +2595,73 @@ TEST(minmax_element, ExampleOne) {
     EXPECT_EQ(*max, 6);
 }
 
+template<class T>
+void ExpectSimdExtremaMatchStd(const std::vector<T>& v) {
+    namespace simd = stl_examples::simd;
+    const auto expected_min = std::min_element(v.cbegin(), v.cend()) - v.cbegin();
+    const auto expected_max = std::max_element(v.cbegin(), v.cend()) - v.cbegin();
+    const auto expected_minmax = std::minmax_element(v.cbegin(), v.cend());
+    ForEachSimdLevel([&] {
+        EXPECT_EQ(simd::min_element(v.cbegin(), v.cend()) - v.cbegin(), expected_min);
+        EXPECT_EQ(simd::max_element(v.cbegin(), v.cend()) - v.cbegin(), expected_max);
+        const auto minmax = simd::minmax_element(v.cbegin(), v.cend());
+        EXPECT_EQ(minmax.first, expected_minmax.first);
+        EXPECT_EQ(minmax.second, expected_minmax.second);
+    });
+}
+
+template<class T>
+void ExpectSimdExtremaMatchStd() {
+    std::mt19937 gen(23);
+    for (const std::size_t size : {0, 1, 2, 15, 16, 17, 33, 64, 100, 257, 1000}) {
+        SCOPED_TRACE(size);
+        // Many equal extrema, for the tie-breaks, and few.
+        for (const int max_value : {3, 1'000'000}) {
+            std::vector<T> v = RandomVector<T>(gen, size, -max_value, max_value);
+            ExpectSimdExtremaMatchStd(v);
+            std::sort(v.begin(), v.end());
+            ExpectSimdExtremaMatchStd(v);
+            std::reverse(v.begin(), v.end());
+            ExpectSimdExtremaMatchStd(v);
+            if constexpr (std::is_floating_point_v<T>) {
+                // -0.0 and 0.0 are equal; a NaN makes the result depend on its position.
+                std::replace(v.begin(), v.end(), T{0}, -T{0});
+                ExpectSimdExtremaMatchStd(v);
+                for (const std::size_t at : {std::size_t{0}, size / 2, size - 1}) {
+                    if (at >= size) continue;
+                    std::vector<T> with_nan = v;
+                    with_nan[at] = std::numeric_limits<T>::quiet_NaN();
+                    ExpectSimdExtremaMatchStd(with_nan);
+                }
+            }
+        }
+    }
+}
+
+TEST(minmax_element, ExampleTwoSimdMatchesStd) {
+    ExpectSimdExtremaMatchStd<int>();
+    ExpectSimdExtremaMatchStd<unsigned>();
+    ExpectSimdExtremaMatchStd<std::int64_t>();
+    ExpectSimdExtremaMatchStd<std::uint64_t>();
+    ExpectSimdExtremaMatchStd<float>();
+    ExpectSimdExtremaMatchStd<double>();
+    ExpectSimdExtremaMatchStd<std::int16_t>();
+}
+
+TEST(minmax_element, ExampleThreeValueAndIndex) {
+    // The first smallest and the last largest, as std::minmax_element.
+    namespace simd = stl_examples::simd;
+    std::vector<double> samples(100, 20.5);
+    samples[10] = samples[30] = -4.0;
+    samples[50] = samples[70] = 99.0;
+    const simd::extrema_result<double> extrema = simd::extrema(samples.cbegin(), samples.cend());
+    EXPECT_EQ(extrema.min, -4.0);
+    EXPECT_EQ(extrema.min_index, 10u);
+    EXPECT_EQ(extrema.max, 99.0);
+    EXPECT_EQ(extrema.max_index, 70u);
+    EXPECT_EQ(simd::max_element(samples.cbegin(), samples.cend()) - samples.cbegin(), 50);
+}
+
 TEST(clamp, ExampleOne) {
     int i = 11;
     const int max_bound = 10;
@@ -912,6 +2679,36 @@ TEST(clamp, ExampleOne) {
     EXPECT_EQ(new_i, 5);
 }
 
+template<class T>
+void ExpectSimdClampMatchesStd(std::vector<T> v, T lo, T hi) {
+    namespace simd = stl_examples::simd;
+    std::vector<T> expected = v;
+    for (T& x : expected) x = std::clamp(x, lo, hi);
+    ForEachSimdLevel([&] {
+        std::vector<T> clamped = v;
+        simd::clamp(clamped.begin(), clamped.end(), lo, hi);
+        EXPECT_TRUE(BitwiseEqual(clamped, expected));
+    });
+}
+
+TEST(clamp, ExampleTwoBulk) {
+    std::mt19937 gen(23);
+    for (const std::size_t size : {0, 1, 7, 16, 33, 100, 1000}) {
+        SCOPED_TRACE(size);
+        const std::vector<int> v = RandomVector<int>(gen, size, -100, 100);
+        ExpectSimdClampMatchesStd<int>(v, -10, 10);
+        ExpectSimdClampMatchesStd<unsigned>({v.cbegin(), v.cend()}, 5u, 1u << 31);
+        ExpectSimdClampMatchesStd<std::int64_t>({v.cbegin(), v.cend()}, 0, 50);
+        ExpectSimdClampMatchesStd<std::uint64_t>({v.cbegin(), v.cend()}, 3, std::uint64_t{1} << 63);
+        ExpectSimdClampMatchesStd<short>({v.cbegin(), v.cend()}, -1, 1);
+
+        std::vector<float> f(v.cbegin(), v.cend());
+        if (size > 2) f[0] = std::numeric_limits<float>::quiet_NaN(), f[1] = -0.0f;
+        ExpectSimdClampMatchesStd<float>(f, 0.0f, 1.0f);
+        ExpectSimdClampMatchesStd<double>({f.cbegin(), f.cend()}, -0.0, 0.5);
+    }
+}
+
 // Comparison operations.
 TEST(equal, ExampleOne) {
     const std::vector<int> v1{1,2,3,4,5};
@@ -931,6 +2728,20 @@ TEST(lexicographical_compare, ExampleOne) {
     EXPECT_TRUE(compare_words);
 }
 
+TEST(lexicographical_compare, ExampleTwoSimdSignedChar) {
+    // Orders chars as char does, which is signed here, unlike memcmp: "\x80" < "a".
+    namespace simd = stl_examples::simd;
+    std::string s1(100, 'a');
+    std::string s2 = s1;
+    s1[70] = '\x80';
+    ForEachSimdLevel([&] {
+        EXPECT_EQ(simd::lexicographical_compare(s1.cbegin(), s1.cend(), s2.cbegin(), s2.cend()),
+                  std::lexicographical_compare(s1.cbegin(), s1.cend(), s2.cbegin(), s2.cend()));
+        EXPECT_EQ(simd::mismatch(s1.cbegin(), s1.cend(), s2.cbegin()).first - s1.cbegin(), 70);
+        EXPECT_FALSE(simd::equal(s1.cbegin(), s1.cend(), s2.cbegin(), s2.cend()));
+    });
+}
+
 // Permutation operations.
 TEST(is_permutation, ExampleOne) {
     const std::vector<int> v1{1,2,3};
@@ -944,6 +2755,113 @@ TEST(is_permutation, ExampleOne) {
     EXPECT_FALSE(is_permutation);
 }
 
+TEST(is_permutation, ExampleTwoInstrumented) {
+    // std::is_permutation looks for each element in both ranges, so it is
+    // quadratic: for n distinct elements in reverse order, over n * n comparisons.
+    namespace instrument = stl_examples::instrument;
+    using instrument::Event;
+    std::vector<int> v1(1000);
+    std::iota(v1.begin(), v1.end(), 0);
+    const std::vector<int> v2(v1.crbegin(), v1.crend());
+
+    const instrument::Counts start = instrument::snapshot();
+    EXPECT_TRUE(std::is_permutation(instrument::CountingIterator(v1.cbegin()), instrument::CountingIterator(v1.cend()),
+                                    instrument::CountingIterator(v2.cbegin()), instrument::CountingCompare<std::equal_to<>>()));
+    const instrument::Counts counts = instrument::snapshot() - start;
+
+    if constexpr (instrument::enabled) {
+        EXPECT_GT(counts[Event::comparisons], 1000 * 1000);
+        EXPECT_GE(counts[Event::dereferences], 2 * counts[Event::comparisons]);
+        EXPECT_EQ(counts[Event::allocations], 0);
+    } else {
+        EXPECT_EQ(counts, instrument::Counts());
+    }
+}
+
+template<class T>
+void ExpectAdaptiveIsPermutationMatchesStd(const std::vector<T>& a, const std::vector<T>& b) {
+    namespace adaptive = stl_examples::adaptive;
+    const bool expected = std::is_permutation(a.cbegin(), a.cend(), b.cbegin(), b.cend());
+    EXPECT_EQ(adaptive::is_permutation(a.cbegin(), a.cend(), b.cbegin(), b.cend()), expected);
+    EXPECT_EQ(adaptive::is_permutation(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::equal_to<T>()), expected);
+    EXPECT_EQ(adaptive::multiset_equal(a, b), expected);
+    if (a.size() == b.size()) {
+        EXPECT_EQ(adaptive::is_permutation(a.cbegin(), a.cend(), b.cbegin()), expected);
+    }
+}
+
+template<class T, class Make>
+void ExpectAdaptiveIsPermutationMatchesStd(Make make) {
+    std::mt19937 gen(25);
+    for (const std::size_t size : {0, 1, 5, 31, 32, 100, 1000, 5000}) {
+        SCOPED_TRACE(size);
+        for (const int max_value : {3, 1'000'000}) {
+            const std::vector<int> values = RandomVector<int>(gen, size, -max_value, max_value);
+            std::vector<T> a(size);
+            std::transform(values.cbegin(), values.cend(), a.begin(), make);
+            std::vector<T> b = a;
+            std::shuffle(b.begin(), b.end(), gen);
+            ExpectAdaptiveIsPermutationMatchesStd(a, b);
+            if (size == 0) continue;
+            // One element changed, one duplicated in place of another, one missing.
+            std::vector<T> changed = b;
+            changed[size / 2] = make(max_value + 1);
+            ExpectAdaptiveIsPermutationMatchesStd(a, changed);
+            std::vector<T> duplicated = b;
+            duplicated[0] = duplicated[size - 1];
+            ExpectAdaptiveIsPermutationMatchesStd(a, duplicated);
+            ExpectAdaptiveIsPermutationMatchesStd(a, std::vector<T>(b.cbegin(), b.cend() - 1));
+            if constexpr (std::is_floating_point_v<T>) {
+                std::vector<T> zeros = b;
+                std::replace(zeros.begin(), zeros.end(), T{0}, -T{0});
+                ExpectAdaptiveIsPermutationMatchesStd(a, zeros);
+                std::vector<T> nan_a = a;
+                nan_a[size - 1] = std::numeric_limits<T>::quiet_NaN();
+                ExpectAdaptiveIsPermutationMatchesStd(nan_a, nan_a);
+                ExpectAdaptiveIsPermutationMatchesStd(a, nan_a);
+            }
+        }
+    }
+}
+
+// Compared with ==, but neither hashed nor ordered: counted by std::is_permutation.
+struct Opaque {
+    int value;
+    bool operator==(const Opaque&) const = default;
+};
+
+TEST(is_permutation, ExampleThreeAdaptiveMatchesStd) {
+    const auto cast = [](auto tag) { return [](int i) { return static_cast<decltype(tag)>(i); }; };
+    ExpectAdaptiveIsPermutationMatchesStd<char>(cast(char{}));
+    ExpectAdaptiveIsPermutationMatchesStd<std::uint8_t>(cast(std::uint8_t{}));
+    ExpectAdaptiveIsPermutationMatchesStd<std::int16_t>(cast(std::int16_t{}));
+    ExpectAdaptiveIsPermutationMatchesStd<int>(cast(int{}));
+    ExpectAdaptiveIsPermutationMatchesStd<std::uint64_t>(cast(std::uint64_t{}));
+    ExpectAdaptiveIsPermutationMatchesStd<float>(cast(float{}));
+    ExpectAdaptiveIsPermutationMatchesStd<double>(cast(double{}));
+    ExpectAdaptiveIsPermutationMatchesStd<std::string>([](int i) { return std::to_string(i); });
+    ExpectAdaptiveIsPermutationMatchesStd<Opaque>([](int i) { return Opaque{i}; });
+}
+
+TEST(is_permutation, ExampleFourReconciliation) {
+    // Two batches of 1M ids, in different orders: std::is_permutation would make
+    // about 10^12 comparisons; adaptive::is_permutation sorts both in O(n).
+    namespace adaptive = stl_examples::adaptive;
+    std::vector<std::uint64_t> sent(1'000'000);
+    std::iota(sent.begin(), sent.end(), std::uint64_t{1} << 40);
+    std::vector<std::uint64_t> received(sent.crbegin(), sent.crend());
+    EXPECT_TRUE(adaptive::is_permutation(sent.cbegin(), sent.cend(), received.cbegin(), received.cend()));
+
+    // A lost id, replaced by a duplicate: caught by the fingerprints alone.
+    received[10] = received[11];
+    EXPECT_FALSE(adaptive::multiset_equal(sent, received));
+
+    // Other predicates are still honoured, by std::is_permutation.
+    const std::vector<int> v1{1,2,3};
+    const std::vector<int> v2{-2,3,-1};
+    EXPECT_TRUE(adaptive::is_permutation(v1.cbegin(), v1.cend(), v2.cbegin(), [](int a, int b){ return std::abs(a) == std::abs(b); }));
+}
+
 TEST(next_permutation, ExampleOne) {
     std::vector<int> v{1,2,3,4,5};
     std::next_permutation(v.begin(), v.end());
@@ -1023,6 +2941,18 @@ TEST(exclusive_scan, ExampleOne) {
     EXPECT_EQ(sums, expected_sums);
 }
 
+TEST(exclusive_scan, ExampleTwoIntoPresizedOutput) {
+    // Offsets of variable-sized records, e.g. for packing them into one buffer.
+    // scan::exclusive_scan writes into an output of the same size instead of
+    // growing it one push_back at a time, and splits large inputs across threads.
+    const std::vector<int> sizes{3,1,4,1,5};
+    std::vector<long long> offsets(sizes.size());
+    stl_examples::scan::exclusive_scan(sizes.cbegin(), sizes.cend(), offsets.begin(), 0LL);
+
+    const std::vector<long long> expected_offsets{0,3,4,8,9};
+    EXPECT_EQ(offsets, expected_offsets);
+}
+
 TEST(inclusive_scan, ExampleOne) {
     const std::vector<int> v{1,2,3,4,5};
     std::vector<int> sums;
@@ -1045,6 +2975,56 @@ TEST(reduce, ExampleOne) {
     EXPECT_EQ(product, 120);
 }
 
+TEST(reduce, ExampleTwoParallel) {
+    std::vector<int> v(100000);
+    std::iota(v.begin(), v.end(), 1);
+
+    // Since the order of the additions is unspecified, the initial value
+    // also determines the type that the partial sums are kept in.
+    const long long sum = std::reduce(std::execution::par, v.cbegin(), v.cend(), 0LL);
+    EXPECT_EQ(sum, 100000LL * 100001 / 2);
+}
+
+TEST(reduce, ExampleThreeDeterministic) {
+    // std::reduce with std::execution::par may round differently from run to
+    // run. deterministic::reduce adds in an order that depends only on the size,
+    // so the sum is the same, to the last bit, at any thread count.
+    namespace deterministic = stl_examples::deterministic;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(-20, 20);
+    for (const std::size_t n : {0, 1, 63, 1000, 1'000'003}) {
+        std::vector<float> v(n);
+        std::generate(v.begin(), v.end(), [&]{ return std::ldexp(mantissa(gen), exponent(gen)); });
+        const std::vector<double> wide(v.cbegin(), v.cend());
+        const long double exact = std::accumulate(v.cbegin(), v.cend(), 0.0L);
+
+        std::optional<float> first_sum, first_kahan;
+        std::optional<double> first_dot;
+        ForEachSimdLevel([&] {
+            for (const std::size_t threads : {1, 2, 3, 4, 8}) {
+                SCOPED_TRACE("n = " + std::to_string(n) + ", threads = " + std::to_string(threads));
+                const stl_examples::parallel::ThreadLimit limit(threads);
+                const float sum = deterministic::reduce(v.cbegin(), v.cend(), 0.0f);
+                const float kahan = deterministic::reduce(v.cbegin(), v.cend(), 0.0f, std::plus<>(), deterministic::Summation::kahan);
+                const double dot = deterministic::inner_product(wide.cbegin(), wide.cend(), wide.cbegin(), 0.0);
+                if (!first_sum) {
+                    first_sum = sum;
+                    first_kahan = kahan;
+                    first_dot = dot;
+                }
+                EXPECT_EQ(std::bit_cast<std::uint32_t>(sum), std::bit_cast<std::uint32_t>(*first_sum));
+                EXPECT_EQ(std::bit_cast<std::uint32_t>(kahan), std::bit_cast<std::uint32_t>(*first_kahan));
+                EXPECT_EQ(std::bit_cast<std::uint64_t>(dot), std::bit_cast<std::uint64_t>(*first_dot));
+            }
+        });
+        // Kahan's error bound, twice the rounding error of the sum of the magnitudes.
+        const long double magnitude = std::accumulate(v.cbegin(), v.cend(), 0.0L, [](long double a, float x){ return a + std::abs(x); });
+        EXPECT_LE(std::abs(*first_kahan - exact), 2 * std::numeric_limits<float>::epsilon() * magnitude);
+        EXPECT_NEAR(*first_sum, static_cast<double>(exact), 1e-5 * std::max(1.0, std::abs(static_cast<double>(exact))));
+    }
+}
+
 TEST(transform_reduce, ExampleOne) {
     std::vector<int> v{1,2,3,4,5};
     const int result = std::transform_reduce(v.cbegin(), v.cend(), 0, std::plus<>(), [](int a){return a * a;});
@@ -1056,6 +3036,24 @@ TEST(transform_reduce, ExampleOne) {
     EXPECT_EQ(result, 55);
 }
 
+TEST(transform_reduce, ExampleTwoDeterministic) {
+    // Any associative and commutative operator works, with the same result as std.
+    namespace deterministic = stl_examples::deterministic;
+    std::vector<int> v(200'000);
+    std::iota(v.begin(), v.end(), -100'000);
+    const auto square = [](int a){ return 1LL * a * a; };
+    const auto max = [](long long a, long long b){ return std::max(a, b); };
+    for (const std::size_t threads : {1, 4}) {
+        const stl_examples::parallel::ThreadLimit limit(threads);
+        EXPECT_EQ(deterministic::transform_reduce(v.cbegin(), v.cend(), 0LL, std::plus<>(), square),
+                  std::transform_reduce(v.cbegin(), v.cend(), 0LL, std::plus<>(), square));
+        EXPECT_EQ(deterministic::transform_reduce(v.cbegin(), v.cend(), 0LL, max, square), 10'000'000'000LL);
+        EXPECT_EQ(deterministic::accumulate(v.cbegin(), v.cend(), 7LL), std::accumulate(v.cbegin(), v.cend(), 7LL));
+        EXPECT_EQ(deterministic::inner_product(v.cbegin(), v.cend(), v.cbegin(), 0LL, std::plus<>(), std::multiplies<long long>()),
+                  std::inner_product(v.cbegin(), v.cend(), v.cbegin(), 0LL, std::plus<>(), std::multiplies<long long>()));
+    }
+}
+
 TEST(transform_exclusive_scan, ExampleOne) {
     const std::vector<int> v{1,2,3,4,5};
     std::vector<int> sums;
@@ -1084,13 +3082,88 @@ TEST(transform_inclusive_scan, ExampleOne) {
     EXPECT_EQ(sums, expected_sums);
 }
 
+// An affine map x -> a * x + b. Composing maps is associative but not commutative,
+// so it checks that the parallel scans combine blocks in order.
+struct Affine {
+    std::uint32_t a;
+    std::uint32_t b;
+    bool operator==(const Affine&) const = default;
+};
+
+TEST(transform_inclusive_scan, ExampleTwoParallelMatchesStd) {
+    namespace scan = stl_examples::scan;
+    const auto then = [](Affine f, Affine g){ return Affine{g.a * f.a, g.a * f.b + g.b}; };
+    const auto twice = [](std::int64_t x){ return 2 * x; };
+
+    std::mt19937 gen(5);
+    for (const std::size_t n : {0, 1, 7, 100, 300007}) {
+        const std::vector<int> v = RandomVector<int>(gen, n, -1000, 1000);
+        const std::vector<std::int64_t> wide(v.cbegin(), v.cend());
+        const std::vector<unsigned> as_unsigned(v.cbegin(), v.cend());
+        std::vector<Affine> maps(n);
+        std::generate(maps.begin(), maps.end(), [&]{ return Affine{static_cast<std::uint32_t>(gen()), static_cast<std::uint32_t>(gen())}; });
+
+        std::vector<int> expected(n), sums(n);
+        std::vector<std::int64_t> expected_wide(n), sums_wide(n);
+        std::vector<Affine> expected_maps(n), composed(n);
+        ForEachSimdLevel([&] {
+            for (const std::size_t threads : {1, 4}) {
+                SCOPED_TRACE("n = " + std::to_string(n) + ", threads = " + std::to_string(threads));
+                const stl_examples::parallel::ThreadLimit limit(threads);
+
+                std::inclusive_scan(v.cbegin(), v.cend(), expected.begin());
+                scan::inclusive_scan(v.cbegin(), v.cend(), sums.begin());
+                EXPECT_EQ(sums, expected);
+
+                std::partial_sum(v.cbegin(), v.cend(), expected.begin());
+                scan::partial_sum(v.cbegin(), v.cend(), sums.begin());
+                EXPECT_EQ(sums, expected);
+
+                // 32-bit elements summed into 64 bits, zero- and sign-extended.
+                std::inclusive_scan(as_unsigned.cbegin(), as_unsigned.cend(), expected_wide.begin(), std::plus<>(), std::int64_t{0});
+                scan::inclusive_scan(as_unsigned.cbegin(), as_unsigned.cend(), sums_wide.begin(), std::plus<>(), std::int64_t{0});
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                std::exclusive_scan(v.cbegin(), v.cend(), expected_wide.begin(), std::int64_t{0});
+                scan::exclusive_scan(v.cbegin(), v.cend(), sums_wide.begin(), std::int64_t{0});
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                std::exclusive_scan(wide.cbegin(), wide.cend(), expected_wide.begin(), std::int64_t{42});
+                scan::exclusive_scan(wide.cbegin(), wide.cend(), sums_wide.begin(), std::int64_t{42});
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                // In place, as std allows.
+                sums_wide = wide;
+                scan::exclusive_scan(sums_wide.cbegin(), sums_wide.cend(), sums_wide.begin(), std::int64_t{42});
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                std::transform_inclusive_scan(wide.cbegin(), wide.cend(), expected_wide.begin(), std::plus<>(), twice, std::int64_t{-7});
+                scan::transform_inclusive_scan(wide.cbegin(), wide.cend(), sums_wide.begin(), std::plus<>(), twice, std::int64_t{-7});
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                std::transform_exclusive_scan(v.cbegin(), v.cend(), expected_wide.begin(), std::int64_t{0}, std::plus<>(), twice);
+                scan::transform_exclusive_scan(v.cbegin(), v.cend(), sums_wide.begin(), std::int64_t{0}, std::plus<>(), twice);
+                EXPECT_EQ(sums_wide, expected_wide);
+
+                std::inclusive_scan(maps.cbegin(), maps.cend(), expected_maps.begin(), then);
+                scan::inclusive_scan(maps.cbegin(), maps.cend(), composed.begin(), then);
+                EXPECT_EQ(composed, expected_maps);
+            }
+        });
+    }
+}
+
 // C library.
 TEST(qsort, ExampleOne) {
     int a[] = {-10, 1, 14, 3, 2, 2, 5};
     constexpr std::size_t size = sizeof(a) / sizeof(int);
 
+    // Note that returning *a - *b overflows for large values of opposite sign,
+    // e.g. INT_MIN and 1. Comparing avoids that.
     const auto compare = [](const void* a, const void* b)->int {
-        return ( *(int*)a - *(int*) b);
+        const int aa = *(const int*)a;
+        const int bb = *(const int*)b;
+        return (aa > bb) - (aa < bb);
     };
     std::qsort(a, size, sizeof(int), compare);
 
@@ -1115,3 +3188,37 @@ TEST(bsearch, ExampleOne) {
     EXPECT_EQ(find - a, 5);
 }
 
+// Parallel versions of the examples above.
+// See parallel_algorithms.h, and STL_examples_scaling for timings.
+TEST(execution_policy, ParallelMatchesSequential) {
+    namespace parallel = stl_examples::parallel;
+    const parallel::Dataset data = parallel::make_dataset(100003);
+    for (const std::size_t threads : {1, 2, 4}) {
+        const parallel::ThreadLimit limit(threads);
+        for (const parallel::Case& c : parallel::parallel_cases()) {
+            SCOPED_TRACE(std::string(c.algorithm) + " with " + std::to_string(threads) + " threads");
+            parallel::Scratch expected, par, par_unseq;
+            parallel::reset(data, expected);
+            parallel::reset(data, par);
+            parallel::reset(data, par_unseq);
+
+            const parallel::Result expected_result = c.seq(data, expected);
+            EXPECT_EQ(c.par(data, par), expected_result);
+            EXPECT_EQ(c.par_unseq(data, par_unseq), expected_result);
+            EXPECT_EQ(par.values, expected.values);
+            EXPECT_EQ(par_unseq.values, expected.values);
+            EXPECT_EQ(par.wide, expected.wide);
+            EXPECT_EQ(par_unseq.wide, expected.wide);
+        }
+    }
+}
+
+TEST(execution_policy, ThreadLimit) {
+    namespace parallel = stl_examples::parallel;
+    {
+        const parallel::ThreadLimit limit(2);
+        EXPECT_EQ(parallel::ThreadLimit::current(), 2);
+    }
+    const std::vector<std::size_t> expected_counts{1, 2, 4, 8, 12};
+    EXPECT_EQ(parallel::thread_counts(12), expected_counts);
+}
@@ -0,0 +1,2058 @@
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "bench_data.h"
+#include "dary_heap.h"
+#include "eytzinger_index.h"
+#include "external_sort.h"
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "parallel_algorithms.h"
+#include "parallel_merge_sort.h"
+#include "parallel_reduce.h"
+#include "parallel_scan.h"
+#include "permutation.h"
+#include "pipeline.h"
+#include "radix_sort.h"
+#include "random_sampling.h"
+#include "selection.h"
+#include "set_operations.h"
+#include "sort_by_key.h"
+#include "simd_byte_set.h"
+#include "simd_compaction.h"
+#include "simd_compare.h"
+#include "simd_minmax.h"
+#include "simd_search.h"
+#include "simd_unique.h"
+#include "substring_search.h"
+
+// Benchmarks for each TEST family in STL_examples.cpp, at sizes from 1K to 1G
+// elements, over the input distributions in bench_data.h.
+//
+// To find the benchmark for a specific function,
+// simply use the find feature and type:
+//        BM_<function_name>
+//
+// Every benchmark takes two arguments: the number of elements n, and the
+// Distribution of the input. Throughput is reported as items_per_second
+// (elements, or queries for the searches) and bytes_per_second.
+//
+// To emit JSON, for example to track results across compiler and library upgrades:
+//       STL_examples_bench --benchmark_out=bench.json --benchmark_out_format=json
+// To limit the largest input size (1G elements by default):
+//       STL_EXAMPLES_BENCH_MAX_SIZE=1048576 STL_examples_bench
+//
+// BM_simd_<function_name> benchmarks the faster alternative to BM_<function_name>
+// from the corresponding header, e.g. simd_search.h.
+//
+// The benchmarks of parallel alternatives take a third argument, the number of
+// threads, from 1 up to the number of hardware threads.
+
+namespace bench = stl_examples::bench;
+namespace instrument = stl_examples::instrument;
+namespace parallel = stl_examples::parallel;
+namespace pipeline = stl_examples::pipeline;
+namespace simd = stl_examples::simd;
+namespace substring = stl_examples::substring;
+
+namespace {
+
+// Number of lookups per iteration of the search benchmarks.
+constexpr std::int64_t kQueries = 1024;
+
+template<class T = int>
+std::vector<T> input(benchmark::State& state) {
+    const auto distribution = static_cast<bench::Distribution>(state.range(1));
+    state.SetLabel(std::string(bench::distribution_name(distribution)));
+    return bench::make_input<T>(static_cast<std::size_t>(state.range(0)), distribution);
+}
+
+template<class T = int>
+std::vector<T> sorted_input(benchmark::State& state) {
+    std::vector<T> v = input<T>(state);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// Keys to look up in 'v': half of them present, half (most likely) absent.
+template<class T>
+std::vector<T> queries(const std::vector<T>& v) {
+    std::vector<T> keys(kQueries);
+    std::mt19937_64 gen(7);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i % 2 == 0 && !v.empty() ? v[gen() % v.size()] : static_cast<T>(gen());
+    }
+    return keys;
+}
+
+template<class T>
+void set_throughput(benchmark::State& state, std::int64_t items_per_iteration) {
+    state.SetItemsProcessed(state.iterations() * items_per_iteration);
+    state.SetBytesProcessed(state.iterations() * items_per_iteration * static_cast<std::int64_t>(sizeof(T)));
+}
+
+// In report mode (STL_EXAMPLES_REPORT=1), adds the counts of instrumentation.h
+// to the counters of the benchmark, per iteration.
+void report(benchmark::State& state, const instrument::Counts& counts) {
+    if (!instrument::report_mode()) return;
+    for (std::size_t i = 0; i < instrument::num_events; ++i) {
+        if (counts.values[i] == 0) continue;
+        state.counters[instrument::event_name(static_cast<instrument::Event>(i))] =
+            benchmark::Counter(static_cast<double>(counts.values[i]), benchmark::Counter::kAvgIterations);
+    }
+}
+
+// Times 'body()' once per iteration.
+template<class T, class Body>
+void run(benchmark::State& state, std::int64_t items_per_iteration, Body body) {
+    instrument::Counts counts;
+    for (auto _ : state) {
+        const instrument::Counts before = instrument::snapshot();
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(elapsed.count());
+        counts += instrument::snapshot() - before;
+        benchmark::ClobberMemory();
+    }
+    set_throughput<T>(state, items_per_iteration);
+    report(state, counts);
+}
+
+// Times 'body(work)' once per iteration, where 'work' is a fresh copy of 'v'.
+// Making the copy is not timed.
+template<class T, class Body>
+void run_on_copy(benchmark::State& state, const std::vector<T>& v, Body body) {
+    std::vector<T> work;
+    instrument::Counts counts;
+    for (auto _ : state) {
+        work = v;
+        const instrument::Counts before = instrument::snapshot();
+        const auto start = std::chrono::steady_clock::now();
+        body(work);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(elapsed.count());
+        counts += instrument::snapshot() - before;
+        benchmark::ClobberMemory();
+    }
+    set_throughput<T>(state, static_cast<std::int64_t>(v.size()));
+    report(state, counts);
+}
+
+void SizesAndDistributions(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "dist"});
+    for (const std::int64_t n : benchmark::CreateRange(1 << 10, bench::max_size(), /*multi=*/8)) {
+        for (int distribution = 0; distribution < bench::num_distributions; ++distribution) {
+            b->Args({n, distribution});
+        }
+    }
+}
+
+void SizesDistributionsAndThreads(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "dist", "threads"});
+    for (const std::int64_t n : benchmark::CreateRange(1 << 10, bench::max_size(), /*multi=*/8)) {
+        for (int distribution = 0; distribution < bench::num_distributions; ++distribution) {
+            for (const std::size_t threads : parallel::thread_counts()) {
+                b->Args({n, distribution, static_cast<std::int64_t>(threads)});
+            }
+        }
+    }
+}
+
+} // namespace
+
+#define STL_BENCHMARK(name) BENCHMARK(name)->Apply(SizesAndDistributions)->UseManualTime()
+#define STL_PARALLEL_BENCHMARK(name) BENCHMARK(name)->Apply(SizesDistributionsAndThreads)->UseManualTime()
+
+// Non-modifying sequence operations.
+static void BM_any_of(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::any_of(v.cbegin(), v.cend(), [](int i){ return i < 0; })); });
+}
+STL_BENCHMARK(BM_any_of);
+
+static void BM_simd_any_of(benchmark::State& state) {
+    const auto v = input(state);
+    const simd::in_range<int> isNegative{std::numeric_limits<int>::min(), -1};
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::any_of(v.cbegin(), v.cend(), isNegative)); });
+}
+STL_BENCHMARK(BM_simd_any_of);
+
+static void BM_all_of(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::all_of(v.cbegin(), v.cend(), [](int i){ return i >= 0; })); });
+}
+STL_BENCHMARK(BM_all_of);
+
+static void BM_simd_all_of(benchmark::State& state) {
+    const auto v = input(state);
+    const simd::in_range<int> isNotNegative{0, std::numeric_limits<int>::max()};
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::all_of(v.cbegin(), v.cend(), isNotNegative)); });
+}
+STL_BENCHMARK(BM_simd_all_of);
+
+static void BM_none_of(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::none_of(v.cbegin(), v.cend(), [](int i){ return i < 0; })); });
+}
+STL_BENCHMARK(BM_none_of);
+
+static void BM_simd_none_of(benchmark::State& state) {
+    const auto v = input(state);
+    const simd::in_range<int> isNegative{std::numeric_limits<int>::min(), -1};
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::none_of(v.cbegin(), v.cend(), isNegative)); });
+}
+STL_BENCHMARK(BM_simd_none_of);
+
+static void BM_for_each(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        long long accumulator = 0;
+        std::for_each(v.cbegin(), v.cend(), [&accumulator](int i){ accumulator += i; });
+        benchmark::DoNotOptimize(accumulator);
+    });
+}
+STL_BENCHMARK(BM_for_each);
+
+static void BM_for_each_n(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size() / 2, [&]{
+        long long accumulator = 0;
+        std::for_each_n(v.cbegin(), v.size() / 2, [&accumulator](int i){ accumulator += i; });
+        benchmark::DoNotOptimize(accumulator);
+    });
+}
+STL_BENCHMARK(BM_for_each_n);
+
+static void BM_count(benchmark::State& state) {
+    const auto v = input<char>(state);
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::count(v.cbegin(), v.cend(), 'a')); });
+}
+STL_BENCHMARK(BM_count);
+
+static void BM_simd_count(benchmark::State& state) {
+    const auto v = input<char>(state);
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::count(v.cbegin(), v.cend(), 'a')); });
+}
+STL_BENCHMARK(BM_simd_count);
+
+static void BM_count_if(benchmark::State& state) {
+    const auto v = input<char>(state);
+    const auto isLowercaseLetter = [](char ch)->bool{ return ch >= 'a' && ch <= 'z'; };
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::count_if(v.cbegin(), v.cend(), isLowercaseLetter)); });
+}
+STL_BENCHMARK(BM_count_if);
+
+static void BM_simd_count_if(benchmark::State& state) {
+    const auto v = input<char>(state);
+    const simd::in_range<char> isLowercaseLetter{'a', 'z'};
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::count_if(v.cbegin(), v.cend(), isLowercaseLetter)); });
+}
+STL_BENCHMARK(BM_simd_count_if);
+
+static void BM_mismatch(benchmark::State& state) {
+    const auto v1 = input(state);
+    const auto v2 = v1;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(std::mismatch(v1.cbegin(), v1.cend(), v2.cbegin())); });
+}
+STL_BENCHMARK(BM_mismatch);
+
+static void BM_simd_mismatch(benchmark::State& state) {
+    const auto v1 = input(state);
+    const auto v2 = v1;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(simd::mismatch(v1.cbegin(), v1.cend(), v2.cbegin())); });
+}
+STL_BENCHMARK(BM_simd_mismatch);
+
+static void BM_find(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::find(v.cbegin(), v.cend(), -1)); });
+}
+STL_BENCHMARK(BM_find);
+
+static void BM_simd_find(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::find(v.cbegin(), v.cend(), -1)); });
+}
+STL_BENCHMARK(BM_simd_find);
+
+static void BM_find_char(benchmark::State& state) {
+    auto v = input<char>(state);
+    std::replace(v.begin(), v.end(), '\n', ' ');
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::find(v.cbegin(), v.cend(), '\n')); });
+}
+STL_BENCHMARK(BM_find_char);
+
+static void BM_simd_find_char(benchmark::State& state) {
+    auto v = input<char>(state);
+    std::replace(v.begin(), v.end(), '\n', ' ');
+    run<char>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::find(v.cbegin(), v.cend(), '\n')); });
+}
+STL_BENCHMARK(BM_simd_find_char);
+
+static void BM_find_if(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::find_if(v.cbegin(), v.cend(), [](int i){ return i < 0; })); });
+}
+STL_BENCHMARK(BM_find_if);
+
+static void BM_find_if_not(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::find_if_not(v.cbegin(), v.cend(), [](int i){ return i >= 0; })); });
+}
+STL_BENCHMARK(BM_find_if_not);
+
+static void BM_find_end(benchmark::State& state) {
+    const auto v = input(state);
+    const std::vector<int> sequence(v.cbegin(), v.cbegin() + 8);
+    run<int>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::find_end(v.cbegin(), v.cend(), sequence.cbegin(), sequence.cend()));
+    });
+}
+STL_BENCHMARK(BM_find_end);
+
+static void BM_find_first_of(benchmark::State& state) {
+    auto v = input<char>(state);
+    const std::vector<char> sequence{'w', 'r', 'd'};
+    // Removes the characters being searched for, so the whole range is scanned.
+    std::replace_if(v.begin(), v.end(), [](char c){ return c == 'w' || c == 'r' || c == 'd'; }, 'x');
+    run<char>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::find_first_of(v.cbegin(), v.cend(), sequence.cbegin(), sequence.cend()));
+    });
+}
+STL_BENCHMARK(BM_find_first_of);
+
+static void BM_simd_find_first_of(benchmark::State& state) {
+    auto v = input<char>(state);
+    const std::vector<char> sequence{'w', 'r', 'd'};
+    std::replace_if(v.begin(), v.end(), [](char c){ return c == 'w' || c == 'r' || c == 'd'; }, 'x');
+    run<char>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(simd::find_first_of(v.cbegin(), v.cend(), sequence.cbegin(), sequence.cend()));
+    });
+}
+STL_BENCHMARK(BM_simd_find_first_of);
+
+// Splits a text of lowercase letters into tokens at any of 8 delimiters, as a
+// tokenizer does: std::find_first_of with a nested loop, against a byte_set.
+constexpr std::string_view kDelimiters = " ,;:.\t\n|";
+
+std::string token_text(benchmark::State& state) {
+    const auto bytes = input<unsigned char>(state);
+    std::string text(bytes.size(), ' ');
+    std::transform(bytes.cbegin(), bytes.cend(), text.begin(), [](unsigned char c){
+        // About one delimiter in 16 chars.
+        return c % 16 == 0 ? kDelimiters[c / 16 % kDelimiters.size()] : static_cast<char>('a' + c % 26);
+    });
+    return text;
+}
+
+static void BM_tokenize(benchmark::State& state) {
+    const std::string text = token_text(state);
+    run<char>(state, text.size(), [&]{
+        std::size_t tokens = 0;
+        for (auto it = text.cbegin(); it != text.cend(); ++tokens) {
+            const auto end = std::find_first_of(it, text.cend(), kDelimiters.cbegin(), kDelimiters.cend());
+            it = std::find_if(end, text.cend(), [](char c){ return kDelimiters.find(c) == std::string_view::npos; });
+        }
+        benchmark::DoNotOptimize(tokens);
+    });
+}
+STL_BENCHMARK(BM_tokenize);
+
+static void BM_simd_tokenize(benchmark::State& state) {
+    const std::string text = token_text(state);
+    const simd::byte_set delimiters(kDelimiters);
+    run<char>(state, text.size(), [&]{
+        std::size_t tokens = 0;
+        for (auto it = text.cbegin(); it != text.cend(); ++tokens) {
+            const auto end = simd::find_first_of(it, text.cend(), delimiters);
+            it = simd::find_first_not_of(end, text.cend(), delimiters);
+        }
+        benchmark::DoNotOptimize(tokens);
+    });
+}
+STL_BENCHMARK(BM_simd_tokenize);
+
+static void BM_adjacent_find(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::adjacent_find(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_adjacent_find);
+
+static void BM_simd_adjacent_find(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::adjacent_find(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_simd_adjacent_find);
+
+static void BM_search(benchmark::State& state) {
+    const auto v = input(state);
+    const std::vector<int> sequence(v.cend() - 8, v.cend());
+    run<int>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::search(v.cbegin(), v.cend(), sequence.cbegin(), sequence.cend()));
+    });
+}
+STL_BENCHMARK(BM_search);
+
+// Text of lowercase letters (runs of one letter for 'sorted'), with the pattern
+// only at the end of the text, so that the whole of it is searched.
+constexpr std::string_view kLogPattern = "connection reset";
+
+std::string log_text(benchmark::State& state) {
+    const auto bytes = input<unsigned char>(state);
+    std::string text(bytes.size(), ' ');
+    std::transform(bytes.cbegin(), bytes.cend(), text.begin(), [](unsigned char c){ return static_cast<char>('a' + c % 26); });
+    if (text.size() >= kLogPattern.size()) text.replace(text.size() - kLogPattern.size(), kLogPattern.size(), kLogPattern);
+    return text;
+}
+
+template<class MakeSearcher>
+void search_log(benchmark::State& state, MakeSearcher make_searcher) {
+    const std::string text = log_text(state);
+    const auto searcher = make_searcher(kLogPattern.cbegin(), kLogPattern.cend());
+    run<char>(state, text.size(), [&]{ benchmark::DoNotOptimize(std::search(text.cbegin(), text.cend(), searcher)); });
+}
+
+static void BM_search_log(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return std::default_searcher(first, last); });
+}
+STL_BENCHMARK(BM_search_log);
+
+static void BM_search_log_boyer_moore(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return std::boyer_moore_searcher(first, last); });
+}
+STL_BENCHMARK(BM_search_log_boyer_moore);
+
+static void BM_search_log_boyer_moore_horspool(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return std::boyer_moore_horspool_searcher(first, last); });
+}
+STL_BENCHMARK(BM_search_log_boyer_moore_horspool);
+
+static void BM_search_log_horspool(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return substring::horspool_searcher(first, last); });
+}
+STL_BENCHMARK(BM_search_log_horspool);
+
+static void BM_search_log_two_way(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return substring::two_way_searcher(first, last); });
+}
+STL_BENCHMARK(BM_search_log_two_way);
+
+static void BM_simd_search_log(benchmark::State& state) {
+    search_log(state, [](auto first, auto last){ return substring::simd_searcher(first, last); });
+}
+STL_BENCHMARK(BM_simd_search_log);
+
+// Case-insensitive search, with std::tolower and with simd::equal_ignore_case.
+static void BM_search_log_tolower(benchmark::State& state) {
+    const std::string text = log_text(state);
+    const auto tolower_equal = [](char a, char b){ return std::tolower(a) == std::tolower(b); };
+    run<char>(state, text.size(), [&]{
+        benchmark::DoNotOptimize(std::search(text.cbegin(), text.cend(), kLogPattern.cbegin(), kLogPattern.cend(), tolower_equal));
+    });
+}
+STL_BENCHMARK(BM_search_log_tolower);
+
+static void BM_search_log_ignore_case(benchmark::State& state) {
+    const std::string text = log_text(state);
+    run<char>(state, text.size(), [&]{
+        benchmark::DoNotOptimize(std::search(text.cbegin(), text.cend(), kLogPattern.cbegin(), kLogPattern.cend(),
+                                             simd::equal_ignore_case()));
+    });
+}
+STL_BENCHMARK(BM_search_log_ignore_case);
+
+// The pattern only at the start of the text, so that the whole of it is searched backward.
+std::string log_text_backward(benchmark::State& state) {
+    std::string text = log_text(state);
+    std::reverse(text.begin(), text.end());
+    if (text.size() >= kLogPattern.size()) text.replace(0, kLogPattern.size(), kLogPattern);
+    return text;
+}
+
+static void BM_find_end_log(benchmark::State& state) {
+    const std::string text = log_text_backward(state);
+    run<char>(state, text.size(), [&]{
+        benchmark::DoNotOptimize(std::find_end(text.cbegin(), text.cend(), kLogPattern.cbegin(), kLogPattern.cend()));
+    });
+}
+STL_BENCHMARK(BM_find_end_log);
+
+static void BM_simd_find_end_log(benchmark::State& state) {
+    const std::string text = log_text_backward(state);
+    run<char>(state, text.size(), [&]{
+        benchmark::DoNotOptimize(substring::find_end(text.cbegin(), text.cend(), kLogPattern.cbegin(), kLogPattern.cend()));
+    });
+}
+STL_BENCHMARK(BM_simd_find_end_log);
+
+// A run of 8 zeros, which the random input most likely lacks.
+constexpr int kRunLength = 8;
+
+static void BM_search_n(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::search_n(v.cbegin(), v.cend(), kRunLength, 0)); });
+}
+STL_BENCHMARK(BM_search_n);
+
+static void BM_simd_search_n(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(substring::search_n(v.cbegin(), v.cend(), kRunLength, 0)); });
+}
+STL_BENCHMARK(BM_simd_search_n);
+
+// Modifying sequence operations.
+static void BM_copy(benchmark::State& state) {
+    const auto from = input(state);
+    std::vector<int> to(from.size());
+    run<int>(state, from.size(), [&]{ std::copy(from.cbegin(), from.cend(), to.begin()); });
+}
+STL_BENCHMARK(BM_copy);
+
+static void BM_copy_if(benchmark::State& state) {
+    const auto from = input(state);
+    std::vector<int> to(from.size());
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    run<int>(state, from.size(), [&]{ benchmark::DoNotOptimize(std::copy_if(from.cbegin(), from.cend(), to.begin(), isEven)); });
+}
+STL_BENCHMARK(BM_copy_if);
+
+// The lower half of [0, n): half of the random input, in no predictable order.
+simd::in_range<int> lower_half(benchmark::State& state) {
+    return {0, static_cast<int>(state.range(0) / 2 - 1)};
+}
+
+static void BM_simd_copy_if(benchmark::State& state) {
+    const auto from = input(state);
+    std::vector<int> to(from.size());
+    const auto pred = lower_half(state);
+    run<int>(state, from.size(), [&]{ benchmark::DoNotOptimize(simd::copy_if(from.cbegin(), from.cend(), to.begin(), pred)); });
+}
+STL_BENCHMARK(BM_simd_copy_if);
+
+static void BM_simd_copy_if_lambda(benchmark::State& state) {
+    const auto from = input(state);
+    std::vector<int> to(from.size());
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    run<int>(state, from.size(), [&]{ benchmark::DoNotOptimize(simd::copy_if(from.cbegin(), from.cend(), to.begin(), isEven)); });
+}
+STL_BENCHMARK(BM_simd_copy_if_lambda);
+
+// A request that filters its input, then takes the running totals: the outputs
+// grown through back_inserter on the heap, against the same outputs reserved
+// once each in a monotonic arena, released after every request. 'allocations'
+// counts the allocations per request that reach the heap.
+static void BM_back_inserter_outputs(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    stl_examples::arena::CountingResource heap(std::pmr::new_delete_resource());
+    run<int>(state, v.size(), [&]{
+        std::pmr::vector<int> even(&heap);
+        std::copy_if(v.cbegin(), v.cend(), std::back_inserter(even), isEven);
+        std::pmr::vector<int> sums(&heap);
+        std::partial_sum(even.cbegin(), even.cend(), std::back_inserter(sums));
+        benchmark::DoNotOptimize(sums.data());
+    });
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(heap.allocations()), benchmark::Counter::kAvgIterations);
+    state.counters["peak_bytes"] = static_cast<double>(heap.peak_bytes());
+}
+STL_BENCHMARK(BM_back_inserter_outputs);
+
+static void BM_arena_outputs(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    stl_examples::arena::CountingResource heap(std::pmr::new_delete_resource());
+    // Room for both outputs at their largest; release() rewinds to the start of it.
+    std::vector<std::byte> buffer(2 * v.size() * sizeof(int) + 4096);
+    std::pmr::monotonic_buffer_resource request(buffer.data(), buffer.size(), &heap);
+    run<int>(state, v.size(), [&]{
+        {
+            const auto even = stl_examples::arena::copy_if(&request, v.cbegin(), v.cend(), isEven);
+            const auto sums = stl_examples::arena::partial_sum(&request, even.cbegin(), even.cend());
+            benchmark::DoNotOptimize(sums.data());
+        }
+        request.release();
+    });
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(heap.allocations()), benchmark::Counter::kAvgIterations);
+    state.counters["peak_bytes"] = static_cast<double>(heap.peak_bytes());
+}
+STL_BENCHMARK(BM_arena_outputs);
+
+static void BM_copy_backward(benchmark::State& state) {
+    const auto from = input(state);
+    std::vector<int> to(from.size());
+    run<int>(state, from.size(), [&]{ std::copy_backward(from.cbegin(), from.cend(), to.end()); });
+}
+STL_BENCHMARK(BM_copy_backward);
+
+static void BM_move(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(v.size());
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::move(work.begin(), work.end(), destination.begin()); });
+}
+STL_BENCHMARK(BM_move);
+
+static void BM_move_backward(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(v.size());
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::move_backward(work.begin(), work.end(), destination.end()); });
+}
+STL_BENCHMARK(BM_move_backward);
+
+static void BM_fill(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::fill(work.begin(), work.end(), 42); });
+}
+STL_BENCHMARK(BM_fill);
+
+static void BM_generate(benchmark::State& state) {
+    const auto v = input(state);
+    std::mt19937 gen(42);
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::generate(work.begin(), work.end(), std::ref(gen)); });
+}
+STL_BENCHMARK(BM_generate);
+
+static void BM_remove(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ work.erase(std::remove(work.begin(), work.end(), 0), work.end()); });
+}
+STL_BENCHMARK(BM_remove);
+
+static void BM_simd_remove(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ work.erase(simd::remove(work.begin(), work.end(), 0), work.end()); });
+}
+STL_BENCHMARK(BM_simd_remove);
+
+static void BM_remove_if(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isOdd = [](int i)->bool{ return i % 2 != 0; };
+    run_on_copy(state, v, [&](std::vector<int>& work){ work.erase(std::remove_if(work.begin(), work.end(), isOdd), work.end()); });
+}
+STL_BENCHMARK(BM_remove_if);
+
+static void BM_simd_remove_if(benchmark::State& state) {
+    const auto v = input(state);
+    const auto pred = lower_half(state);
+    run_on_copy(state, v, [&](std::vector<int>& work){ work.erase(simd::remove_if(work.begin(), work.end(), pred), work.end()); });
+}
+STL_BENCHMARK(BM_simd_remove_if);
+
+static void BM_transform(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        std::transform(work.begin(), work.end(), work.begin(), [](int i){ return i * 3 + 1; });
+    });
+}
+STL_BENCHMARK(BM_transform);
+
+// Filter, transform and sum: one step at a time, with a vector between the
+// steps, against the fused pipeline. 'temp_bytes' is the size of the
+// intermediate vectors, which the staged version writes and reads back.
+constexpr auto kIsEven = [](int i){ return i % 2 == 0; };
+constexpr auto kScale = [](int i){ return static_cast<std::int64_t>(i) * 3 + 1; };
+
+static void BM_staged_filter_transform_reduce(benchmark::State& state) {
+    const auto v = input(state);
+    std::size_t temp_bytes = 0;
+    run<int>(state, v.size(), [&]{
+        std::vector<int> even;
+        std::copy_if(v.cbegin(), v.cend(), std::back_inserter(even), kIsEven);
+        std::vector<std::int64_t> scaled;
+        std::transform(even.cbegin(), even.cend(), std::back_inserter(scaled), kScale);
+        benchmark::DoNotOptimize(std::accumulate(scaled.cbegin(), scaled.cend(), std::int64_t{0}));
+        temp_bytes = even.size() * sizeof(int) + scaled.size() * sizeof(std::int64_t);
+    });
+    state.counters["temp_bytes"] = static_cast<double>(temp_bytes);
+}
+STL_BENCHMARK(BM_staged_filter_transform_reduce);
+
+static void BM_pipeline_filter_transform_reduce(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(v | std::views::filter(kIsEven) | std::views::transform(kScale) | pipeline::reduce(std::int64_t{0}));
+    });
+    state.counters["temp_bytes"] = 0;
+}
+STL_BENCHMARK(BM_pipeline_filter_transform_reduce);
+
+static void BM_parallel_pipeline_filter_transform_reduce(benchmark::State& state) {
+    const auto v = input(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    const auto stages = std::views::filter(kIsEven) | std::views::transform(kScale);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(pipeline::parallel_reduce(v, stages, std::int64_t{0})); });
+    state.counters["temp_bytes"] = 0;
+}
+STL_PARALLEL_BENCHMARK(BM_parallel_pipeline_filter_transform_reduce);
+
+// The same with a running total, collected into a vector.
+static void BM_staged_filter_transform_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::size_t temp_bytes = 0;
+    run<int>(state, v.size(), [&]{
+        std::vector<int> even;
+        std::copy_if(v.cbegin(), v.cend(), std::back_inserter(even), kIsEven);
+        std::vector<std::int64_t> scaled;
+        std::transform(even.cbegin(), even.cend(), std::back_inserter(scaled), kScale);
+        std::vector<std::int64_t> totals(scaled.size());
+        std::inclusive_scan(scaled.cbegin(), scaled.cend(), totals.begin());
+        benchmark::DoNotOptimize(totals.data());
+        temp_bytes = even.size() * sizeof(int) + scaled.size() * sizeof(std::int64_t);
+    });
+    state.counters["temp_bytes"] = static_cast<double>(temp_bytes);
+}
+STL_BENCHMARK(BM_staged_filter_transform_scan);
+
+static void BM_pipeline_filter_transform_scan(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        const auto totals = v | std::views::filter(kIsEven) | std::views::transform(kScale) | pipeline::scan() | pipeline::to_vector;
+        benchmark::DoNotOptimize(totals.data());
+    });
+    state.counters["temp_bytes"] = 0;
+}
+STL_BENCHMARK(BM_pipeline_filter_transform_scan);
+
+static void BM_replace(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::replace(work.begin(), work.end(), 3, 42); });
+}
+STL_BENCHMARK(BM_replace);
+
+static void BM_replace_if(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isOdd = [](int i)->bool{ return i % 2 != 0; };
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::replace_if(work.begin(), work.end(), isOdd, 42); });
+}
+STL_BENCHMARK(BM_replace_if);
+
+static void BM_swap(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (std::size_t i = 0; i + 1 < work.size(); i += 2) std::swap(work[i], work[i + 1]);
+    });
+}
+STL_BENCHMARK(BM_swap);
+
+static void BM_swap_ranges(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> other(v.size());
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::swap_ranges(work.begin(), work.end(), other.begin()); });
+}
+STL_BENCHMARK(BM_swap_ranges);
+
+static void BM_iter_swap(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (auto it = work.begin(); work.end() - it > 1; it += 2) std::iter_swap(it, it + 1);
+    });
+}
+STL_BENCHMARK(BM_iter_swap);
+
+static void BM_reverse(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::reverse(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_reverse);
+
+static void BM_rotate(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::rotate(work.begin(), work.begin() + work.size() / 3, work.end()); });
+}
+STL_BENCHMARK(BM_rotate);
+
+static void BM_shuffle(benchmark::State& state) {
+    const auto v = input(state);
+    std::mt19937 gen(42);
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::shuffle(work.begin(), work.end(), gen); });
+}
+STL_BENCHMARK(BM_shuffle);
+
+static void BM_shuffle_xoshiro(benchmark::State& state) {
+    const auto v = input(state);
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::shuffle(work.begin(), work.end(), gen); });
+}
+STL_BENCHMARK(BM_shuffle_xoshiro);
+
+static void BM_merge_shuffle(benchmark::State& state) {
+    const auto v = input(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    std::uint64_t seed = 42;
+    run_on_copy(state, v, [&](std::vector<int>& work){ stl_examples::sampling::shuffle(work.begin(), work.end(), seed++); });
+}
+STL_PARALLEL_BENCHMARK(BM_merge_shuffle);
+
+static void BM_sample(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(v.size() / 2);
+    std::mt19937 gen(42);
+    run<int>(state, v.size(), [&]{ std::sample(v.cbegin(), v.cend(), destination.begin(), destination.size(), gen); });
+}
+STL_BENCHMARK(BM_sample);
+
+static void BM_reservoir_sample(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(v.size() / 2);
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    run<int>(state, v.size(), [&]{
+        stl_examples::sampling::reservoir_sample(v.cbegin(), v.cend(), destination.begin(), destination.size(), gen);
+    });
+}
+STL_BENCHMARK(BM_reservoir_sample);
+
+// A small sample of a large input, the usual case when sampling, from a stream
+// that can only be read forward.
+static void BM_sample_small(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(kQueries);
+    std::mt19937 gen(42);
+    run<int>(state, v.size(), [&]{ std::sample(v.cbegin(), v.cend(), destination.begin(), destination.size(), gen); });
+}
+STL_BENCHMARK(BM_sample_small);
+
+static void BM_reservoir_sample_small(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(kQueries);
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    run<int>(state, v.size(), [&]{
+        stl_examples::sampling::reservoir_sample(v.cbegin(), v.cend(), destination.begin(), destination.size(), gen);
+    });
+}
+STL_BENCHMARK(BM_reservoir_sample_small);
+
+static void BM_weighted_sample(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> destination(kQueries);
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    run<int>(state, v.size(), [&]{
+        stl_examples::sampling::weighted_sample(v.cbegin(), v.cend(), v.cbegin(), destination.begin(), destination.size(), gen);
+    });
+}
+STL_BENCHMARK(BM_weighted_sample);
+
+// n draws with replacement, with weights v.
+static void BM_discrete_distribution(benchmark::State& state) {
+    const auto v = input(state);
+    std::discrete_distribution<std::size_t> distribution(v.cbegin(), v.cend());
+    std::mt19937 gen(42);
+    run<int>(state, v.size(), [&]{
+        for (std::size_t i = 0; i < v.size(); ++i) benchmark::DoNotOptimize(distribution(gen));
+    });
+}
+STL_BENCHMARK(BM_discrete_distribution);
+
+static void BM_alias_table(benchmark::State& state) {
+    const auto v = input(state);
+    const stl_examples::sampling::AliasTable table(v.cbegin(), v.cend());
+    stl_examples::sampling::Xoshiro256pp gen(42);
+    run<int>(state, v.size(), [&]{
+        for (std::size_t i = 0; i < v.size(); ++i) benchmark::DoNotOptimize(table(gen));
+    });
+}
+STL_BENCHMARK(BM_alias_table);
+
+static void BM_unique(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ work.erase(std::unique(work.begin(), work.end()), work.end()); });
+}
+STL_BENCHMARK(BM_unique);
+
+static void BM_simd_unique(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ work.erase(simd::unique(work.begin(), work.end()), work.end()); });
+}
+STL_BENCHMARK(BM_simd_unique);
+
+// 64-bit IDs, as deduplicated in batches; 'sorted' is the usual case.
+static void BM_unique_uint64(benchmark::State& state) {
+    const auto v = input<std::uint64_t>(state);
+    run_on_copy(state, v, [](std::vector<std::uint64_t>& work){ work.erase(std::unique(work.begin(), work.end()), work.end()); });
+}
+STL_BENCHMARK(BM_unique_uint64);
+
+static void BM_simd_unique_uint64(benchmark::State& state) {
+    const auto v = input<std::uint64_t>(state);
+    run_on_copy(state, v, [](std::vector<std::uint64_t>& work){ work.erase(simd::unique(work.begin(), work.end()), work.end()); });
+}
+STL_BENCHMARK(BM_simd_unique_uint64);
+
+// The run lengths reuse their vector, as from one batch to the next.
+static void BM_simd_unique_erase(benchmark::State& state) {
+    const auto v = input<std::uint64_t>(state);
+    std::vector<std::size_t> runs;
+    run_on_copy(state, v, [&](std::vector<std::uint64_t>& work){
+        simd::unique_erase(work, runs);
+        benchmark::DoNotOptimize(runs.data());
+    });
+}
+STL_BENCHMARK(BM_simd_unique_erase);
+
+// Partitioning operations.
+static void BM_is_partitioned(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const int middle = v.empty() ? 0 : v[v.size() / 2];
+    run<int>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::is_partitioned(v.cbegin(), v.cend(), [middle](int i){ return i < middle; }));
+    });
+}
+STL_BENCHMARK(BM_is_partitioned);
+
+static void BM_partition(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::partition(work.begin(), work.end(), isEven); });
+}
+STL_BENCHMARK(BM_partition);
+
+static void BM_simd_partition(benchmark::State& state) {
+    const auto v = input(state);
+    const auto pred = lower_half(state);
+    run_on_copy(state, v, [&](std::vector<int>& work){ simd::partition(work.begin(), work.end(), pred); });
+}
+STL_BENCHMARK(BM_simd_partition);
+
+static void BM_stable_partition(benchmark::State& state) {
+    const auto v = input(state);
+    const auto isEven = [](int i)->bool{ return i % 2 == 0; };
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::stable_partition(work.begin(), work.end(), isEven); });
+}
+STL_BENCHMARK(BM_stable_partition);
+
+static void BM_simd_stable_partition(benchmark::State& state) {
+    const auto v = input(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    const auto pred = lower_half(state);
+    run_on_copy(state, v, [&](std::vector<int>& work){ simd::stable_partition(work.begin(), work.end(), pred); });
+}
+STL_PARALLEL_BENCHMARK(BM_simd_stable_partition);
+
+static void BM_partition_point(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) {
+            benchmark::DoNotOptimize(std::partition_point(v.cbegin(), v.cend(), [key](int i){ return i < key; }));
+        }
+    });
+}
+STL_BENCHMARK(BM_partition_point);
+
+static void BM_simd_partition_point(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) {
+            benchmark::DoNotOptimize(simd::partition_point(v.cbegin(), v.cend(), [key](int i){ return i < key; }));
+        }
+    });
+}
+STL_BENCHMARK(BM_simd_partition_point);
+
+// Sorting operations.
+static void BM_is_sorted(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::is_sorted(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_is_sorted);
+
+static void BM_sort(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_sort);
+
+static void BM_radix_sort(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ stl_examples::radix_sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_radix_sort);
+
+static void BM_sort_int64(benchmark::State& state) {
+    const auto v = input<std::int64_t>(state);
+    run_on_copy(state, v, [](std::vector<std::int64_t>& work){ std::sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_sort_int64);
+
+static void BM_radix_sort_int64(benchmark::State& state) {
+    const auto v = input<std::int64_t>(state);
+    run_on_copy(state, v, [](std::vector<std::int64_t>& work){ stl_examples::radix_sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_radix_sort_int64);
+
+static void BM_sort_float(benchmark::State& state) {
+    const auto v = input<float>(state);
+    run_on_copy(state, v, [](std::vector<float>& work){ std::sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_sort_float);
+
+static void BM_radix_sort_float(benchmark::State& state) {
+    const auto v = input<float>(state);
+    run_on_copy(state, v, [](std::vector<float>& work){ stl_examples::radix_sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_radix_sort_float);
+
+static void BM_is_sorted_until(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::is_sorted_until(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_is_sorted_until);
+
+static void BM_partial_sort(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        std::partial_sort(work.begin(), work.begin() + work.size() / 100, work.end());
+    });
+}
+STL_BENCHMARK(BM_partial_sort);
+
+// The top 100 of n, the usual k << n case: in place, and copied out of an input
+// left untouched.
+constexpr std::size_t kTopK = 100;
+
+static void BM_partial_sort_top100(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        std::partial_sort(work.begin(), work.begin() + std::min(kTopK, work.size()), work.end(), std::greater<>());
+    });
+}
+STL_BENCHMARK(BM_partial_sort_top100);
+
+static void BM_selection_partial_sort_top100(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        stl_examples::selection::partial_sort(work.begin(), work.begin() + std::min(kTopK, work.size()), work.end(), std::greater<>());
+    });
+}
+STL_BENCHMARK(BM_selection_partial_sort_top100);
+
+template<class T>
+void partial_sort_copy_top100(benchmark::State& state) {
+    const auto v = input<T>(state);
+    std::vector<T> top(kTopK);
+    run<T>(state, v.size(), [&]{ std::partial_sort_copy(v.cbegin(), v.cend(), top.begin(), top.end(), std::greater<>()); });
+}
+
+template<class T>
+void top_k_top100(benchmark::State& state) {
+    const auto v = input<T>(state);
+    std::vector<T> top(kTopK);
+    run<T>(state, v.size(), [&]{ stl_examples::selection::top_k(v.cbegin(), v.cend(), top.begin(), top.end(), std::greater<>()); });
+}
+
+static void BM_partial_sort_copy_top100(benchmark::State& state) { partial_sort_copy_top100<int>(state); }
+STL_BENCHMARK(BM_partial_sort_copy_top100);
+static void BM_top_k_top100(benchmark::State& state) { top_k_top100<int>(state); }
+STL_BENCHMARK(BM_top_k_top100);
+static void BM_partial_sort_copy_top100_double(benchmark::State& state) { partial_sort_copy_top100<double>(state); }
+STL_BENCHMARK(BM_partial_sort_copy_top100_double);
+static void BM_top_k_top100_double(benchmark::State& state) { top_k_top100<double>(state); }
+STL_BENCHMARK(BM_top_k_top100_double);
+
+// The record sorted in TEST(stable_sort): 4 bytes of key and a std::string payload.
+struct Person {
+    int age;
+    std::string name;
+
+    bool operator<(const Person& other) const { return age < other.age; }
+};
+
+// The comparisons are counted in report mode; see instrumentation.h.
+static void BM_sort_people(benchmark::State& state) {
+    const auto ages = input(state);
+    std::vector<Person> v(ages.size());
+    std::transform(ages.cbegin(), ages.cend(), v.begin(), [](int age){ return Person{age, "Name " + std::to_string(age)}; });
+    run_on_copy(state, v, [](std::vector<Person>& work){ std::sort(work.begin(), work.end(), instrument::CountingCompare()); });
+}
+STL_BENCHMARK(BM_sort_people);
+
+static void BM_stable_sort(benchmark::State& state) {
+    const auto ages = input(state);
+    std::vector<Person> v(ages.size());
+    std::transform(ages.cbegin(), ages.cend(), v.begin(), [](int age){ return Person{age, "Name " + std::to_string(age)}; });
+    run_on_copy(state, v, [](std::vector<Person>& work){ std::stable_sort(work.begin(), work.end(), instrument::CountingCompare()); });
+}
+STL_BENCHMARK(BM_stable_sort);
+
+static void BM_stable_sort_by_key(benchmark::State& state) {
+    const auto ages = input(state);
+    std::vector<Person> v(ages.size());
+    std::transform(ages.cbegin(), ages.cend(), v.begin(), [](int age){ return Person{age, "Name " + std::to_string(age)}; });
+    run_on_copy(state, v, [](std::vector<Person>& work){ stl_examples::stable_sort_by_key(work.begin(), work.end(), &Person::age); });
+}
+STL_BENCHMARK(BM_stable_sort_by_key);
+
+// Records with a 4-byte key and a 40-byte payload, up to 50M of them: too many
+// to copy for each iteration, so only their keys are reset, untimed, instead.
+struct HeavyRecord {
+    int key;
+    char payload[40];
+};
+
+template<class Sort>
+void run_heavy_sort(benchmark::State& state, Sort sort) {
+    const auto n = static_cast<std::size_t>(std::min(state.range(0), bench::max_size()));
+    const auto keys = bench::make_input<int>(n, bench::Distribution::random);
+    std::vector<HeavyRecord> records(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) records[i].key = keys[i];
+        const auto start = std::chrono::steady_clock::now();
+        sort(records);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(elapsed.count());
+        benchmark::ClobberMemory();
+    }
+    set_throughput<HeavyRecord>(state, static_cast<std::int64_t>(n));
+}
+
+static void BM_stable_sort_heavy(benchmark::State& state) {
+    run_heavy_sort(state, [](std::vector<HeavyRecord>& records){
+        std::stable_sort(records.begin(), records.end(), [](const HeavyRecord& a, const HeavyRecord& b){ return a.key < b.key; });
+    });
+}
+BENCHMARK(BM_stable_sort_heavy)->ArgName("n")->Arg(1 << 20)->Arg(1 << 23)->Arg(50'000'000)
+                               ->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_stable_sort_by_key_heavy(benchmark::State& state) {
+    run_heavy_sort(state, [](std::vector<HeavyRecord>& records){
+        stl_examples::stable_sort_by_key(records.begin(), records.end(), &HeavyRecord::key);
+    });
+}
+BENCHMARK(BM_stable_sort_by_key_heavy)->ArgName("n")->Arg(1 << 20)->Arg(1 << 23)->Arg(50'000'000)
+                                      ->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_nth_element(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        std::nth_element(work.begin(), work.begin() + work.size() / 2, work.end(), std::greater<int>());
+    });
+}
+STL_BENCHMARK(BM_nth_element);
+
+static void BM_floyd_rivest_nth_element(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        stl_examples::selection::nth_element(work.begin(), work.begin() + work.size() / 2, work.end(), std::greater<int>());
+    });
+}
+STL_BENCHMARK(BM_floyd_rivest_nth_element);
+
+// Binary search operations (on sorted ranges).
+static void BM_lower_bound(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(std::lower_bound(v.cbegin(), v.cend(), key));
+    });
+}
+STL_BENCHMARK(BM_lower_bound);
+
+static void BM_upper_bound(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(std::upper_bound(v.cbegin(), v.cend(), key));
+    });
+}
+STL_BENCHMARK(BM_upper_bound);
+
+static void BM_binary_search(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(std::binary_search(v.cbegin(), v.cend(), key));
+    });
+}
+STL_BENCHMARK(BM_binary_search);
+
+static void BM_equal_range(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(std::equal_range(v.cbegin(), v.cend(), key));
+    });
+}
+STL_BENCHMARK(BM_equal_range);
+
+// The same searches on an EytzingerIndex of the input (built outside the timing).
+// The largest sizes show the difference: the index prefetches the next levels,
+// while std::lower_bound waits for a cache miss at every level.
+static void BM_eytzinger_lower_bound(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const stl_examples::EytzingerIndex index(v.cbegin(), v.cend());
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(index.lower_bound(key));
+    });
+}
+STL_BENCHMARK(BM_eytzinger_lower_bound);
+
+static void BM_eytzinger_upper_bound(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const stl_examples::EytzingerIndex index(v.cbegin(), v.cend());
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(index.upper_bound(key));
+    });
+}
+STL_BENCHMARK(BM_eytzinger_upper_bound);
+
+static void BM_eytzinger_binary_search(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const stl_examples::EytzingerIndex index(v.cbegin(), v.cend());
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(index.binary_search(key));
+    });
+}
+STL_BENCHMARK(BM_eytzinger_binary_search);
+
+static void BM_eytzinger_equal_range(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const stl_examples::EytzingerIndex index(v.cbegin(), v.cend());
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(index.equal_range(key));
+    });
+}
+STL_BENCHMARK(BM_eytzinger_equal_range);
+
+// Other operations (on sorted ranges).
+static void BM_merge(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> v1(v.cbegin(), v.cbegin() + v.size() / 2);
+    std::vector<int> v2(v.cbegin() + v.size() / 2, v.cend());
+    std::sort(v1.begin(), v1.end());
+    std::sort(v2.begin(), v2.end());
+    std::vector<int> destination(v.size());
+    run<int>(state, v.size(), [&]{ std::merge(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin()); });
+}
+STL_BENCHMARK(BM_merge);
+
+// The merge_sort example from TEST(inplace_merge).
+template<class Iter>
+void merge_sort(Iter first, Iter last) {
+    if (last - first > 1) {
+        const Iter middle = first + (last - first) / 2;
+        merge_sort(first, middle);
+        merge_sort(middle, last);
+        std::inplace_merge(first, middle, last, instrument::CountingCompare());
+    }
+}
+
+static void BM_inplace_merge(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ merge_sort(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_inplace_merge);
+
+static void BM_parallel_merge_sort(benchmark::State& state) {
+    const auto v = input(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    run_on_copy(state, v, [](std::vector<int>& work){ stl_examples::parallel_merge_sort(work.begin(), work.end()); });
+}
+STL_PARALLEL_BENCHMARK(BM_parallel_merge_sort);
+
+// external_sort of a file of n 64-byte records through a memory budget of
+// 'budget' MiB, in the system's temporary directory. bytes_per_second is the
+// end-to-end sorting rate; the runs and merge passes are reported as counters.
+struct FileRecord {
+    std::uint64_t key;
+    char payload[56];
+};
+
+static void BM_external_sort(benchmark::State& state) {
+    namespace fs = std::filesystem;
+    const std::int64_t n = std::min(state.range(0), bench::max_size());
+    const fs::path input = fs::temp_directory_path() / "stl_examples_bench_input.bin";
+    const fs::path output = fs::temp_directory_path() / "stl_examples_bench_output.bin";
+    {
+        const auto keys = bench::make_input<std::uint64_t>(static_cast<std::size_t>(n), bench::Distribution::random);
+        std::vector<FileRecord> records(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) records[i].key = keys[i];
+        std::FILE* file = std::fopen(input.c_str(), "wb");
+        std::fwrite(records.data(), sizeof(FileRecord), records.size(), file);
+        std::fclose(file);
+    }
+    stl_examples::ExternalSortOptions options;
+    options.memory_budget = static_cast<std::size_t>(state.range(1)) << 20;
+    const auto by_key = [](const FileRecord& a, const FileRecord& b){ return a.key < b.key; };
+    stl_examples::ExternalSortStats stats;
+    run<FileRecord>(state, n, [&]{ stats = stl_examples::external_sort<FileRecord>(input, output, options, by_key); });
+    state.counters["runs"] = static_cast<double>(stats.runs);
+    state.counters["merge_passes"] = static_cast<double>(stats.merge_passes);
+    fs::remove(input);
+    fs::remove(output);
+}
+BENCHMARK(BM_external_sort)->ArgNames({"n", "budget_mib"})->Args({1 << 20, 16})->Args({1 << 22, 16})->Args({1 << 22, 512})
+                           ->Args({1 << 24, 64})->UseManualTime()->Unit(benchmark::kMillisecond);
+
+// Set operations (on sorted ranges).
+// Each takes the two sorted halves of the input.
+template<class T>
+std::pair<std::vector<T>, std::vector<T>> sorted_halves(benchmark::State& state) {
+    const auto v = input<T>(state);
+    std::vector<T> v1(v.cbegin(), v.cbegin() + v.size() / 2);
+    std::vector<T> v2(v.cbegin() + v.size() / 2, v.cend());
+    std::sort(v1.begin(), v1.end());
+    std::sort(v2.begin(), v2.end());
+    return {std::move(v1), std::move(v2)};
+}
+
+static void BM_includes(benchmark::State& state) {
+    const auto v = sorted_input<char>(state);
+    // Every other element, so the whole range is walked.
+    std::vector<char> sub_v;
+    for (std::size_t i = 0; i < v.size(); i += 2) sub_v.push_back(v[i]);
+    run<char>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::includes(v.cbegin(), v.cend(), sub_v.cbegin(), sub_v.cend()));
+    });
+}
+STL_BENCHMARK(BM_includes);
+
+static void BM_set_difference(benchmark::State& state) {
+    const auto [v1, v2] = sorted_halves<char>(state);
+    std::vector<char> destination(v1.size());
+    run<char>(state, v1.size() + v2.size(), [&]{
+        std::set_difference(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_difference);
+
+static void BM_set_intersection(benchmark::State& state) {
+    const auto [v1, v2] = sorted_halves<int>(state);
+    std::vector<int> destination(v1.size());
+    run<int>(state, v1.size() + v2.size(), [&]{
+        std::set_intersection(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_intersection);
+
+static void BM_set_symmetric_difference(benchmark::State& state) {
+    const auto [v1, v2] = sorted_halves<int>(state);
+    std::vector<int> destination(v1.size() + v2.size());
+    run<int>(state, v1.size() + v2.size(), [&]{
+        std::set_symmetric_difference(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_symmetric_difference);
+
+static void BM_set_union(benchmark::State& state) {
+    const auto [v1, v2] = sorted_halves<int>(state);
+    std::vector<int> destination(v1.size() + v2.size());
+    run<int>(state, v1.size() + v2.size(), [&]{
+        std::set_union(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_union);
+
+static void BM_adaptive_set_intersection(benchmark::State& state) {
+    const auto [v1, v2] = sorted_halves<int>(state);
+    std::vector<int> destination(v1.size());
+    run<int>(state, v1.size() + v2.size(), [&]{
+        stl_examples::adaptive::set_intersection(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_adaptive_set_intersection);
+
+// A long posting list of n ids, and one 1000 times shorter: every 1000th id,
+// bumped by one for every other, so that about half of them are in the long list.
+std::pair<std::vector<int>, std::vector<int>> posting_lists(benchmark::State& state) {
+    auto long_list = sorted_input<int>(state);
+    std::vector<int> short_list;
+    for (std::size_t i = 0; i < long_list.size(); i += 1000) short_list.push_back(long_list[i] + static_cast<int>(i / 1000 % 2));
+    std::sort(short_list.begin(), short_list.end());
+    return {std::move(short_list), std::move(long_list)};
+}
+
+static void BM_set_intersection_skewed(benchmark::State& state) {
+    const auto [short_list, long_list] = posting_lists(state);
+    std::vector<int> destination(short_list.size());
+    run<int>(state, long_list.size(), [&]{
+        std::set_intersection(short_list.cbegin(), short_list.cend(), long_list.cbegin(), long_list.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_intersection_skewed);
+
+static void BM_adaptive_set_intersection_skewed(benchmark::State& state) {
+    const auto [short_list, long_list] = posting_lists(state);
+    std::vector<int> destination(short_list.size());
+    run<int>(state, long_list.size(), [&]{
+        stl_examples::adaptive::set_intersection(short_list.cbegin(), short_list.cend(), long_list.cbegin(), long_list.cend(),
+                                                 destination.begin());
+    });
+}
+STL_BENCHMARK(BM_adaptive_set_intersection_skewed);
+
+static void BM_set_union_skewed(benchmark::State& state) {
+    const auto [short_list, long_list] = posting_lists(state);
+    std::vector<int> destination(short_list.size() + long_list.size());
+    run<int>(state, long_list.size(), [&]{
+        std::set_union(short_list.cbegin(), short_list.cend(), long_list.cbegin(), long_list.cend(), destination.begin());
+    });
+}
+STL_BENCHMARK(BM_set_union_skewed);
+
+static void BM_adaptive_set_union_skewed(benchmark::State& state) {
+    const auto [short_list, long_list] = posting_lists(state);
+    std::vector<int> destination(short_list.size() + long_list.size());
+    run<int>(state, long_list.size(), [&]{
+        stl_examples::adaptive::set_union(short_list.cbegin(), short_list.cend(), long_list.cbegin(), long_list.cend(),
+                                          destination.begin());
+    });
+}
+STL_BENCHMARK(BM_adaptive_set_union_skewed);
+
+// Heap operations.
+static void BM_is_heap(benchmark::State& state) {
+    auto v = input(state);
+    std::make_heap(v.begin(), v.end());
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::is_heap(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_is_heap);
+
+static void BM_is_heap_until(benchmark::State& state) {
+    auto v = input(state);
+    std::make_heap(v.begin(), v.end());
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::is_heap_until(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_is_heap_until);
+
+static void BM_make_heap(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::make_heap(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_make_heap);
+
+static void BM_push_heap(benchmark::State& state) {
+    // Builds the heap one push_heap() at a time.
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (auto last = work.begin() + 1; last <= work.end(); ++last) std::push_heap(work.begin(), last);
+    });
+}
+STL_BENCHMARK(BM_push_heap);
+
+static void BM_pop_heap(benchmark::State& state) {
+    // Pops every element off the heap, one pop_heap() at a time.
+    auto v = input(state);
+    std::make_heap(v.begin(), v.end());
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (auto last = work.end(); last - work.begin() > 1; --last) std::pop_heap(work.begin(), last);
+    });
+}
+STL_BENCHMARK(BM_pop_heap);
+
+static void BM_sort_heap(benchmark::State& state) {
+    auto v = input(state);
+    std::make_heap(v.begin(), v.end());
+    run_on_copy(state, v, [](std::vector<int>& work){ std::sort_heap(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_sort_heap);
+
+// The same heap operations with D children per node, see dary_heap.h.
+template<std::size_t D>
+static void BM_dary_push_heap(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (auto last = work.begin() + 1; last <= work.end(); ++last) stl_examples::dary::push_heap<D>(work.begin(), last);
+    });
+}
+BENCHMARK_TEMPLATE(BM_dary_push_heap, 4)->Apply(SizesAndDistributions)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_dary_push_heap, 8)->Apply(SizesAndDistributions)->UseManualTime();
+
+template<std::size_t D>
+static void BM_dary_pop_heap(benchmark::State& state) {
+    auto v = input(state);
+    stl_examples::dary::make_heap<D>(v.begin(), v.end());
+    run_on_copy(state, v, [](std::vector<int>& work){
+        for (auto last = work.end(); last - work.begin() > 1; --last) stl_examples::dary::pop_heap<D>(work.begin(), last);
+    });
+}
+BENCHMARK_TEMPLATE(BM_dary_pop_heap, 4)->Apply(SizesAndDistributions)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_dary_pop_heap, 8)->Apply(SizesAndDistributions)->UseManualTime();
+
+// A timer scheduler: a queue of 10M pending deadlines, from which each step pops
+// the earliest and pushes a new one a random delay later (the "hold" model).
+constexpr std::int64_t kSchedulerSize = 10'000'000;
+constexpr std::int64_t kSchedulerSteps = 1 << 20;
+
+std::vector<std::int64_t> scheduler_deadlines() {
+    std::vector<std::int64_t> deadlines(std::min(kSchedulerSize, bench::max_size()));
+    std::mt19937_64 gen(7);
+    for (auto& deadline : deadlines) deadline = static_cast<std::int64_t>(gen() % (1 << 30));
+    return deadlines;
+}
+
+template<class Push, class Pop>
+void run_scheduler(benchmark::State& state, std::vector<std::int64_t>& heap, Push push, Pop pop) {
+    std::mt19937_64 gen(11);
+    std::vector<std::int64_t> delays(kSchedulerSteps);
+    for (auto& delay : delays) delay = static_cast<std::int64_t>(gen() % (1 << 30));
+    run<std::int64_t>(state, kSchedulerSteps, [&]{
+        for (const std::int64_t delay : delays) {
+            pop(heap);
+            const std::int64_t now = heap.back();
+            heap.back() = now + delay;
+            push(heap);
+        }
+    });
+}
+
+static void BM_scheduler_std_heap(benchmark::State& state) {
+    auto heap = scheduler_deadlines();
+    std::make_heap(heap.begin(), heap.end(), std::greater<>());
+    run_scheduler(state, heap,
+                  [](auto& h){ std::push_heap(h.begin(), h.end(), std::greater<>()); },
+                  [](auto& h){ std::pop_heap(h.begin(), h.end(), std::greater<>()); });
+}
+BENCHMARK(BM_scheduler_std_heap)->UseManualTime();
+
+template<std::size_t D>
+static void BM_scheduler_dary_heap(benchmark::State& state) {
+    namespace dary = stl_examples::dary;
+    auto heap = scheduler_deadlines();
+    dary::make_heap<D>(heap.begin(), heap.end(), std::greater<>());
+    run_scheduler(state, heap,
+                  [](auto& h){ dary::push_heap<D>(h.begin(), h.end(), std::greater<>()); },
+                  [](auto& h){ dary::pop_heap<D>(h.begin(), h.end(), std::greater<>()); });
+}
+BENCHMARK_TEMPLATE(BM_scheduler_dary_heap, 4)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_scheduler_dary_heap, 8)->UseManualTime();
+
+// The same workload where each timer has an id, so it can be rescheduled in
+// place: each step moves the earliest timer later with update(), and a random
+// timer earlier with decrease_key().
+static void BM_scheduler_indexed_priority_queue(benchmark::State& state) {
+    const auto deadlines = scheduler_deadlines();
+    stl_examples::IndexedPriorityQueue<std::int64_t> queue(deadlines.size());
+    for (std::size_t id = 0; id < deadlines.size(); ++id) queue.push(id, deadlines[id]);
+    std::mt19937_64 gen(11);
+    std::vector<std::int64_t> delays(kSchedulerSteps);
+    for (auto& delay : delays) delay = static_cast<std::int64_t>(gen() % (1 << 30));
+    run<std::int64_t>(state, kSchedulerSteps, [&]{
+        for (const std::int64_t delay : delays) {
+            queue.update(queue.top(), queue.top_priority() + delay);
+            const std::size_t id = static_cast<std::size_t>(delay) % deadlines.size();
+            queue.decrease_key(id, queue.priority(id) - delay % 1024);
+        }
+    });
+}
+BENCHMARK(BM_scheduler_indexed_priority_queue)->UseManualTime();
+
+// Minimum, maximum operations.
+static void BM_max(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        int result = 0;
+        for (const int i : v) result = std::max(result, i);
+        benchmark::DoNotOptimize(result);
+    });
+}
+STL_BENCHMARK(BM_max);
+
+static void BM_max_element(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::max_element(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_max_element);
+
+static void BM_simd_max_element(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::max_element(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_simd_max_element);
+
+static void BM_min(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        int result = 0;
+        for (const int i : v) result = std::min(result, i);
+        benchmark::DoNotOptimize(result);
+    });
+}
+STL_BENCHMARK(BM_min);
+
+static void BM_min_element(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::min_element(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_min_element);
+
+static void BM_simd_min_element(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::min_element(v.cbegin(), v.cend())); });
+}
+STL_BENCHMARK(BM_simd_min_element);
+
+static void BM_minmax(benchmark::State& state) {
+    // std::minmax of each adjacent pair.
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        long long spread = 0;
+        for (std::size_t i = 0; i + 1 < v.size(); i += 2) {
+            const auto bounds = std::minmax(v[i], v[i + 1]);
+            spread += bounds.second - bounds.first;
+        }
+        benchmark::DoNotOptimize(spread);
+    });
+}
+STL_BENCHMARK(BM_minmax);
+
+// The extrema and the clamp of telemetry: ints, floats, and doubles, up to 100M+ samples.
+template<class T>
+void minmax_element_of(benchmark::State& state) {
+    const auto v = input<T>(state);
+    run<T>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::minmax_element(v.cbegin(), v.cend())); });
+}
+
+template<class T>
+void simd_minmax_element_of(benchmark::State& state) {
+    const auto v = input<T>(state);
+    run<T>(state, v.size(), [&]{ benchmark::DoNotOptimize(simd::minmax_element(v.cbegin(), v.cend())); });
+}
+
+static void BM_minmax_element(benchmark::State& state) { minmax_element_of<int>(state); }
+STL_BENCHMARK(BM_minmax_element);
+static void BM_simd_minmax_element(benchmark::State& state) { simd_minmax_element_of<int>(state); }
+STL_BENCHMARK(BM_simd_minmax_element);
+static void BM_minmax_element_float(benchmark::State& state) { minmax_element_of<float>(state); }
+STL_BENCHMARK(BM_minmax_element_float);
+static void BM_simd_minmax_element_float(benchmark::State& state) { simd_minmax_element_of<float>(state); }
+STL_BENCHMARK(BM_simd_minmax_element_float);
+static void BM_minmax_element_double(benchmark::State& state) { minmax_element_of<double>(state); }
+STL_BENCHMARK(BM_minmax_element_double);
+static void BM_simd_minmax_element_double(benchmark::State& state) { simd_minmax_element_of<double>(state); }
+STL_BENCHMARK(BM_simd_minmax_element_double);
+
+// Clamps to [1, n / 2], in place.
+template<class T>
+void clamp_of(benchmark::State& state) {
+    const auto v = input<T>(state);
+    const T max_bound = static_cast<T>(v.size() / 2);
+    run_on_copy(state, v, [max_bound](std::vector<T>& work){
+        for (T& x : work) x = std::clamp(x, T{1}, max_bound);
+    });
+}
+
+template<class T>
+void simd_clamp_of(benchmark::State& state) {
+    const auto v = input<T>(state);
+    const T max_bound = static_cast<T>(v.size() / 2);
+    run_on_copy(state, v, [max_bound](std::vector<T>& work){ simd::clamp(work.begin(), work.end(), T{1}, max_bound); });
+}
+
+static void BM_clamp(benchmark::State& state) { clamp_of<int>(state); }
+STL_BENCHMARK(BM_clamp);
+static void BM_simd_clamp(benchmark::State& state) { simd_clamp_of<int>(state); }
+STL_BENCHMARK(BM_simd_clamp);
+static void BM_clamp_float(benchmark::State& state) { clamp_of<float>(state); }
+STL_BENCHMARK(BM_clamp_float);
+static void BM_simd_clamp_float(benchmark::State& state) { simd_clamp_of<float>(state); }
+STL_BENCHMARK(BM_simd_clamp_float);
+static void BM_clamp_double(benchmark::State& state) { clamp_of<double>(state); }
+STL_BENCHMARK(BM_clamp_double);
+static void BM_simd_clamp_double(benchmark::State& state) { simd_clamp_of<double>(state); }
+STL_BENCHMARK(BM_simd_clamp_double);
+
+// Comparison operations.
+static void BM_equal(benchmark::State& state) {
+    const auto v1 = input(state);
+    const auto v2 = v1;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(std::equal(v1.cbegin(), v1.cend(), v2.cbegin())); });
+}
+STL_BENCHMARK(BM_equal);
+
+static void BM_simd_equal(benchmark::State& state) {
+    const auto v1 = input(state);
+    const auto v2 = v1;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(simd::equal(v1.cbegin(), v1.cend(), v2.cbegin())); });
+}
+STL_BENCHMARK(BM_simd_equal);
+
+static void BM_lexicographical_compare(benchmark::State& state) {
+    const auto v1 = input<char>(state);
+    const auto v2 = v1;
+    run<char>(state, v1.size(), [&]{
+        benchmark::DoNotOptimize(std::lexicographical_compare(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend()));
+    });
+}
+STL_BENCHMARK(BM_lexicographical_compare);
+
+static void BM_simd_lexicographical_compare(benchmark::State& state) {
+    const auto v1 = input<char>(state);
+    const auto v2 = v1;
+    run<char>(state, v1.size(), [&]{
+        benchmark::DoNotOptimize(simd::lexicographical_compare(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend()));
+    });
+}
+STL_BENCHMARK(BM_simd_lexicographical_compare);
+
+// Permutation operations.
+static void BM_is_permutation(benchmark::State& state) {
+    // std::is_permutation is quadratic in the worst case, so this is
+    // limited to the smaller sizes; see STL_EXAMPLES_BENCH_MAX_SIZE.
+    const auto v1 = input(state);
+    auto v2 = v1;
+    std::reverse(v2.begin(), v2.end());
+    const instrument::CountingCompare<std::equal_to<>> equal;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(std::is_permutation(v1.cbegin(), v1.cend(), v2.cbegin(), equal)); });
+}
+BENCHMARK(BM_is_permutation)->ArgNames({"n", "dist"})->ArgsProduct({
+    benchmark::CreateRange(1 << 10, std::min<std::int64_t>(1 << 16, bench::max_size()), /*multi=*/8),
+    benchmark::CreateDenseRange(0, bench::num_distributions - 1, 1),
+})->UseManualTime();
+
+static void BM_adaptive_is_permutation(benchmark::State& state) {
+    const auto v1 = input(state);
+    auto v2 = v1;
+    std::reverse(v2.begin(), v2.end());
+    run<int>(state, v1.size(), [&]{
+        benchmark::DoNotOptimize(stl_examples::adaptive::is_permutation(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend()));
+    });
+}
+STL_BENCHMARK(BM_adaptive_is_permutation);
+
+static void BM_next_permutation(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::next_permutation(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_next_permutation);
+
+static void BM_prev_permutation(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::prev_permutation(work.begin(), work.end()); });
+}
+STL_BENCHMARK(BM_prev_permutation);
+
+// Numeric operations.
+static void BM_iota(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_copy(state, v, [](std::vector<int>& work){ std::iota(work.begin(), work.end(), 1); });
+}
+STL_BENCHMARK(BM_iota);
+
+static void BM_accumulate(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::accumulate(v.cbegin(), v.cend(), 0LL)); });
+}
+STL_BENCHMARK(BM_accumulate);
+
+static void BM_inner_product(benchmark::State& state) {
+    const auto v1 = input(state);
+    const auto v2 = v1;
+    run<int>(state, v1.size(), [&]{ benchmark::DoNotOptimize(std::inner_product(v1.cbegin(), v1.cend(), v2.cbegin(), 0LL)); });
+}
+STL_BENCHMARK(BM_inner_product);
+
+static void BM_adjacent_difference(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<int> differences(v.size());
+    run<int>(state, v.size(), [&]{ std::adjacent_difference(v.cbegin(), v.cend(), differences.begin()); });
+}
+STL_BENCHMARK(BM_adjacent_difference);
+
+static void BM_partial_sum(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    run<int>(state, v.size(), [&]{ std::partial_sum(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>()); });
+}
+STL_BENCHMARK(BM_partial_sum);
+
+static void BM_exclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    run<int>(state, v.size(), [&]{ std::exclusive_scan(v.cbegin(), v.cend(), sums.begin(), 0LL); });
+}
+STL_BENCHMARK(BM_exclusive_scan);
+
+static void BM_inclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    run<int>(state, v.size(), [&]{ std::inclusive_scan(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>(), 0LL); });
+}
+STL_BENCHMARK(BM_inclusive_scan);
+
+static void BM_reduce(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::reduce(v.cbegin(), v.cend(), 0LL)); });
+}
+STL_BENCHMARK(BM_reduce);
+
+static void BM_transform_reduce(benchmark::State& state) {
+    const auto v = input(state);
+    run<int>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(std::transform_reduce(v.cbegin(), v.cend(), 0LL, std::plus<>(),
+                                                       [](int a)->long long{ return 1LL * a * a; }));
+    });
+}
+STL_BENCHMARK(BM_transform_reduce);
+
+// Floating-point sums: std::reduce, then the reductions of parallel_reduce.h at
+// each thread count, whose results do not depend on it.
+static void BM_reduce_double(benchmark::State& state) {
+    const auto v = input<double>(state);
+    run<double>(state, v.size(), [&]{ benchmark::DoNotOptimize(std::reduce(v.cbegin(), v.cend(), 0.0)); });
+}
+STL_BENCHMARK(BM_reduce_double);
+
+static void BM_deterministic_reduce(benchmark::State& state) {
+    const auto v = input<double>(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    run<double>(state, v.size(), [&]{ benchmark::DoNotOptimize(stl_examples::deterministic::reduce(v.cbegin(), v.cend(), 0.0)); });
+}
+STL_PARALLEL_BENCHMARK(BM_deterministic_reduce);
+
+static void BM_deterministic_reduce_kahan(benchmark::State& state) {
+    namespace deterministic = stl_examples::deterministic;
+    const auto v = input<double>(state);
+    const parallel::ThreadLimit limit(state.range(2));
+    run<double>(state, v.size(), [&]{
+        benchmark::DoNotOptimize(deterministic::reduce(v.cbegin(), v.cend(), 0.0, std::plus<>(), deterministic::Summation::kahan));
+    });
+}
+STL_PARALLEL_BENCHMARK(BM_deterministic_reduce_kahan);
+
+static void BM_inner_product_double(benchmark::State& state) {
+    const auto v1 = input<double>(state);
+    const auto v2 = v1;
+    run<double>(state, v1.size(), [&]{ benchmark::DoNotOptimize(std::inner_product(v1.cbegin(), v1.cend(), v2.cbegin(), 0.0)); });
+}
+STL_BENCHMARK(BM_inner_product_double);
+
+static void BM_deterministic_inner_product(benchmark::State& state) {
+    const auto v1 = input<double>(state);
+    const auto v2 = v1;
+    const parallel::ThreadLimit limit(state.range(2));
+    run<double>(state, v1.size(), [&]{
+        benchmark::DoNotOptimize(stl_examples::deterministic::inner_product(v1.cbegin(), v1.cend(), v2.cbegin(), 0.0));
+    });
+}
+STL_PARALLEL_BENCHMARK(BM_deterministic_inner_product);
+
+static void BM_transform_exclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    run<int>(state, v.size(), [&]{
+        std::transform_exclusive_scan(v.cbegin(), v.cend(), sums.begin(), 0LL, std::plus<long long>{},
+                                      [](int i)->long long{ return i * 2LL; });
+    });
+}
+STL_BENCHMARK(BM_transform_exclusive_scan);
+
+static void BM_transform_inclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    run<int>(state, v.size(), [&]{
+        std::transform_inclusive_scan(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>{},
+                                      [](int i)->long long{ return i * 2LL; });
+    });
+}
+STL_BENCHMARK(BM_transform_inclusive_scan);
+
+// The same scans with parallel_scan.h, at each thread count.
+static void BM_scan_partial_sum(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    const parallel::ThreadLimit limit(state.range(2));
+    run<int>(state, v.size(), [&]{ stl_examples::scan::partial_sum(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>()); });
+}
+STL_PARALLEL_BENCHMARK(BM_scan_partial_sum);
+
+static void BM_scan_exclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    const parallel::ThreadLimit limit(state.range(2));
+    run<int>(state, v.size(), [&]{ stl_examples::scan::exclusive_scan(v.cbegin(), v.cend(), sums.begin(), 0LL); });
+}
+STL_PARALLEL_BENCHMARK(BM_scan_exclusive_scan);
+
+static void BM_scan_inclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    const parallel::ThreadLimit limit(state.range(2));
+    run<int>(state, v.size(), [&]{ stl_examples::scan::inclusive_scan(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>(), 0LL); });
+}
+STL_PARALLEL_BENCHMARK(BM_scan_inclusive_scan);
+
+static void BM_scan_transform_exclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    const parallel::ThreadLimit limit(state.range(2));
+    run<int>(state, v.size(), [&]{
+        stl_examples::scan::transform_exclusive_scan(v.cbegin(), v.cend(), sums.begin(), 0LL, std::plus<long long>{},
+                                                     [](int i)->long long{ return i * 2LL; });
+    });
+}
+STL_PARALLEL_BENCHMARK(BM_scan_transform_exclusive_scan);
+
+static void BM_scan_transform_inclusive_scan(benchmark::State& state) {
+    const auto v = input(state);
+    std::vector<long long> sums(v.size());
+    const parallel::ThreadLimit limit(state.range(2));
+    run<int>(state, v.size(), [&]{
+        stl_examples::scan::transform_inclusive_scan(v.cbegin(), v.cend(), sums.begin(), std::plus<long long>{},
+                                                     [](int i)->long long{ return i * 2LL; });
+    });
+}
+STL_PARALLEL_BENCHMARK(BM_scan_transform_inclusive_scan);
+
+// C library.
+static void BM_qsort(benchmark::State& state) {
+    const auto v = input(state);
+    const auto compare = [](const void* a, const void* b)->int {
+        const int aa = *static_cast<const int*>(a);
+        const int bb = *static_cast<const int*>(b);
+        return (aa > bb) - (aa < bb);
+    };
+    run_on_copy(state, v, [&](std::vector<int>& work){ std::qsort(work.data(), work.size(), sizeof(int), compare); });
+}
+STL_BENCHMARK(BM_qsort);
+
+static void BM_bsearch(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const auto compare = [](const void* a, const void* b)->int {
+        const int aa = *static_cast<const int*>(a);
+        const int bb = *static_cast<const int*>(b);
+        return (aa > bb) - (aa < bb);
+    };
+    run<int>(state, kQueries, [&]{
+        for (const int& key : keys) benchmark::DoNotOptimize(std::bsearch(&key, v.data(), v.size(), sizeof(int), compare));
+    });
+}
+STL_BENCHMARK(BM_bsearch);
+
+static void BM_eytzinger_find(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    const stl_examples::EytzingerIndex index(v.cbegin(), v.cend());
+    run<int>(state, kQueries, [&]{
+        for (const int key : keys) benchmark::DoNotOptimize(index.find(key));
+    });
+}
+STL_BENCHMARK(BM_eytzinger_find);
+
+// Files: the search and sort families on a file of n ints, either read() into a
+// std::vector first or mapped with MappedFile. The file was just written, so it
+// is in the page cache: this compares copying the data with mapping its pages,
+// not the speed of the disk.
+namespace {
+
+std::filesystem::path bench_file_path() {
+    return std::filesystem::temp_directory_path() / "stl_examples_bench_mapped.bin";
+}
+
+void write_file(const std::filesystem::path& path, const std::vector<int>& v) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fwrite(v.data(), sizeof(int), v.size(), file);
+    std::fclose(file);
+}
+
+std::vector<int> read_file(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    std::vector<int> v(std::filesystem::file_size(path) / sizeof(int));
+    auto* data = reinterpret_cast<char*>(v.data());
+    for (std::size_t done = 0, bytes = v.size() * sizeof(int); done < bytes;) {
+        const ssize_t n = ::read(fd, data + done, bytes - done);
+        if (n <= 0) break;
+        done += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    return v;
+}
+
+// Writes 'v' to the bench file before each iteration, untimed, and times body(path).
+template<class Body>
+void run_on_file(benchmark::State& state, const std::vector<int>& v, Body body) {
+    const auto path = bench_file_path();
+    for (auto _ : state) {
+        write_file(path, v);
+        const auto start = std::chrono::steady_clock::now();
+        body(path);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(elapsed.count());
+    }
+    set_throughput<int>(state, static_cast<std::int64_t>(v.size()));
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+static void BM_find_read_file(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_file(state, v, [](const std::filesystem::path& path){
+        const auto data = read_file(path);
+        benchmark::DoNotOptimize(std::find(data.cbegin(), data.cend(), -1));
+    });
+}
+STL_BENCHMARK(BM_find_read_file);
+
+static void BM_find_mapped_file(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_file(state, v, [](const std::filesystem::path& path){
+        const stl_examples::MappedFile<const int> data(path, {.advice = stl_examples::Advice::sequential});
+        benchmark::DoNotOptimize(std::find(data.begin(), data.end(), -1));
+    });
+}
+STL_BENCHMARK(BM_find_mapped_file);
+
+static void BM_lower_bound_read_file(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run_on_file(state, v, [&](const std::filesystem::path& path){
+        const auto data = read_file(path);
+        for (const int key : keys) benchmark::DoNotOptimize(std::lower_bound(data.cbegin(), data.cend(), key));
+    });
+}
+STL_BENCHMARK(BM_lower_bound_read_file);
+
+static void BM_lower_bound_mapped_file(benchmark::State& state) {
+    const auto v = sorted_input(state);
+    const auto keys = queries(v);
+    run_on_file(state, v, [&](const std::filesystem::path& path){
+        // Only the pages on the search paths are touched: read-ahead would be wasted.
+        const stl_examples::MappedFile<const int> data(path, {.advice = stl_examples::Advice::random});
+        for (const int key : keys) benchmark::DoNotOptimize(std::lower_bound(data.begin(), data.end(), key));
+    });
+}
+STL_BENCHMARK(BM_lower_bound_mapped_file);
+
+// The sorted data ends up back in the file in both cases.
+static void BM_sort_read_file(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_file(state, v, [](const std::filesystem::path& path){
+        auto data = read_file(path);
+        std::sort(data.begin(), data.end());
+        write_file(path, data);
+    });
+}
+STL_BENCHMARK(BM_sort_read_file);
+
+static void BM_sort_mapped_file(benchmark::State& state) {
+    const auto v = input(state);
+    run_on_file(state, v, [](const std::filesystem::path& path){
+        const stl_examples::MappedFile<int> data(path, {.huge_pages = true});
+        std::sort(data.begin(), data.end());
+    });
+}
+STL_BENCHMARK(BM_sort_mapped_file);
+
+BENCHMARK_MAIN();
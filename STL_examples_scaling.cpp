@@ -0,0 +1,53 @@
+#include "parallel_algorithms.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// Prints how each algorithm in parallel_cases() scales with the number of threads.
+//
+// Usage:
+//       STL_examples_scaling [num_elements] [max_threads] [repetitions]
+//
+// For each algorithm, the "seq" column is the time with std::execution::seq, and
+// each "T=<t>" column is the time with std::execution::par limited to 't' threads,
+// followed by its speedup over seq. A parallel result that differs from the
+// sequential one is reported as MISMATCH.
+
+namespace parallel = stl_examples::parallel;
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : std::size_t{1} << 24;
+    const std::size_t max_threads = argc > 2 ? std::stoull(argv[2]) : std::thread::hardware_concurrency();
+    const int repetitions = argc > 3 ? std::stoi(argv[3]) : 3;
+    const auto thread_counts = parallel::thread_counts(max_threads);
+
+    std::printf("%zu elements, best of %d runs, times in ms (speedup over seq)\n\n", n, repetitions);
+    std::printf("%-16s %-26s %10s", "family", "algorithm", "seq");
+    for (const std::size_t t : thread_counts) {
+        const std::string column = "T=" + std::to_string(t);
+        std::printf("   %18s", column.c_str());
+    }
+    std::printf("\n");
+
+    const parallel::Dataset data = parallel::make_dataset(n);
+    for (const parallel::Case& c : parallel::parallel_cases()) {
+        parallel::Scratch expected, actual;
+        parallel::reset(data, expected);
+        parallel::reset(data, actual);
+        const bool matches = c.seq(data, expected) == c.par(data, actual) &&
+                             expected.values == actual.values && expected.wide == actual.wide;
+
+        const double seq = parallel::time_case(c.seq, data, repetitions);
+        std::printf("%-16.*s %-26.*s %10.2f", static_cast<int>(c.family.size()), c.family.data(),
+                    static_cast<int>(c.algorithm.size()), c.algorithm.data(), seq * 1e3);
+        for (const std::size_t t : thread_counts) {
+            const parallel::ThreadLimit limit(t);
+            const double par = parallel::time_case(c.par, data, repetitions);
+            std::printf("   %10.2f (%4.1fx)", par * 1e3, par > 0.0 ? seq / par : 0.0);
+        }
+        std::printf("%s\n", matches ? "" : "   MISMATCH");
+    }
+    return EXIT_SUCCESS;
+}
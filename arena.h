@@ -0,0 +1,149 @@
+#ifndef STL_EXAMPLES_ARENA_H
+#define STL_EXAMPLES_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+// Algorithm outputs allocated from a std::pmr::memory_resource, such as an arena
+// that lives for one request:
+//
+//       std::array<std::byte, 1 << 16> buffer;
+//       std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+//       std::pmr::vector<int> positive = arena::copy_if(&arena, v.cbegin(), v.cend(), is_positive);
+//       std::pmr::vector<int> merged = arena::merge(&arena, a.cbegin(), a.cend(), b.cbegin(), b.cend());
+//
+// Growing a vector through std::back_inserter reallocates O(log n) times, and a
+// monotonic arena never reuses the memory of the old buffers, so each output
+// here is reserved once, at its final size or an upper bound of it, when the
+// input iterators are forward iterators. The memory is handed back all at once
+// when the arena is destroyed or released.
+//
+// CountingResource counts the allocations that pass through it, to check where
+// they go: as the upstream of an arena, it counts what the arena could not serve
+// from its buffer; over std::pmr::null_memory_resource(), it makes sure there is
+// nothing.
+namespace stl_examples::arena {
+
+// A memory resource that forwards to 'upstream', and counts the allocations,
+// the bytes, and the peak of the bytes in use. Like the unsynchronized std::pmr
+// resources, it must not be used by several threads at once.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream) {}
+
+    CountingResource(const CountingResource&) = delete;
+    CountingResource& operator=(const CountingResource&) = delete;
+
+    std::pmr::memory_resource* upstream() const { return upstream_; }
+
+    std::size_t allocations() const { return allocations_; }
+    std::size_t deallocations() const { return deallocations_; }
+    // The bytes of all the allocations so far.
+    std::size_t bytes_allocated() const { return bytes_allocated_; }
+    std::size_t bytes_in_use() const { return bytes_in_use_; }
+    std::size_t peak_bytes() const { return peak_bytes_; }
+
+    // Zeroes the counts; the peak starts again from the bytes in use.
+    void reset() {
+        allocations_ = 0;
+        deallocations_ = 0;
+        bytes_allocated_ = 0;
+        peak_bytes_ = bytes_in_use_;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = upstream_->allocate(bytes, alignment);
+        ++allocations_;
+        bytes_allocated_ += bytes;
+        bytes_in_use_ += bytes;
+        peak_bytes_ = std::max(peak_bytes_, bytes_in_use_);
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+        ++deallocations_;
+        bytes_in_use_ -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t allocations_ = 0;
+    std::size_t deallocations_ = 0;
+    std::size_t bytes_allocated_ = 0;
+    std::size_t bytes_in_use_ = 0;
+    std::size_t peak_bytes_ = 0;
+};
+
+namespace detail {
+
+// An empty vector in 'resource', with room for 'max_size' elements when the
+// size of the input is known without reading it.
+template<class T, class... InputIts>
+std::pmr::vector<T> reserved(std::pmr::memory_resource* resource, std::size_t max_size) {
+    std::pmr::vector<T> result(resource);
+    if constexpr ((std::forward_iterator<InputIts> && ...)) result.reserve(max_size);
+    return result;
+}
+
+// The number of elements in [first, last), if it can be found without reading them.
+template<class InputIt>
+std::size_t known_distance(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) return static_cast<std::size_t>(std::distance(first, last));
+    else return 0;
+}
+
+} // namespace detail
+
+// std::copy_if into a new vector. The vector is reserved at the size of the
+// input, the most it can hold.
+template<class InputIt, class UnaryPredicate>
+std::pmr::vector<std::iter_value_t<InputIt>> copy_if(std::pmr::memory_resource* resource, InputIt first, InputIt last, UnaryPredicate pred) {
+    auto result = detail::reserved<std::iter_value_t<InputIt>, InputIt>(resource, detail::known_distance(first, last));
+    std::copy_if(first, last, std::back_inserter(result), pred);
+    return result;
+}
+
+// std::merge into a new vector, reserved at the size of both inputs.
+template<class InputIt1, class InputIt2, class Compare = std::less<>>
+std::pmr::vector<std::iter_value_t<InputIt1>> merge(std::pmr::memory_resource* resource, InputIt1 first1, InputIt1 last1,
+                                                   InputIt2 first2, InputIt2 last2, Compare comp = {}) {
+    auto result = detail::reserved<std::iter_value_t<InputIt1>, InputIt1, InputIt2>(
+        resource, detail::known_distance(first1, last1) + detail::known_distance(first2, last2));
+    std::merge(first1, last1, first2, last2, std::back_inserter(result), comp);
+    return result;
+}
+
+// std::set_union into a new vector, reserved at the size of both inputs, the
+// most it can hold.
+template<class InputIt1, class InputIt2, class Compare = std::less<>>
+std::pmr::vector<std::iter_value_t<InputIt1>> set_union(std::pmr::memory_resource* resource, InputIt1 first1, InputIt1 last1,
+                                                       InputIt2 first2, InputIt2 last2, Compare comp = {}) {
+    auto result = detail::reserved<std::iter_value_t<InputIt1>, InputIt1, InputIt2>(
+        resource, detail::known_distance(first1, last1) + detail::known_distance(first2, last2));
+    std::set_union(first1, last1, first2, last2, std::back_inserter(result), comp);
+    return result;
+}
+
+// std::partial_sum into a new vector, reserved at the size of the input.
+template<class InputIt, class BinaryOp = std::plus<>>
+std::pmr::vector<std::iter_value_t<InputIt>> partial_sum(std::pmr::memory_resource* resource, InputIt first, InputIt last, BinaryOp op = {}) {
+    auto result = detail::reserved<std::iter_value_t<InputIt>, InputIt>(resource, detail::known_distance(first, last));
+    std::partial_sum(first, last, std::back_inserter(result), op);
+    return result;
+}
+
+} // namespace stl_examples::arena
+
+#endif // STL_EXAMPLES_ARENA_H
@@ -0,0 +1,75 @@
+#ifndef STL_EXAMPLES_BENCH_DATA_H
+#define STL_EXAMPLES_BENCH_DATA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Input data for STL_examples_bench.
+namespace stl_examples::bench {
+
+// The shape of a benchmark input. The order matters: the benchmarks
+// receive it as their second argument, state.range(1).
+enum class Distribution {
+    random,         // Uniformly random in [0, n).
+    sorted,         // 'random', sorted ascending.
+    reverse_sorted, // 'random', sorted descending.
+    few_unique,     // Uniformly random in [0, 16).
+    organ_pipe,     // 0, 1, ..., n/2, ..., 1, 0.
+};
+
+inline constexpr int num_distributions = 5;
+
+inline std::string_view distribution_name(Distribution distribution) {
+    switch (distribution) {
+        case Distribution::random: return "random";
+        case Distribution::sorted: return "sorted";
+        case Distribution::reverse_sorted: return "reverse_sorted";
+        case Distribution::few_unique: return "few_unique";
+        case Distribution::organ_pipe: return "organ_pipe";
+    }
+    return "unknown";
+}
+
+// Builds an input of 'n' elements. Values are generated as 64-bit integers and then
+// converted to T, so narrow types such as char simply wrap around.
+template<class T>
+std::vector<T> make_input(std::size_t n, Distribution distribution, std::uint64_t seed = 42) {
+    std::vector<T> v(n);
+    std::mt19937_64 gen(seed);
+    const std::uint64_t bound = distribution == Distribution::few_unique ? 16 : std::max<std::size_t>(n, 1);
+    std::uniform_int_distribution<std::uint64_t> value(0, bound - 1);
+    switch (distribution) {
+        case Distribution::random:
+        case Distribution::few_unique:
+            std::generate(v.begin(), v.end(), [&]{ return static_cast<T>(value(gen)); });
+            break;
+        case Distribution::sorted:
+            std::generate(v.begin(), v.end(), [&]{ return static_cast<T>(value(gen)); });
+            std::sort(v.begin(), v.end());
+            break;
+        case Distribution::reverse_sorted:
+            std::generate(v.begin(), v.end(), [&]{ return static_cast<T>(value(gen)); });
+            std::sort(v.begin(), v.end(), std::greater<T>());
+            break;
+        case Distribution::organ_pipe:
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<T>(i < n / 2 ? i : n - 1 - i);
+            break;
+    }
+    return v;
+}
+
+// The largest input size, 1G elements by default. Override with the
+// STL_EXAMPLES_BENCH_MAX_SIZE environment variable.
+inline std::int64_t max_size() {
+    if (const char* value = std::getenv("STL_EXAMPLES_BENCH_MAX_SIZE")) return std::strtoll(value, nullptr, 10);
+    return std::int64_t{1} << 30;
+}
+
+} // namespace stl_examples::bench
+
+#endif // STL_EXAMPLES_BENCH_DATA_H
@@ -0,0 +1,292 @@
+#ifndef STL_EXAMPLES_DARY_HEAP_H
+#define STL_EXAMPLES_DARY_HEAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Heaps with D children per node instead of two, with the same range API as
+// std::make_heap, push_heap, pop_heap, sort_heap, is_heap, and is_heap_until:
+//
+//       dary::make_heap<4>(v.begin(), v.end());
+//       v.push_back(9);
+//       dary::push_heap<4>(v.begin(), v.end());
+//
+// The children of node i are at D * i + 1, ..., D * i + D, so the tree is log2(D)
+// times shallower. A sift-down compares more children per level, but they are
+// adjacent in memory: with D = 4 or 8 and small elements, a level costs one
+// cache miss instead of one per two children, which is what limits pop_heap on
+// heaps larger than the cache.
+//
+// As with std, the heap is a max heap for the given comparator. The ranges are
+// only heaps for the same D: std::is_heap does not accept a 4-ary heap.
+//
+// IndexedPriorityQueue below builds on the same layout.
+namespace stl_examples {
+
+namespace dary {
+
+namespace detail {
+
+// Moves 'value' from the hole at 'hole' toward 'top' while it is larger than its parent.
+template<std::size_t D, class RandomIt, class T, class Compare>
+void sift_up(RandomIt first, std::size_t hole, std::size_t top, T value, Compare& comp) {
+    while (hole > top) {
+        const std::size_t parent = (hole - 1) / D;
+        if (!comp(first[parent], value)) break;
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+    }
+    first[hole] = std::move(value);
+}
+
+// The index of the first largest of the children at [child, child + D) within len.
+template<std::size_t D, class RandomIt, class Compare>
+std::size_t largest_child(RandomIt first, std::size_t child, std::size_t len, Compare& comp) {
+    using T = std::iter_value_t<RandomIt>;
+    if constexpr ((D & (D - 1)) == 0 && std::is_trivially_copyable_v<T> && sizeof(T) <= 16) {
+        if (child + D <= len) {
+            // A knockout tournament: D - 1 comparisons as for a linear scan, but in
+            // log2(D) rounds of independent selects instead of a chain of branches.
+            // The winners' values are carried along, so no round waits on a load.
+            std::size_t index[D];
+            T value[D];
+            for (std::size_t k = 0; k < D; ++k) {
+                index[k] = child + k;
+                value[k] = first[child + k];
+            }
+            for (std::size_t width = D; width > 1; width /= 2) {
+                for (std::size_t k = 0; k < width / 2; ++k) {
+                    const bool right = comp(value[2 * k], value[2 * k + 1]);
+                    index[k] = right ? index[2 * k + 1] : index[2 * k];
+                    value[k] = right ? value[2 * k + 1] : value[2 * k];
+                }
+            }
+            return index[0];
+        }
+    }
+    const std::size_t end = child + D < len ? child + D : len;
+    std::size_t largest = child;
+    for (std::size_t c = child + 1; c < end; ++c) {
+        if (comp(first[largest], first[c])) largest = c;
+    }
+    return largest;
+}
+
+// Places 'value' in the subtree of 'hole' within [first, first + len). Like
+// libstdc++, the hole is first moved down to a leaf along the largest children,
+// then 'value' is sifted back up: it usually came from the bottom of the heap,
+// so this saves comparing it at every level.
+template<std::size_t D, class RandomIt, class T, class Compare>
+void sift_down(RandomIt first, std::size_t len, std::size_t hole, T value, Compare& comp) {
+    const std::size_t top = hole;
+    while (true) {
+        const std::size_t child = D * hole + 1;
+        if (child >= len) break;
+        // The D * D grandchildren are adjacent: fetch them while comparing the children.
+        const std::size_t grandchild = D * child + 1;
+        if (grandchild + D * D <= len) {
+            __builtin_prefetch(std::addressof(first[grandchild]));
+            __builtin_prefetch(std::addressof(first[grandchild + D * D - 1]));
+        }
+        const std::size_t largest = largest_child<D>(first, child, len, comp);
+        first[hole] = std::move(first[largest]);
+        hole = largest;
+    }
+    sift_up<D>(first, hole, top, std::move(value), comp);
+}
+
+} // namespace detail
+
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+RandomIt is_heap_until(RandomIt first, RandomIt last, Compare comp = {}) {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+    const std::size_t n = last - first;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (comp(first[(i - 1) / D], first[i])) return first + i;
+    }
+    return last;
+}
+
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+bool is_heap(RandomIt first, RandomIt last, Compare comp = {}) {
+    return dary::is_heap_until<D>(first, last, comp) == last;
+}
+
+// Inserts the element at last - 1 into the heap [first, last - 1).
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+void push_heap(RandomIt first, RandomIt last, Compare comp = {}) {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+    const std::size_t n = last - first;
+    if (n <= 1) return;
+    std::iter_value_t<RandomIt> value = std::move(first[n - 1]);
+    detail::sift_up<D>(first, n - 1, 0, std::move(value), comp);
+}
+
+// Moves the largest element to last - 1, and makes [first, last - 1) a heap.
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+void pop_heap(RandomIt first, RandomIt last, Compare comp = {}) {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+    const std::size_t n = last - first;
+    if (n <= 1) return;
+    std::iter_value_t<RandomIt> value = std::move(first[n - 1]);
+    first[n - 1] = std::move(first[0]);
+    detail::sift_down<D>(first, n - 1, 0, std::move(value), comp);
+}
+
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+void make_heap(RandomIt first, RandomIt last, Compare comp = {}) {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+    const std::size_t n = last - first;
+    if (n <= 1) return;
+    // Every node from the last parent up to the root.
+    for (std::size_t i = (n - 2) / D + 1; i-- > 0;) {
+        std::iter_value_t<RandomIt> value = std::move(first[i]);
+        detail::sift_down<D>(first, n, i, std::move(value), comp);
+    }
+}
+
+template<std::size_t D, class RandomIt, class Compare = std::less<>>
+void sort_heap(RandomIt first, RandomIt last, Compare comp = {}) {
+    for (; last - first > 1; --last) dary::pop_heap<D>(first, last, comp);
+}
+
+} // namespace dary
+
+// A priority queue of the ids 0 to capacity - 1, each with a priority that can be
+// changed while it is queued, as in Dijkstra's algorithm or a timer scheduler:
+//
+//       IndexedPriorityQueue<double> queue(num_vertices);
+//       queue.push(source, 0.0);
+//       ...
+//       queue.decrease_key(v, distance);   // v is now due earlier.
+//
+// Unlike std::priority_queue, top() is the id with the smallest priority by
+// default (Compare = std::greater<>); with std::less<> it is the largest.
+//
+// The queue is a D-ary heap of (priority, id) entries, plus the position of
+// each id in the heap, so that changing a priority only sifts one entry.
+template<class Priority, class Compare = std::greater<>, std::size_t D = 4>
+class IndexedPriorityQueue {
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit IndexedPriorityQueue(std::size_t capacity, Compare comp = Compare())
+        : comp_(std::move(comp)), position_(capacity, npos) {}
+
+    bool empty() const { return heap_.empty(); }
+    std::size_t size() const { return heap_.size(); }
+    std::size_t capacity() const { return position_.size(); }
+
+    bool contains(std::size_t id) const { return id < position_.size() && position_[id] != npos; }
+    const Priority& priority(std::size_t id) const { return heap_[position_[id]].priority; }
+
+    // The id that comes first, and its priority. The queue must not be empty.
+    std::size_t top() const { return heap_.front().id; }
+    const Priority& top_priority() const { return heap_.front().priority; }
+
+    // Adds 'id', which must be below capacity() and not already queued.
+    void push(std::size_t id, Priority priority) {
+        assert(id < capacity() && !contains(id));
+        heap_.push_back({std::move(priority), id});
+        sift_up(heap_.size() - 1);
+    }
+
+    // Removes top().
+    void pop() { erase(top()); }
+
+    // Removes 'id', which must be queued.
+    void erase(std::size_t id) {
+        assert(contains(id));
+        const std::size_t hole = position_[id];
+        position_[id] = npos;
+        Entry last = std::move(heap_.back());
+        heap_.pop_back();
+        if (hole == heap_.size()) return;
+        place(hole, std::move(last));
+    }
+
+    // Moves 'id' toward the top: 'priority' must come no later than its current one
+    // (for the default std::greater<>, it must not be larger).
+    void decrease_key(std::size_t id, Priority priority) {
+        assert(contains(id) && !comp_(priority, this->priority(id)));
+        heap_[position_[id]].priority = std::move(priority);
+        sift_up(position_[id]);
+    }
+
+    // Changes the priority of 'id' in either direction.
+    void update(std::size_t id, Priority priority) {
+        assert(contains(id));
+        place(position_[id], Entry{std::move(priority), id});
+    }
+
+    // Pushes 'id', or updates its priority if it is already queued.
+    void push_or_update(std::size_t id, Priority priority) {
+        if (contains(id)) update(id, std::move(priority));
+        else push(id, std::move(priority));
+    }
+
+private:
+    struct Entry {
+        Priority priority;
+        std::size_t id;
+    };
+
+    // True if 'a' belongs below 'b' in the heap.
+    bool below(const Entry& a, const Entry& b) const { return comp_(a.priority, b.priority); }
+
+    void move_to(std::size_t i, Entry entry) {
+        position_[entry.id] = i;
+        heap_[i] = std::move(entry);
+    }
+
+    void sift_up(std::size_t hole) {
+        Entry entry = std::move(heap_[hole]);
+        while (hole > 0) {
+            const std::size_t parent = (hole - 1) / D;
+            if (!below(heap_[parent], entry)) break;
+            move_to(hole, std::move(heap_[parent]));
+            hole = parent;
+        }
+        move_to(hole, std::move(entry));
+    }
+
+    // Puts 'entry' into the hole at 'hole', then restores the heap in whichever
+    // direction it is out of order.
+    void place(std::size_t hole, Entry entry) {
+        if (hole > 0 && below(heap_[(hole - 1) / D], entry)) {
+            heap_[hole] = std::move(entry);
+            sift_up(hole);
+            return;
+        }
+        const std::size_t len = heap_.size();
+        while (true) {
+            const std::size_t child = D * hole + 1;
+            if (child >= len) break;
+            const std::size_t end = child + D < len ? child + D : len;
+            std::size_t first = child;
+            for (std::size_t c = child + 1; c < end; ++c) {
+                if (below(heap_[first], heap_[c])) first = c;
+            }
+            if (!below(entry, heap_[first])) break;
+            move_to(hole, std::move(heap_[first]));
+            hole = first;
+        }
+        move_to(hole, std::move(entry));
+    }
+
+    Compare comp_;
+    std::vector<Entry> heap_;
+    // The index in heap_ of each id, or npos if it is not queued.
+    std::vector<std::size_t> position_;
+};
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_DARY_HEAP_H
@@ -0,0 +1,330 @@
+#ifndef STL_EXAMPLES_EXTERNAL_SORT_H
+#define STL_EXAMPLES_EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_merge_sort.h"
+
+// Sorts a file of fixed-width records that may be much larger than memory:
+//
+//       struct Row { std::uint64_t key; char payload[56]; };
+//       const auto stats = external_sort<Row>("rows.bin", "sorted.bin", {.memory_budget = 1 << 30},
+//                                             [](const Row& a, const Row& b){ return a.key < b.key; });
+//       std::cout << stats.megabytes_per_second() << " MB/s\n";
+//
+// The file is a plain array of Records, as written by fwrite. The sort runs in
+// two phases, each of which overlaps its I/O with its computation:
+//
+//   1. Runs: chunks of a third of the memory budget are read, sorted with
+//      parallel_merge_sort, and spilled to temporary files. The next chunk is
+//      read on another thread while the current one is sorted and written.
+//   2. Merge: the runs are merged k ways through a heap of their first records.
+//      Each run is read in large blocks, the next block on another thread while
+//      the current one is merged, and the output is written the same way. When
+//      there are too many runs to give each a block of at least min_io_size,
+//      groups of runs are first merged into longer runs, in as many passes as needed.
+//
+// Like std::stable_sort, equal records keep their order. I/O errors throw
+// std::system_error; the temporary files are removed in any case.
+namespace stl_examples {
+
+struct ExternalSortOptions {
+    // Bytes of records held in memory at once, for sorting and for I/O buffers.
+    std::size_t memory_budget = std::size_t{1} << 30;
+    // Where runs are spilled; the system's temporary directory if empty.
+    std::filesystem::path temp_directory;
+    // The smallest block read from each run while merging. Fewer runs are merged
+    // at once when needed, so that reads stay large and sequential on disks.
+    std::size_t min_io_size = std::size_t{1} << 20;
+};
+
+struct ExternalSortStats {
+    std::uint64_t records = 0;
+    std::uint64_t bytes = 0;       // Size of the input file.
+    std::size_t runs = 0;          // Sorted runs made by the first phase.
+    std::size_t merge_passes = 0;  // Passes over the data after the first phase.
+    double run_seconds = 0;        // Reading, sorting, and spilling the runs.
+    double merge_seconds = 0;
+
+    // Megabytes (10^6 bytes) of input sorted per second, end to end.
+    double megabytes_per_second() const {
+        const double seconds = run_seconds + merge_seconds;
+        return seconds > 0 ? static_cast<double>(bytes) / 1e6 / seconds : 0;
+    }
+};
+
+namespace detail {
+
+// An open file, read or written in whole blocks.
+class BlockFile {
+public:
+    BlockFile(const std::filesystem::path& path, const char* mode) : path_(path), file_(std::fopen(path.c_str(), mode)) {
+        if (!file_) fail("cannot open");
+        // The blocks are large: copying them through the stdio buffer gains nothing.
+        std::setvbuf(file_.get(), nullptr, _IONBF, 0);
+    }
+
+    // Reads up to 'bytes', fewer only at the end of the file. Returns the number read.
+    // An empty buffer may have a null 'data', which stdio must not be given.
+    std::size_t read(void* data, std::size_t bytes) {
+        if (bytes == 0) return 0;
+        const std::size_t done = std::fread(data, 1, bytes, file_.get());
+        if (done < bytes && std::ferror(file_.get())) fail("cannot read");
+        return done;
+    }
+
+    void write(const void* data, std::size_t bytes) {
+        if (bytes == 0) return;
+        if (std::fwrite(data, 1, bytes, file_.get()) != bytes) fail("cannot write");
+    }
+
+    void close() {
+        if (std::fclose(file_.release()) != 0) fail("cannot close");
+    }
+
+private:
+    struct Closer {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::system_error(errno, std::generic_category(), std::string(what) + " " + path_.string());
+    }
+
+    std::filesystem::path path_;
+    std::unique_ptr<std::FILE, Closer> file_;
+};
+
+// A uniquely named file in 'directory', removed when this goes out of scope.
+class TempFile {
+public:
+    explicit TempFile(const std::filesystem::path& directory) {
+        static std::atomic<std::uint64_t> counter{std::random_device()()};
+        path_ = directory / ("stl_examples_sort_" + std::to_string(counter++) + ".run");
+    }
+    TempFile(TempFile&& other) noexcept : path_(std::exchange(other.path_, {})) {}
+    TempFile& operator=(TempFile&& other) noexcept {
+        std::swap(path_, other.path_);
+        return *this;
+    }
+    ~TempFile() {
+        std::error_code ignored;
+        if (!path_.empty()) std::filesystem::remove(path_, ignored);
+    }
+
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Reads a sorted run one record at a time, while the next block is read on another thread.
+template<class Record>
+class RunReader {
+public:
+    RunReader(const std::filesystem::path& path, std::size_t block_records)
+        : file_(path, "rb"), current_(block_records), next_(block_records) {
+        count_ = read(current_);
+        if (count_ > 0) pending_ = std::async(std::launch::async, [this]{ return read(next_); });
+    }
+    ~RunReader() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    bool empty() const { return count_ == 0; }
+    const Record& front() const { return current_[position_]; }
+
+    void pop() {
+        if (++position_ < count_) return;
+        position_ = 0;
+        count_ = pending_.get();
+        std::swap(current_, next_);
+        if (count_ > 0) pending_ = std::async(std::launch::async, [this]{ return read(next_); });
+    }
+
+private:
+    std::size_t read(std::vector<Record>& block) {
+        return file_.read(block.data(), block.size() * sizeof(Record)) / sizeof(Record);
+    }
+
+    BlockFile file_;
+    std::vector<Record> current_;
+    std::vector<Record> next_;
+    std::size_t position_ = 0;
+    std::size_t count_ = 0;
+    std::future<std::size_t> pending_;
+};
+
+// Writes records in blocks, each while the next one is filled.
+template<class Record>
+class RunWriter {
+public:
+    RunWriter(const std::filesystem::path& path, std::size_t block_records)
+        : file_(path, "wb"), current_(block_records), writing_(block_records) {}
+    ~RunWriter() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    void push(const Record& record) {
+        current_[size_++] = record;
+        if (size_ == current_.size()) flush();
+    }
+
+    // Writes what is left and closes the file.
+    void finish() {
+        flush();
+        if (pending_.valid()) pending_.get();
+        file_.close();
+    }
+
+private:
+    void flush() {
+        if (pending_.valid()) pending_.get();
+        std::swap(current_, writing_);
+        pending_ = std::async(std::launch::async, [this, size = size_]{
+            file_.write(writing_.data(), size * sizeof(Record));
+        });
+        size_ = 0;
+    }
+
+    BlockFile file_;
+    std::vector<Record> current_;
+    std::vector<Record> writing_;
+    std::size_t size_ = 0;
+    std::future<void> pending_;
+};
+
+// Merges the sorted files 'runs' into 'output'. Equal records come from the
+// earlier run first.
+template<class Record, class Compare>
+void merge_runs(const std::vector<std::filesystem::path>& runs, const std::filesystem::path& output,
+                std::size_t block_records, Compare& comp) {
+    std::vector<std::unique_ptr<RunReader<Record>>> readers;
+    for (const auto& run : runs) readers.push_back(std::make_unique<RunReader<Record>>(run, block_records));
+    RunWriter<Record> writer(output, block_records);
+
+    // A heap of the runs not yet exhausted, with the run of the least front record on top.
+    const auto after = [&](std::size_t a, std::size_t b) {
+        const Record& x = readers[a]->front();
+        const Record& y = readers[b]->front();
+        return comp(y, x) || (!comp(x, y) && a > b);
+    };
+    std::vector<std::size_t> heap;
+    for (std::size_t r = 0; r < readers.size(); ++r) {
+        if (!readers[r]->empty()) heap.push_back(r);
+    }
+    std::make_heap(heap.begin(), heap.end(), after);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), after);
+        RunReader<Record>& reader = *readers[heap.back()];
+        writer.push(reader.front());
+        reader.pop();
+        if (reader.empty()) heap.pop_back();
+        else std::push_heap(heap.begin(), heap.end(), after);
+    }
+    writer.finish();
+}
+
+} // namespace detail
+
+// Sorts the Records in the file 'input' into the file 'output', which may be the same file.
+template<class Record, class Compare = std::less<>>
+ExternalSortStats external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+                                const ExternalSortOptions& options = {}, Compare comp = {}) {
+    static_assert(std::is_trivially_copyable_v<Record>, "records are read and written as bytes");
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    ExternalSortStats stats;
+    stats.bytes = fs::file_size(input);
+    if (stats.bytes % sizeof(Record) != 0) {
+        throw std::invalid_argument(input.string() + " is not a whole number of records");
+    }
+    stats.records = stats.bytes / sizeof(Record);
+    const fs::path directory = options.temp_directory.empty() ? fs::temp_directory_path() : options.temp_directory;
+
+    // Phase 1: a chunk being sorted, its scratch buffer, and the next chunk being read.
+    const auto start = Clock::now();
+    const std::size_t chunk_records = std::max<std::size_t>(1, options.memory_budget / 3 / sizeof(Record));
+    std::vector<detail::TempFile> runs;
+    {
+        detail::BlockFile file(input, "rb");
+        std::vector<Record> current(static_cast<std::size_t>(std::min<std::uint64_t>(chunk_records, stats.records)));
+        std::vector<Record> next(current.size());
+        const auto read = [&](std::vector<Record>& chunk) {
+            return file.read(chunk.data(), chunk.size() * sizeof(Record)) / sizeof(Record);
+        };
+        std::size_t count = read(current);
+        if (count == stats.records) {
+            // Everything fits: no runs to spill.
+            file.close();
+            parallel_merge_sort(current.begin(), current.end(), comp);
+            detail::BlockFile out(output, "wb");
+            out.write(current.data(), current.size() * sizeof(Record));
+            out.close();
+            stats.runs = count > 0 ? 1 : 0;
+            stats.run_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return stats;
+        }
+        while (count > 0) {
+            auto pending = std::async(std::launch::async, read, std::ref(next));
+            parallel_merge_sort(current.begin(), current.begin() + count, comp);
+            detail::TempFile run(directory);
+            detail::BlockFile out(run.path(), "wb");
+            out.write(current.data(), count * sizeof(Record));
+            out.close();
+            runs.push_back(std::move(run));
+            count = pending.get();
+            std::swap(current, next);
+        }
+    }
+    stats.runs = runs.size();
+    const auto merge_start = Clock::now();
+    stats.run_seconds = std::chrono::duration<double>(merge_start - start).count();
+
+    // Phase 2: two blocks per run being merged, and two for the output.
+    const std::size_t max_fan_in = std::max<std::size_t>(2, options.memory_budget / (2 * options.min_io_size) - 1);
+    const auto block_records = [&](std::size_t fan_in) {
+        return std::max<std::size_t>(1, options.memory_budget / (2 * (fan_in + 1)) / sizeof(Record));
+    };
+    while (runs.size() > max_fan_in) {
+        std::vector<detail::TempFile> merged;
+        for (std::size_t first = 0; first < runs.size(); first += max_fan_in) {
+            const std::size_t last = std::min(runs.size(), first + max_fan_in);
+            std::vector<fs::path> group;
+            for (std::size_t r = first; r < last; ++r) group.push_back(runs[r].path());
+            detail::TempFile run(directory);
+            detail::merge_runs<Record>(group, run.path(), block_records(group.size()), comp);
+            merged.push_back(std::move(run));
+        }
+        runs = std::move(merged);
+        ++stats.merge_passes;
+    }
+    std::vector<fs::path> paths;
+    for (const auto& run : runs) paths.push_back(run.path());
+    detail::merge_runs<Record>(paths, output, block_records(paths.size()), comp);
+    ++stats.merge_passes;
+    stats.merge_seconds = std::chrono::duration<double>(Clock::now() - merge_start).count();
+    return stats;
+}
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_EXTERNAL_SORT_H
@@ -0,0 +1,172 @@
+#ifndef STL_EXAMPLES_EYTZINGER_INDEX_H
+#define STL_EXAMPLES_EYTZINGER_INDEX_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A static search index over a sorted range, answering the same queries as
+// std::lower_bound, std::upper_bound, std::equal_range, std::binary_search and
+// std::bsearch, but faster once the range no longer fits in cache.
+//
+//       const EytzingerIndex<int> index(v.cbegin(), v.cend());   // v is sorted.
+//       const auto lower = v.cbegin() + index.lower_bound(4);    // Same as std::lower_bound(v.cbegin(), v.cend(), 4).
+//
+// The index keeps a copy of the elements in Eytzinger (BFS) order: the root of
+// the implicit search tree at position 1, and the children of position k at 2k
+// and 2k + 1. The first levels of the tree then share a few cache lines, and the
+// descendants of a node log2(64 / sizeof(T)) levels down fill one cache line, so
+// a single prefetch fetches them: the 16 great-great-grandchildren, four levels
+// ahead, for 4-byte keys; 8 nodes three levels ahead for 8-byte keys; and
+// nothing ahead for elements of a cache line or more. The descent has no branch
+// on the result of the comparison, which a binary search mispredicts half of
+// the time.
+//
+// Results are positions in the sorted range (0 to size()), so they can be added
+// to the begin iterator of the original range. The positions are computed from
+// the final node of the descent, so the index stores nothing but the elements.
+namespace stl_examples {
+
+namespace detail {
+
+inline constexpr std::size_t cache_line_size = 64;
+
+// Aligns the Eytzinger array to a cache line, so each group of 16 (or 64 /
+// sizeof(T)) siblings starts a new line.
+template<class T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template<class U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{cache_line_size}));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t{cache_line_size});
+    }
+
+    template<class U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+};
+
+} // namespace detail
+
+template<class T, class Compare = std::less<>>
+class EytzingerIndex {
+public:
+    EytzingerIndex() = default;
+
+    // Builds the index from the sorted range [first, last), in O(n).
+    template<class ForwardIt>
+    EytzingerIndex(ForwardIt first, ForwardIt last, Compare comp = Compare())
+        : comp_(comp), size_(static_cast<std::size_t>(std::distance(first, last))),
+          nodes_(size_ + 1) {
+        build(first, 1);
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // The position of the first element not less than 'key'.
+    template<class Key>
+    std::size_t lower_bound(const Key& key) const {
+        return descend([&](const T& node){ return comp_(node, key); });
+    }
+
+    // The position of the first element greater than 'key'.
+    template<class Key>
+    std::size_t upper_bound(const Key& key) const {
+        return descend([&](const T& node){ return !comp_(key, node); });
+    }
+
+    // The positions of the elements equivalent to 'key', as [first, second).
+    template<class Key>
+    std::pair<std::size_t, std::size_t> equal_range(const Key& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template<class Key>
+    bool binary_search(const Key& key) const {
+        const std::size_t k = descend_node([&](const T& node){ return comp_(node, key); });
+        return k != 0 && !comp_(key, nodes_[k]);
+    }
+
+    // Like std::bsearch, but as a position: the first element equivalent to
+    // 'key', or size() if there is none.
+    template<class Key>
+    std::size_t find(const Key& key) const {
+        const std::size_t k = descend_node([&](const T& node){ return comp_(node, key); });
+        return k != 0 && !comp_(key, nodes_[k]) ? rank(k) : size_;
+    }
+
+private:
+    // Fills the subtree rooted at position k with the next elements of the sorted range.
+    template<class ForwardIt>
+    void build(ForwardIt& it, std::size_t k) {
+        if (k > size_) return;
+        build(it, 2 * k);
+        nodes_[k] = *it++;
+        build(it, 2 * k + 1);
+    }
+
+    // The position in the sorted range of node k. In the perfect tree with the
+    // same depth, node k at depth d is at (2(k - 2^d) + 1) * 2^(height - d) - 1
+    // in order, and the leaves of the last level are at the even positions; the
+    // last level is filled from the left, so subtract its missing leaves before k.
+    std::size_t rank(std::size_t k) const {
+        const int height = std::bit_width(size_) - 1;
+        const int depth = std::bit_width(k) - 1;
+        const std::size_t in_perfect_tree =
+            ((2 * (k - (std::size_t{1} << depth)) + 1) << (height - depth)) - 1;
+        const std::size_t last_level = size_ - ((std::size_t{1} << height) - 1);
+        const std::size_t leaves_before = (in_perfect_tree + 1) / 2;
+        return leaves_before > last_level ? in_perfect_tree - (leaves_before - last_level) : in_perfect_tree;
+    }
+
+    // The position of the first node for which go_right(node) is false, or 0 if none.
+    template<class GoRight>
+    std::size_t descend_node(GoRight go_right) const {
+        constexpr std::size_t prefetch_stride =
+            sizeof(T) < detail::cache_line_size ? detail::cache_line_size / sizeof(T) : 1;
+        std::size_t k = 1;
+        while (k <= size_) {
+            // Past the end of the array near the leaves: computed as an integer,
+            // since such a pointer is undefined, and prefetches never fault.
+            const std::uintptr_t ahead = reinterpret_cast<std::uintptr_t>(nodes_.data()) + k * prefetch_stride * sizeof(T);
+            __builtin_prefetch(reinterpret_cast<const void*>(ahead));
+            k = 2 * k + static_cast<std::size_t>(go_right(nodes_[k]));
+        }
+        // The path went left at the answer, then only right: undo those right
+        // turns and the final left one.
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    template<class GoRight>
+    std::size_t descend(GoRight go_right) const {
+        const std::size_t k = descend_node(go_right);
+        return k == 0 ? size_ : rank(k);
+    }
+
+    Compare comp_;
+    std::size_t size_ = 0;
+    // Position 0 is unused, so that the children of k are at 2k and 2k + 1.
+    std::vector<T, detail::CacheAlignedAllocator<T>> nodes_ = std::vector<T, detail::CacheAlignedAllocator<T>>(1);
+};
+
+template<class ForwardIt>
+EytzingerIndex(ForwardIt, ForwardIt) -> EytzingerIndex<std::iter_value_t<ForwardIt>>;
+
+template<class ForwardIt, class Compare>
+EytzingerIndex(ForwardIt, ForwardIt, Compare) -> EytzingerIndex<std::iter_value_t<ForwardIt>, Compare>;
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_EYTZINGER_INDEX_H
@@ -0,0 +1,71 @@
+// Counts the allocations through the global operator new, for the report mode
+// of instrumentation.h. Linked into the test and benchmark targets only when
+// they are built with -DSTL_EXAMPLES_INSTRUMENT=ON.
+//
+// The plain and the aligned forms of operator new are replaced: the array and
+// nothrow forms of libstdc++ call these. Every form of operator delete, sized
+// and array ones too, is replaced to free through the same std::free.
+#include <cstdlib>
+#include <new>
+
+#include "instrumentation.h"
+
+namespace {
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    namespace instrument = stl_examples::instrument;
+    instrument::count(instrument::Event::allocations);
+    instrument::count(instrument::Event::allocated_bytes, size);
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                ? std::malloc(size)
+                : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (p != nullptr) return p;
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,284 @@
+#ifndef STL_EXAMPLES_INSTRUMENTATION_H
+#define STL_EXAMPLES_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Adapters that count what an algorithm does to its inputs:
+//
+//       const instrument::Counts before = instrument::snapshot();
+//       std::sort(people.begin(), people.end(), instrument::CountingCompare(by_age));
+//       const instrument::Counts sort_counts = instrument::snapshot() - before;
+//       sort_counts[instrument::Event::comparisons]
+//
+//   - CountingCompare wraps a comparator, and counts its calls.
+//   - CountingProjection wraps a projection (a key function), and counts its calls.
+//   - Counted<T> wraps an element, and counts its copies, moves, swaps, and
+//     comparisons with == and <.
+//   - CountingIterator wraps an iterator, and counts its dereferences and steps.
+//
+// The counting is compiled in only when STL_EXAMPLES_INSTRUMENT is defined to 1
+// (the CMake option of the same name). Otherwise the adapters only forward to
+// what they wrap, and cost nothing once inlined; the counts stay at zero.
+// With the option, every allocation through the global operator new is also
+// counted (see instrumentation.cpp), which shows, for example, the buffers that
+// std::stable_sort and std::inplace_merge take.
+//
+// The counters are shared by all threads, so an algorithm running on the TBB
+// threads is counted whole, and are not reset: take the difference of two
+// snapshots around what to measure.
+//
+// With STL_EXAMPLES_REPORT=1 in the environment, the test and benchmark targets
+// print the counts of each TEST family, or each benchmark, next to its time.
+#ifndef STL_EXAMPLES_INSTRUMENT
+#define STL_EXAMPLES_INSTRUMENT 0
+#endif
+
+namespace stl_examples::instrument {
+
+inline constexpr bool enabled = STL_EXAMPLES_INSTRUMENT != 0;
+
+enum class Event {
+    comparisons,
+    projections,
+    copies,
+    moves,
+    swaps,
+    dereferences,
+    steps,
+    allocations,
+    allocated_bytes,
+};
+
+inline constexpr std::size_t num_events = static_cast<std::size_t>(Event::allocated_bytes) + 1;
+
+inline const char* event_name(Event event) {
+    static constexpr std::array<const char*, num_events> names{
+        "comparisons", "projections", "copies", "moves", "swaps", "dereferences", "steps", "allocations", "allocated_bytes"};
+    return names[static_cast<std::size_t>(event)];
+}
+
+// The value of each counter at some point, or the difference of two such points.
+struct Counts {
+    std::array<std::uint64_t, num_events> values{};
+
+    std::uint64_t operator[](Event event) const { return values[static_cast<std::size_t>(event)]; }
+
+    Counts& operator+=(const Counts& other) {
+        for (std::size_t i = 0; i < num_events; ++i) values[i] += other.values[i];
+        return *this;
+    }
+
+    friend Counts operator-(Counts a, const Counts& b) {
+        for (std::size_t i = 0; i < num_events; ++i) a.values[i] -= b.values[i];
+        return a;
+    }
+
+    friend bool operator==(const Counts&, const Counts&) = default;
+};
+
+// The nonzero counts, as "comparisons=12 moves=30".
+inline std::string to_string(const Counts& counts) {
+    std::string result;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        if (counts.values[i] == 0) continue;
+        if (!result.empty()) result += ' ';
+        result += event_name(static_cast<Event>(i));
+        result += '=';
+        result += std::to_string(counts.values[i]);
+    }
+    return result;
+}
+
+namespace detail {
+inline std::array<std::atomic<std::uint64_t>, num_events> counters{};
+} // namespace detail
+
+inline void count(Event event, std::uint64_t n = 1) {
+    if constexpr (enabled) detail::counters[static_cast<std::size_t>(event)].fetch_add(n, std::memory_order_relaxed);
+}
+
+inline Counts snapshot() {
+    Counts counts;
+    if constexpr (enabled) {
+        for (std::size_t i = 0; i < num_events; ++i) counts.values[i] = detail::counters[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+// Whether STL_EXAMPLES_REPORT asks the test and benchmark targets for reports.
+inline bool report_mode() {
+    static const bool on = [] {
+        const char* value = std::getenv("STL_EXAMPLES_REPORT");
+        return value != nullptr && *value != '\0' && std::string(value) != "0";
+    }();
+    return on;
+}
+
+template<class Compare = std::less<>>
+class CountingCompare {
+public:
+    CountingCompare() = default;
+    explicit CountingCompare(Compare comp) : comp_(std::move(comp)) {}
+
+    template<class A, class B>
+    bool operator()(A&& a, B&& b) const {
+        count(Event::comparisons);
+        return std::invoke(comp_, std::forward<A>(a), std::forward<B>(b));
+    }
+
+private:
+    Compare comp_;
+};
+
+template<class Projection = std::identity>
+class CountingProjection {
+public:
+    CountingProjection() = default;
+    explicit CountingProjection(Projection proj) : proj_(std::move(proj)) {}
+
+    template<class T>
+    decltype(auto) operator()(T&& x) const {
+        count(Event::projections);
+        return std::invoke(proj_, std::forward<T>(x));
+    }
+
+private:
+    Projection proj_;
+};
+
+template<class T>
+class Counted {
+public:
+    Counted() = default;
+    Counted(T value) : value_(std::move(value)) {}
+
+    Counted(const Counted& other) : value_(other.value_) { count(Event::copies); }
+    Counted(Counted&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::move(other.value_)) {
+        count(Event::moves);
+    }
+    Counted& operator=(const Counted& other) {
+        count(Event::copies);
+        value_ = other.value_;
+        return *this;
+    }
+    Counted& operator=(Counted&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        count(Event::moves);
+        value_ = std::move(other.value_);
+        return *this;
+    }
+
+    const T& value() const { return value_; }
+    T& value() { return value_; }
+
+    friend void swap(Counted& a, Counted& b) noexcept(std::is_nothrow_swappable_v<T>) {
+        count(Event::swaps);
+        using std::swap;
+        swap(a.value_, b.value_);
+    }
+
+    friend bool operator==(const Counted& a, const Counted& b) {
+        count(Event::comparisons);
+        return a.value_ == b.value_;
+    }
+    friend bool operator<(const Counted& a, const Counted& b) {
+        count(Event::comparisons);
+        return a.value_ < b.value_;
+    }
+
+private:
+    T value_{};
+};
+
+template<std::input_or_output_iterator It>
+class CountingIterator {
+public:
+    using iterator_category = typename std::iterator_traits<It>::iterator_category;
+    using value_type = std::iter_value_t<It>;
+    using difference_type = std::iter_difference_t<It>;
+    using pointer = typename std::iterator_traits<It>::pointer;
+    using reference = std::iter_reference_t<It>;
+
+    CountingIterator() = default;
+    explicit CountingIterator(It it) : it_(std::move(it)) {}
+
+    const It& base() const { return it_; }
+
+    reference operator*() const {
+        count(Event::dereferences);
+        return *it_;
+    }
+    reference operator[](difference_type n) const requires std::random_access_iterator<It> {
+        count(Event::dereferences);
+        return it_[n];
+    }
+
+    CountingIterator& operator++() {
+        count(Event::steps);
+        ++it_;
+        return *this;
+    }
+    CountingIterator operator++(int) {
+        CountingIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+    CountingIterator& operator--() requires std::bidirectional_iterator<It> {
+        count(Event::steps);
+        --it_;
+        return *this;
+    }
+    CountingIterator operator--(int) requires std::bidirectional_iterator<It> {
+        CountingIterator previous = *this;
+        --*this;
+        return previous;
+    }
+    // A jump counts as one step.
+    CountingIterator& operator+=(difference_type n) requires std::random_access_iterator<It> {
+        count(Event::steps);
+        it_ += n;
+        return *this;
+    }
+    CountingIterator& operator-=(difference_type n) requires std::random_access_iterator<It> {
+        count(Event::steps);
+        it_ -= n;
+        return *this;
+    }
+
+    friend CountingIterator operator+(CountingIterator it, difference_type n) requires std::random_access_iterator<It> {
+        return it += n;
+    }
+    friend CountingIterator operator+(difference_type n, CountingIterator it) requires std::random_access_iterator<It> {
+        return it += n;
+    }
+    friend CountingIterator operator-(CountingIterator it, difference_type n) requires std::random_access_iterator<It> {
+        return it -= n;
+    }
+    friend difference_type operator-(const CountingIterator& a, const CountingIterator& b) requires std::sized_sentinel_for<It, It> {
+        return a.it_ - b.it_;
+    }
+
+    friend bool operator==(const CountingIterator& a, const CountingIterator& b) requires std::equality_comparable<It> {
+        return a.it_ == b.it_;
+    }
+    friend auto operator<=>(const CountingIterator& a, const CountingIterator& b) requires std::three_way_comparable<It> {
+        return std::compare_three_way()(a.it_, b.it_);
+    }
+
+private:
+    It it_{};
+};
+
+} // namespace stl_examples::instrument
+
+#endif // STL_EXAMPLES_INSTRUMENTATION_H
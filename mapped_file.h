@@ -0,0 +1,175 @@
+#ifndef STL_EXAMPLES_MAPPED_FILE_H
+#define STL_EXAMPLES_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A file of fixed-width records, memory-mapped as a contiguous range, so that
+// the algorithms run on the file itself instead of on a std::vector read from it:
+//
+//       const MappedFile<const Row> rows("rows.bin", {.advice = Advice::sequential});
+//       const auto n = std::count_if(rows.begin(), rows.end(), is_active);
+//
+//       MappedFile<Row> writable("rows.bin");                  // Changes go to the file.
+//       std::sort(writable.begin(), writable.end(), by_key);
+//
+// A MappedFile<const T> maps the file read-only; a MappedFile<T> maps it shared
+// and writable, and its changes reach the file when it is unmapped or sync()ed.
+// The iterators are plain pointers, so std::ranges::contiguous_range holds and
+// the SIMD paths of the other headers apply.
+//
+// Pages are read from the file on first access. The Advice tells the kernel
+// how they will be accessed, so that it reads ahead (sequential, willneed) or
+// not (random). POSIX only.
+namespace stl_examples {
+
+enum class Advice {
+    normal,
+    sequential, // Read ahead aggressively, and drop pages soon after use.
+    random,     // Do not read ahead.
+    willneed,   // Start reading the whole file now.
+};
+
+struct MapOptions {
+    Advice advice = Advice::normal;
+    // Asks for transparent huge pages, so the page tables cover 2 MiB per entry
+    // instead of 4 KiB. Only a hint: the kernel may not back files with them.
+    bool huge_pages = false;
+    // Maps all pages up front (MAP_POPULATE) rather than faulting them in on first access.
+    bool populate = false;
+};
+
+template<class T>
+class MappedFile {
+    static_assert(std::is_trivially_copyable_v<T>, "records are mapped as bytes");
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    MappedFile() = default;
+
+    // Maps the existing file 'path', whose size must be a whole number of records.
+    explicit MappedFile(const std::filesystem::path& path, const MapOptions& options = {}) {
+        const int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) fail("cannot open", path);
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            fail("cannot stat", path);
+        }
+        const auto bytes = static_cast<std::size_t>(info.st_size);
+        if (bytes % sizeof(T) != 0) {
+            ::close(fd);
+            throw std::invalid_argument(path.string() + " is not a whole number of records");
+        }
+        map(fd, bytes, options, path);
+    }
+
+    // Creates (or truncates) the file 'path' with room for 'count' records, and maps it.
+    static MappedFile create(const std::filesystem::path& path, std::size_t count, const MapOptions& options = {}) {
+        static_assert(writable, "create() maps the new file for writing");
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail("cannot create", path);
+        if (::ftruncate(fd, static_cast<off_t>(count * sizeof(T))) != 0) {
+            ::close(fd);
+            fail("cannot resize", path);
+        }
+        MappedFile file;
+        file.map(fd, count * sizeof(T), options, path);
+        return file;
+    }
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(address(), size_ * sizeof(T));
+    }
+
+    T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T& operator[](std::size_t i) const { return data_[i]; }
+
+    // Changes how the pages will be accessed from now on, e.g. random after a sequential pass.
+    void advise(Advice advice) const {
+        if (empty()) return;
+        const int flags[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+        if (::madvise(address(), size_ * sizeof(T), flags[static_cast<int>(advice)]) != 0) {
+            throw std::system_error(errno, std::generic_category(), "madvise");
+        }
+    }
+
+    // Writes the changes back to the file now, and waits for the write.
+    void sync() const {
+        static_assert(writable, "only a writable mapping has changes to write");
+        if (!empty() && ::msync(data_, size_ * sizeof(T), MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+private:
+    static constexpr bool writable = !std::is_const_v<T>;
+
+    [[noreturn]] static void fail(const char* what, const std::filesystem::path& path) {
+        throw std::system_error(errno, std::generic_category(), std::string(what) + " " + path.string());
+    }
+
+    // Maps 'bytes' of the open file 'fd', then closes it: the mapping keeps the file open.
+    void map(int fd, std::size_t bytes, const MapOptions& options, const std::filesystem::path& path) {
+        if (bytes > 0) {
+            const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            const int flags = (writable ? MAP_SHARED : MAP_PRIVATE) | (options.populate ? MAP_POPULATE : 0);
+            void* p = ::mmap(nullptr, bytes, protection, flags, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                fail("cannot map", path);
+            }
+            data_ = static_cast<T*>(p);
+            size_ = bytes / sizeof(T);
+        }
+        ::close(fd);
+        if (options.huge_pages && !empty()) {
+            // Not an error if unsupported: the mapping works with small pages too.
+            ::madvise(address(), bytes, MADV_HUGEPAGE);
+        }
+        try {
+            advise(options.advice);
+        } catch (...) {
+            // Called from the constructor, whose throw skips ~MappedFile: unmap here.
+            ::munmap(address(), bytes);
+            data_ = nullptr;
+            size_ = 0;
+            throw;
+        }
+    }
+
+    void* address() const { return const_cast<value_type*>(data_); }
+
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_MAPPED_FILE_H
@@ -0,0 +1,393 @@
+#ifndef STL_EXAMPLES_PARALLEL_ALGORITHMS_H
+#define STL_EXAMPLES_PARALLEL_ALGORITHMS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/global_control.h>
+
+#include "parallel_merge_sort.h"
+#include "parallel_reduce.h"
+#include "parallel_scan.h"
+
+// Parallel versions of the examples in STL_examples.cpp, using the
+// execution policies std::execution::seq, par, and par_unseq.
+//
+// Each entry in parallel_cases() runs one algorithm under a given policy, so the
+// tests can check that the parallel result matches the sequential one, and
+// STL_examples_scaling can time the same call at 1, 2, 4, ... N threads.
+//
+// With libstdc++, the parallel policies are backed by Intel TBB. The number of
+// worker threads is therefore controlled with tbb::global_control (see ThreadLimit).
+namespace stl_examples::parallel {
+
+// Limits the number of threads used by the parallel policies while in scope.
+class ThreadLimit {
+public:
+    explicit ThreadLimit(std::size_t num_threads)
+        : control_(tbb::global_control::max_allowed_parallelism, std::max<std::size_t>(num_threads, 1)) {}
+
+    // The number of threads the parallel policies are currently allowed to use.
+    static std::size_t current() {
+        return tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    }
+
+private:
+    tbb::global_control control_;
+};
+
+// Returns {1, 2, 4, ..., max_threads}, always ending with max_threads itself.
+inline std::vector<std::size_t> thread_counts(std::size_t max_threads = std::thread::hardware_concurrency()) {
+    max_threads = std::max<std::size_t>(max_threads, 1);
+    std::vector<std::size_t> counts;
+    for (std::size_t t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Read-only inputs shared by every case.
+struct Dataset {
+    std::vector<int> values;   // Uniformly random in [-1000, 1000].
+    std::vector<int> sorted_a; // Two sorted halves of 'values', used by the
+    std::vector<int> sorted_b; // binary-search, merge, and set operations.
+};
+
+// Per-call outputs. 'values' starts as a copy of Dataset::values so that the
+// modifying algorithms have something to work on; 'wide' holds the scans,
+// whose running sums do not fit in an int.
+struct Scratch {
+    std::vector<int> values;
+    std::vector<std::int64_t> wide;
+};
+
+// Scalar results (counts, positions, sums) of a single call.
+using Result = std::vector<std::int64_t>;
+
+inline Dataset make_dataset(std::size_t n, std::uint32_t seed = 42) {
+    Dataset data;
+    data.values.resize(n);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    std::generate(data.values.begin(), data.values.end(), [&]{ return distribution(gen); });
+
+    const auto middle = data.values.cbegin() + n / 2;
+    data.sorted_a.assign(data.values.cbegin(), middle);
+    data.sorted_b.assign(middle, data.values.cend());
+    std::sort(data.sorted_a.begin(), data.sorted_a.end());
+    std::sort(data.sorted_b.begin(), data.sorted_b.end());
+    return data;
+}
+
+inline void reset(const Dataset& data, Scratch& scratch) {
+    scratch.values = data.values;
+    scratch.wide.assign(data.values.size(), 0);
+}
+
+struct Case {
+    std::string_view family;    // Section of STL_examples.cpp, e.g. "Sorting".
+    std::string_view algorithm; // Name of the TEST family, e.g. "stable_sort".
+    std::function<Result(const Dataset&, Scratch&)> seq;
+    std::function<Result(const Dataset&, Scratch&)> par;
+    std::function<Result(const Dataset&, Scratch&)> par_unseq;
+};
+
+// Builds a Case from a generic lambda taking (const policy&, const Dataset&, Scratch&).
+// The policy is taken by const reference, as libstdc++ cannot forward a
+// non-const policy through some of the set operations.
+template<class F>
+Case make_case(std::string_view family, std::string_view algorithm, F f) {
+    return Case{family, algorithm,
+                [f](const Dataset& d, Scratch& s){ return f(std::execution::seq, d, s); },
+                [f](const Dataset& d, Scratch& s){ return f(std::execution::par, d, s); },
+                [f](const Dataset& d, Scratch& s){ return f(std::execution::par_unseq, d, s); }};
+}
+
+// Shrinks 'v' so that it ends at 'last'.
+template<class T, class Iter>
+void truncate(std::vector<T>& v, Iter last) {
+    v.resize(last - v.begin());
+}
+
+inline const std::vector<Case>& parallel_cases() {
+    static const std::vector<Case> cases = [] {
+        const auto isPositive = [](int i)->bool{ return i > 0; };
+        const auto isLessThanZero = [](int i)->bool{ return i < 0; };
+        const auto square = [](int i)->std::int64_t{ return std::int64_t{i} * i; };
+        // A value that never occurs, so the search algorithms scan the whole range.
+        constexpr int missing = 1001;
+
+        std::vector<Case> c;
+
+        // Non-modifying sequence operations.
+        c.push_back(make_case("Non-modifying", "any_of", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::any_of(policy, d.values.cbegin(), d.values.cend(), [](int i){ return i == missing; })};
+        }));
+        c.push_back(make_case("Non-modifying", "all_of", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::all_of(policy, d.values.cbegin(), d.values.cend(), [](int i){ return i != missing; })};
+        }));
+        c.push_back(make_case("Non-modifying", "none_of", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::none_of(policy, d.values.cbegin(), d.values.cend(), [](int i){ return i == missing; })};
+        }));
+        c.push_back(make_case("Non-modifying", "for_each", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::for_each(policy, s.values.begin(), s.values.end(), [](int& i){ i *= 2; });
+            return {};
+        }));
+        c.push_back(make_case("Non-modifying", "count", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::count(policy, d.values.cbegin(), d.values.cend(), 0)};
+        }));
+        c.push_back(make_case("Non-modifying", "count_if", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::count_if(policy, d.values.cbegin(), d.values.cend(), isPositive)};
+        }));
+        c.push_back(make_case("Non-modifying", "mismatch", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            const auto [miss, _] = std::mismatch(policy, d.values.cbegin(), d.values.cend(), s.values.cbegin());
+            return {miss - d.values.cbegin()};
+        }));
+        c.push_back(make_case("Non-modifying", "find", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::find(policy, d.values.cbegin(), d.values.cend(), missing) - d.values.cbegin()};
+        }));
+        c.push_back(make_case("Non-modifying", "find_if", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            const auto isMissing = [](int i){ return i == missing; };
+            return {std::find_if(policy, d.values.cbegin(), d.values.cend(), isMissing) - d.values.cbegin()};
+        }));
+        c.push_back(make_case("Non-modifying", "adjacent_find", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            // A sorted range has no decreasing pair, so the whole range is scanned.
+            return {std::adjacent_find(policy, d.sorted_a.cbegin(), d.sorted_a.cend(), std::greater<int>()) -
+                    d.sorted_a.cbegin()};
+        }));
+        c.push_back(make_case("Non-modifying", "search", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            const std::vector<int> sequence{missing, missing};
+            return {std::search(policy, d.values.cbegin(), d.values.cend(), sequence.cbegin(), sequence.cend()) -
+                    d.values.cbegin()};
+        }));
+
+        // Modifying sequence operations.
+        c.push_back(make_case("Modifying", "copy", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::copy(policy, d.values.cbegin(), d.values.cend(), s.values.begin());
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "copy_if", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::copy_if(policy, d.values.cbegin(), d.values.cend(), s.values.begin(), isPositive));
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "fill", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::fill(policy, s.values.begin(), s.values.end(), 42);
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "transform", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::transform(policy, d.values.cbegin(), d.values.cend(), s.values.begin(), [](int i){ return i * 3 + 1; });
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "replace", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::replace(policy, s.values.begin(), s.values.end(), 3, 42);
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "replace_if", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::replace_if(policy, s.values.begin(), s.values.end(), isLessThanZero, 42);
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "remove", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            truncate(s.values, std::remove(policy, s.values.begin(), s.values.end(), 0));
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "remove_if", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            truncate(s.values, std::remove_if(policy, s.values.begin(), s.values.end(), isLessThanZero));
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "reverse", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::reverse(policy, s.values.begin(), s.values.end());
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "rotate", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::rotate(policy, s.values.begin(), s.values.begin() + s.values.size() / 3, s.values.end());
+            return {};
+        }));
+        c.push_back(make_case("Modifying", "unique", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::copy(policy, d.sorted_a.cbegin(), d.sorted_a.cend(), s.values.begin());
+            truncate(s.values, std::unique(policy, s.values.begin(), s.values.begin() + d.sorted_a.size()));
+            return {};
+        }));
+
+        // Partitioning operations.
+        c.push_back(make_case("Partitioning", "is_partitioned", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::is_partitioned(policy, d.sorted_a.cbegin(), d.sorted_a.cend(), isLessThanZero)};
+        }));
+        c.push_back(make_case("Partitioning", "stable_partition", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            const auto point = std::stable_partition(policy, s.values.begin(), s.values.end(), isLessThanZero);
+            return {point - s.values.begin()};
+        }));
+
+        // Sorting operations.
+        c.push_back(make_case("Sorting", "is_sorted", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::is_sorted(policy, d.sorted_a.cbegin(), d.sorted_a.cend())};
+        }));
+        c.push_back(make_case("Sorting", "is_sorted_until", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::is_sorted_until(policy, d.sorted_b.cbegin(), d.sorted_b.cend()) - d.sorted_b.cbegin()};
+        }));
+        c.push_back(make_case("Sorting", "sort", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            std::sort(policy, s.values.begin(), s.values.end());
+            return {};
+        }));
+        c.push_back(make_case("Sorting", "stable_sort", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            // Sorting by magnitude only keeps equal keys apart, so stability is visible.
+            std::stable_sort(policy, s.values.begin(), s.values.end(),
+                             [](int a, int b){ return std::abs(a) < std::abs(b); });
+            return {};
+        }));
+        c.push_back(make_case("Sorting", "parallel_merge_sort", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            // The merge_sort example next to TEST(inplace_merge), parallelized
+            // with TBB tasks instead of a policy, so seq runs std::stable_sort.
+            const auto by_magnitude = [](int a, int b){ return std::abs(a) < std::abs(b); };
+            if constexpr (std::is_same_v<std::decay_t<decltype(policy)>, std::execution::sequenced_policy>) {
+                std::stable_sort(s.values.begin(), s.values.end(), by_magnitude);
+            } else {
+                stl_examples::parallel_merge_sort(s.values.begin(), s.values.end(), by_magnitude);
+            }
+            return {};
+        }));
+        c.push_back(make_case("Sorting", "partial_sort", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            const auto middle = s.values.begin() + s.values.size() / 100;
+            std::partial_sort(policy, s.values.begin(), middle, s.values.end());
+            truncate(s.values, middle);
+            return {};
+        }));
+        c.push_back(make_case("Sorting", "nth_element", [=](const auto& policy, const Dataset&, Scratch& s)->Result {
+            if (s.values.empty()) return {};
+            // Only the nth element itself is specified, not the order around it.
+            const auto nth = s.values.begin() + s.values.size() / 2;
+            std::nth_element(policy, s.values.begin(), nth, s.values.end());
+            const int value = *nth;
+            s.values.clear();
+            return {value};
+        }));
+
+        // Minimum, maximum operations.
+        c.push_back(make_case("Minimum/maximum", "max_element", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::max_element(policy, d.values.cbegin(), d.values.cend()) - d.values.cbegin()};
+        }));
+        c.push_back(make_case("Minimum/maximum", "minmax_element", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            const auto [min, max] = std::minmax_element(policy, d.values.cbegin(), d.values.cend());
+            return {min - d.values.cbegin(), max - d.values.cbegin()};
+        }));
+
+        // Other operations and set operations (on sorted ranges).
+        c.push_back(make_case("Set", "merge", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::merge(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                          d.sorted_b.cbegin(), d.sorted_b.cend(), s.values.begin()));
+            return {};
+        }));
+        c.push_back(make_case("Set", "includes", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::includes(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                  d.sorted_a.cbegin(), d.sorted_a.cend())};
+        }));
+        c.push_back(make_case("Set", "set_union", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::set_union(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                              d.sorted_b.cbegin(), d.sorted_b.cend(), s.values.begin()));
+            return {};
+        }));
+        c.push_back(make_case("Set", "set_intersection", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::set_intersection(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                                     d.sorted_b.cbegin(), d.sorted_b.cend(), s.values.begin()));
+            return {};
+        }));
+        c.push_back(make_case("Set", "set_difference", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::set_difference(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                                   d.sorted_b.cbegin(), d.sorted_b.cend(), s.values.begin()));
+            return {};
+        }));
+        c.push_back(make_case("Set", "set_symmetric_difference", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            truncate(s.values, std::set_symmetric_difference(policy, d.sorted_a.cbegin(), d.sorted_a.cend(),
+                                                             d.sorted_b.cbegin(), d.sorted_b.cend(), s.values.begin()));
+            return {};
+        }));
+
+        // Numeric operations.
+        c.push_back(make_case("Numeric", "reduce", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::reduce(policy, d.values.cbegin(), d.values.cend(), std::int64_t{0})};
+        }));
+        c.push_back(make_case("Numeric", "deterministic::reduce", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            // The fixed-order reduction from parallel_reduce.h, which uses TBB
+            // directly, so seq runs std::reduce.
+            if constexpr (std::is_same_v<std::decay_t<decltype(policy)>, std::execution::sequenced_policy>) {
+                return {std::reduce(d.values.cbegin(), d.values.cend(), std::int64_t{0})};
+            } else {
+                return {stl_examples::deterministic::reduce(d.values.cbegin(), d.values.cend(), std::int64_t{0})};
+            }
+        }));
+        c.push_back(make_case("Numeric", "transform_reduce", [=](const auto& policy, const Dataset& d, Scratch&)->Result {
+            return {std::transform_reduce(policy, d.values.cbegin(), d.values.cend(), std::int64_t{0},
+                                          std::plus<>(), square)};
+        }));
+        c.push_back(make_case("Numeric", "inner_product", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            // std::inner_product has no parallel overload; transform_reduce is its parallel form.
+            return {std::transform_reduce(policy, d.values.cbegin(), d.values.cend(), s.values.cbegin(),
+                                          std::int64_t{0}, std::plus<>(),
+                                          [](int a, int b)->std::int64_t{ return std::int64_t{a} * b; })};
+        }));
+        c.push_back(make_case("Numeric", "inclusive_scan", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::inclusive_scan(policy, d.values.cbegin(), d.values.cend(), s.wide.begin(),
+                                std::plus<std::int64_t>(), std::int64_t{0});
+            return {};
+        }));
+        c.push_back(make_case("Numeric", "exclusive_scan", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::exclusive_scan(policy, d.values.cbegin(), d.values.cend(), s.wide.begin(), std::int64_t{0});
+            return {};
+        }));
+        c.push_back(make_case("Numeric", "transform_inclusive_scan", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::transform_inclusive_scan(policy, d.values.cbegin(), d.values.cend(), s.wide.begin(),
+                                          std::plus<std::int64_t>(), square);
+            return {};
+        }));
+        c.push_back(make_case("Numeric", "transform_exclusive_scan", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::transform_exclusive_scan(policy, d.values.cbegin(), d.values.cend(), s.wide.begin(),
+                                          std::int64_t{0}, std::plus<std::int64_t>(), square);
+            return {};
+        }));
+        c.push_back(make_case("Numeric", "scan::exclusive_scan", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            // The blocked SIMD scan from parallel_scan.h, which uses TBB directly,
+            // so seq runs std::exclusive_scan.
+            if constexpr (std::is_same_v<std::decay_t<decltype(policy)>, std::execution::sequenced_policy>) {
+                std::exclusive_scan(d.values.cbegin(), d.values.cend(), s.wide.begin(), std::int64_t{0});
+            } else {
+                stl_examples::scan::exclusive_scan(d.values.cbegin(), d.values.cend(), s.wide.begin(), std::int64_t{0});
+            }
+            return {};
+        }));
+        c.push_back(make_case("Numeric", "adjacent_difference", [=](const auto& policy, const Dataset& d, Scratch& s)->Result {
+            std::adjacent_difference(policy, d.values.cbegin(), d.values.cend(), s.values.begin());
+            return {};
+        }));
+        return c;
+    }();
+    return cases;
+}
+
+// Runs 'run' (one of Case::seq, par, or par_unseq) 'repetitions' times on a fresh
+// Scratch and returns the fastest wall time in seconds. Resetting the scratch
+// is not timed.
+inline double time_case(const std::function<Result(const Dataset&, Scratch&)>& run, const Dataset& data,
+                        int repetitions = 3) {
+    Scratch scratch;
+    double best = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        reset(data, scratch);
+        const auto start = std::chrono::steady_clock::now();
+        run(data, scratch);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+} // namespace stl_examples::parallel
+
+#endif // STL_EXAMPLES_PARALLEL_ALGORITHMS_H
@@ -0,0 +1,125 @@
+#ifndef STL_EXAMPLES_PARALLEL_MERGE_SORT_H
+#define STL_EXAMPLES_PARALLEL_MERGE_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+// A production version of the merge_sort example next to TEST(inplace_merge).
+//
+// Differences from the example:
+//   - The two halves are sorted as tasks on TBB's work-stealing scheduler, so
+//     the number of threads follows parallel::ThreadLimit.
+//   - Ranges shorter than merge_sort_insertion_cutoff are insertion sorted.
+//   - One scratch buffer of n elements is allocated up front. Each level merges
+//     from the range into the buffer or back, instead of std::inplace_merge
+//     allocating a temporary buffer for every merge.
+//   - Large merges are themselves split across threads: the output is cut into
+//     chunks, and the co-rank of each cut (how many of its elements come from
+//     the left half) is found by binary search, so each chunk merges independently.
+//
+// Like std::stable_sort, it is stable. Elements must be default constructible and movable.
+namespace stl_examples {
+
+namespace detail {
+
+inline constexpr std::ptrdiff_t merge_sort_insertion_cutoff = 32;
+// Below this size, sorting and merging stay on the calling thread.
+inline constexpr std::ptrdiff_t merge_sort_parallel_cutoff = 1 << 14;
+// The number of output elements each task of a parallel merge produces.
+inline constexpr std::ptrdiff_t merge_chunk_size = 1 << 14;
+
+template<class RandomIt, class Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    for (RandomIt i = first + (first != last); i < last; ++i) {
+        auto value = std::move(*i);
+        RandomIt j = i;
+        // Strictly less, so equal elements keep their order.
+        for (; j != first && comp(value, *(j - 1)); --j) *j = std::move(*(j - 1));
+        *j = std::move(value);
+    }
+}
+
+// The number of elements that a stable merge of a[0, n1) and b[0, n2) takes
+// from 'a' for its first k outputs. Equal elements are taken from 'a' first.
+template<class ItA, class ItB, class Compare>
+std::ptrdiff_t co_rank(std::ptrdiff_t k, ItA a, std::ptrdiff_t n1, ItB b, std::ptrdiff_t n2, Compare comp) {
+    std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, k - n2);
+    std::ptrdiff_t hi = std::min(k, n1);
+    while (lo < hi) {
+        const std::ptrdiff_t i = lo + (hi - lo) / 2;
+        const std::ptrdiff_t j = k - i;
+        // a[i] is not greater than b[j - 1], so it is output first: take more from 'a'.
+        if (j > 0 && i < n1 && !comp(b[j - 1], a[i])) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+// Moves the stable merge of a[0, n1) and b[0, n2) into 'out'.
+template<class ItA, class ItB, class Out, class Compare>
+void move_merge(ItA a, std::ptrdiff_t n1, ItB b, std::ptrdiff_t n2, Out out, Compare comp) {
+    const std::ptrdiff_t n = n1 + n2;
+    if (n < merge_sort_parallel_cutoff) {
+        std::merge(std::make_move_iterator(a), std::make_move_iterator(a + n1),
+                   std::make_move_iterator(b), std::make_move_iterator(b + n2), out, comp);
+        return;
+    }
+    const std::ptrdiff_t num_chunks = (n + merge_chunk_size - 1) / merge_chunk_size;
+    tbb::parallel_for(tbb::blocked_range<std::ptrdiff_t>(0, num_chunks), [&](const tbb::blocked_range<std::ptrdiff_t>& r) {
+        for (std::ptrdiff_t c = r.begin(); c != r.end(); ++c) {
+            const std::ptrdiff_t k0 = c * merge_chunk_size;
+            const std::ptrdiff_t k1 = std::min(n, k0 + merge_chunk_size);
+            const std::ptrdiff_t i0 = co_rank(k0, a, n1, b, n2, comp);
+            const std::ptrdiff_t i1 = co_rank(k1, a, n1, b, n2, comp);
+            std::merge(std::make_move_iterator(a + i0), std::make_move_iterator(a + i1),
+                       std::make_move_iterator(b + (k0 - i0)), std::make_move_iterator(b + (k1 - i1)),
+                       out + k0, comp);
+        }
+    });
+}
+
+// Sorts src[0, n). The result ends up in 'src', or in buffer[0, n) if 'into_buffer'.
+// The two halves are sorted into the other array, then merged back.
+template<class RandomIt, class BufferIt, class Compare>
+void merge_sort_into(RandomIt src, BufferIt buffer, std::ptrdiff_t n, bool into_buffer, Compare comp) {
+    if (n <= merge_sort_insertion_cutoff) {
+        insertion_sort(src, src + n, comp);
+        if (into_buffer) std::move(src, src + n, buffer);
+        return;
+    }
+    const std::ptrdiff_t half = n / 2;
+    const auto sort_left = [&]{ merge_sort_into(src, buffer, half, !into_buffer, comp); };
+    const auto sort_right = [&]{ merge_sort_into(src + half, buffer + half, n - half, !into_buffer, comp); };
+    if (n >= merge_sort_parallel_cutoff) {
+        tbb::parallel_invoke(sort_left, sort_right);
+    } else {
+        sort_left();
+        sort_right();
+    }
+    if (into_buffer) move_merge(src, half, src + half, n - half, buffer, comp);
+    else move_merge(buffer, half, buffer + half, n - half, src, comp);
+}
+
+} // namespace detail
+
+template<class RandomIt, class Compare = std::less<>>
+void parallel_merge_sort(RandomIt first, RandomIt last, Compare comp = {}) {
+    const std::ptrdiff_t n = last - first;
+    if (n <= detail::merge_sort_insertion_cutoff) {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+    std::vector<std::iter_value_t<RandomIt>> buffer(n);
+    detail::merge_sort_into(first, buffer.begin(), n, /*into_buffer=*/false, comp);
+}
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_PARALLEL_MERGE_SORT_H
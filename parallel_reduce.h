@@ -0,0 +1,413 @@
+#ifndef STL_EXAMPLES_PARALLEL_REDUCE_H
+#define STL_EXAMPLES_PARALLEL_REDUCE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/parallel_invoke.h>
+
+#include "simd_dispatch.h"
+
+// Reductions with the same arguments as std::reduce, transform_reduce, accumulate,
+// and inner_product, whose result does not depend on the number of threads:
+//
+//       const double total = deterministic::reduce(v.cbegin(), v.cend(), 0.0);
+//
+// std::reduce(std::execution::par, ...) adds floating-point values in an order
+// that depends on how the work was split, so the rounding, and the result, can
+// change from one run to the next. Here the order is fixed by the size alone:
+//
+//   - The range is cut into leaves of leaf_size elements. Within a leaf, element
+//     i goes to accumulator i % lane_count<T> (64 floats or 32 doubles, a few SIMD
+//     registers' worth), and the accumulators are combined pairwise at the end.
+//   - The leaves are combined by a balanced binary tree, whose subtrees are
+//     reduced on different TBB threads (see parallel::ThreadLimit).
+//   - The result is combined with init last.
+//
+// The SIMD kernels for float and double sums and dot products follow the same
+// order, so results are also the same at every simd::Level. Like std::reduce,
+// the operator must be associative and commutative; accumulate and inner_product
+// take the same liberty, unlike their std versions.
+//
+// The tree makes the summation pairwise above the leaves, so the rounding error
+// grows with log(n) rather than n. Summation::kahan also carries a Kahan
+// compensation in every accumulator, and combines them without losing it.
+namespace stl_examples::deterministic {
+
+enum class Summation {
+    pairwise, // Multiple accumulators per leaf, then a pairwise tree.
+    kahan,    // The same, with compensated additions. Applies to floating-point sums with std::plus.
+};
+
+namespace detail {
+
+// Elements per leaf of the reduction tree.
+inline constexpr std::size_t leaf_size = 1 << 14;
+// Subtrees smaller than this are reduced on the calling thread.
+inline constexpr std::size_t parallel_min_size = 1 << 16;
+// Accumulators per leaf: 256 bytes' worth, 4 AVX-512 or 8 AVX2 registers.
+template<class T>
+inline constexpr std::size_t lane_count = std::clamp<std::size_t>(256 / sizeof(T), 1, 64);
+
+template<class T, class BinaryOp>
+inline constexpr bool is_plus_v = std::is_same_v<BinaryOp, std::plus<>> || std::is_same_v<BinaryOp, std::plus<T>>;
+
+template<class T, class BinaryOp>
+inline constexpr bool is_multiplies_v = std::is_same_v<BinaryOp, std::multiplies<>> || std::is_same_v<BinaryOp, std::multiplies<T>>;
+
+template<class T>
+inline constexpr bool is_kernel_type_v = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// True if transform_reduce(first, last, T, ReduceOp, TransformOp) is a sum of
+// contiguous floats or doubles, which the kernels compute.
+template<class T, class It, class ReduceOp, class TransformOp>
+inline constexpr bool is_sum_kernel_v = [] {
+    if constexpr (std::contiguous_iterator<It>) {
+        return is_kernel_type_v<T> && std::is_same_v<std::iter_value_t<It>, T> && is_plus_v<T, ReduceOp> &&
+               std::is_same_v<TransformOp, std::identity>;
+    } else {
+        return false;
+    }
+}();
+
+// The same for transform_reduce(first1, last1, first2, T, ReduceOp, TransformOp), a dot product.
+template<class T, class It1, class It2, class ReduceOp, class TransformOp>
+inline constexpr bool is_dot_kernel_v = [] {
+    if constexpr (std::contiguous_iterator<It1> && std::contiguous_iterator<It2>) {
+        return is_kernel_type_v<T> && std::is_same_v<std::iter_value_t<It1>, T> && std::is_same_v<std::iter_value_t<It2>, T> &&
+               is_plus_v<T, ReduceOp> && is_multiplies_v<T, TransformOp>;
+    } else {
+        return false;
+    }
+}();
+
+// A Kahan sum: the exact total is close to sum - compensation.
+template<class T>
+struct Compensated {
+    T sum;
+    T compensation;
+};
+
+template<class T>
+void kahan_add(T& sum, T& compensation, T x) {
+    const T y = x - compensation;
+    const T t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+}
+
+// Adds two compensated sums. The rounding error of adding the sums is found
+// exactly (Knuth's TwoSum) and moved into the compensation.
+template<class T>
+Compensated<T> compensated_add(const Compensated<T>& a, const Compensated<T>& b) {
+    const T sum = a.sum + b.sum;
+    const T b_part = sum - a.sum;
+    const T error = (a.sum - (sum - b_part)) + (b.sum - b_part);
+    return {sum, a.compensation + b.compensation - error};
+}
+
+// Keeps a product from being fused with the addition that follows, which the
+// compiler may do where FMA is available; the other levels would round differently.
+template<class V>
+inline V unfused(V v) {
+#if STL_EXAMPLES_SIMD_X86
+    __asm__("" : "+x"(v));
+#endif
+    return v;
+}
+
+// The kernels below fill sums[k] (and compensations[k]) for the n elements at x,
+// or the n products of x and y when Dot is set: accumulator k starts from
+// element k, and then adds every lane_count<T>-th element after it. n is a
+// nonzero multiple of lane_count<T>.
+
+template<bool Kahan, bool Dot, class T>
+void lanes_scalar(const T* x, const T* y, std::size_t n, T* sums, T* compensations) {
+    constexpr std::size_t lanes = lane_count<T>;
+    const auto value = [&](std::size_t i) { if constexpr (Dot) return unfused(x[i] * y[i]); else return x[i]; };
+    for (std::size_t k = 0; k < lanes; ++k) {
+        sums[k] = value(k);
+        compensations[k] = T(0);
+    }
+    for (std::size_t i = lanes; i < n; i += lanes) {
+        for (std::size_t k = 0; k < lanes; ++k) {
+            if constexpr (Kahan) kahan_add(sums[k], compensations[k], value(i + k));
+            else sums[k] += value(i + k);
+        }
+    }
+}
+
+#if STL_EXAMPLES_SIMD_X86
+STL_EXAMPLES_TARGET_AVX2 inline __m256 avx2_load(const float* p) { return _mm256_loadu_ps(p); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256d avx2_load(const double* p) { return _mm256_loadu_pd(p); }
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256 avx2_add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256d avx2_add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256 avx2_sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256d avx2_sub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256 avx2_mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX2 inline __m256d avx2_mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+
+template<bool Dot, class T>
+STL_EXAMPLES_TARGET_AVX2 inline auto avx2_value(const T* x, const T* y, std::size_t i) {
+    if constexpr (Dot) {
+        auto product = avx2_mul(avx2_load(x + i), avx2_load(y + i));
+        __asm__("" : "+x"(product));
+        return product;
+    } else {
+        return avx2_load(x + i);
+    }
+}
+
+template<bool Kahan, bool Dot, class T>
+STL_EXAMPLES_TARGET_AVX2 void lanes_avx2(const T* x, const T* y, std::size_t n, T* sums, T* compensations) {
+    constexpr std::size_t width = 32 / sizeof(T);
+    constexpr std::size_t vectors = lane_count<T> / width;
+    using V = decltype(avx2_load(x));
+    V sum[vectors];
+    V compensation[vectors];
+    for (std::size_t r = 0; r < vectors; ++r) {
+        sum[r] = avx2_value<Dot>(x, y, r * width);
+        compensation[r] = V{};
+    }
+    for (std::size_t i = lane_count<T>; i < n; i += lane_count<T>) {
+        for (std::size_t r = 0; r < vectors; ++r) {
+            const V v = avx2_value<Dot>(x, y, i + r * width);
+            if constexpr (Kahan) {
+                const V corrected = avx2_sub(v, compensation[r]);
+                const V t = avx2_add(sum[r], corrected);
+                compensation[r] = avx2_sub(avx2_sub(t, sum[r]), corrected);
+                sum[r] = t;
+            } else {
+                sum[r] = avx2_add(sum[r], v);
+            }
+        }
+    }
+    for (std::size_t r = 0; r < vectors; ++r) {
+        avx2_store(sums + r * width, sum[r]);
+        avx2_store(compensations + r * width, compensation[r]);
+    }
+}
+
+STL_EXAMPLES_TARGET_AVX512 inline __m512 avx512_load(const float* p) { return _mm512_loadu_ps(p); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512d avx512_load(const double* p) { return _mm512_loadu_pd(p); }
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512 avx512_add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512d avx512_add(__m512d a, __m512d b) { return _mm512_add_pd(a, b); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512 avx512_sub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512d avx512_sub(__m512d a, __m512d b) { return _mm512_sub_pd(a, b); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512 avx512_mul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+STL_EXAMPLES_TARGET_AVX512 inline __m512d avx512_mul(__m512d a, __m512d b) { return _mm512_mul_pd(a, b); }
+
+template<bool Dot, class T>
+STL_EXAMPLES_TARGET_AVX512 inline auto avx512_value(const T* x, const T* y, std::size_t i) {
+    if constexpr (Dot) {
+        auto product = avx512_mul(avx512_load(x + i), avx512_load(y + i));
+        __asm__("" : "+v"(product));
+        return product;
+    } else {
+        return avx512_load(x + i);
+    }
+}
+
+template<bool Kahan, bool Dot, class T>
+STL_EXAMPLES_TARGET_AVX512 void lanes_avx512(const T* x, const T* y, std::size_t n, T* sums, T* compensations) {
+    constexpr std::size_t width = 64 / sizeof(T);
+    constexpr std::size_t vectors = lane_count<T> / width;
+    using V = decltype(avx512_load(x));
+    V sum[vectors];
+    V compensation[vectors];
+    for (std::size_t r = 0; r < vectors; ++r) {
+        sum[r] = avx512_value<Dot>(x, y, r * width);
+        compensation[r] = V{};
+    }
+    for (std::size_t i = lane_count<T>; i < n; i += lane_count<T>) {
+        for (std::size_t r = 0; r < vectors; ++r) {
+            const V v = avx512_value<Dot>(x, y, i + r * width);
+            if constexpr (Kahan) {
+                const V corrected = avx512_sub(v, compensation[r]);
+                const V t = avx512_add(sum[r], corrected);
+                compensation[r] = avx512_sub(avx512_sub(t, sum[r]), corrected);
+                sum[r] = t;
+            } else {
+                sum[r] = avx512_add(sum[r], v);
+            }
+        }
+    }
+    for (std::size_t r = 0; r < vectors; ++r) {
+        avx512_store(sums + r * width, sum[r]);
+        avx512_store(compensations + r * width, compensation[r]);
+    }
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Dispatches to the kernel for the current Level.
+template<bool Kahan, bool Dot, class T>
+void lanes_vectorized(const T* x, const T* y, std::size_t n, T* sums, T* compensations) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (simd::level()) {
+        case simd::Level::avx512: lanes_avx512<Kahan, Dot>(x, y, n, sums, compensations); return;
+        case simd::Level::avx2: lanes_avx2<Kahan, Dot>(x, y, n, sums, compensations); return;
+        case simd::Level::scalar: break;
+    }
+#endif
+    lanes_scalar<Kahan, Dot>(x, y, n, sums, compensations);
+}
+
+// The contiguous inputs of a sum (y is null) or dot product that the kernels compute.
+template<class T, bool Dot>
+struct KernelInput {
+    const T* x;
+    const T* y;
+};
+
+// Combines leaf(lo), ..., leaf(hi - 1) by a balanced binary tree, splitting at
+// the middle; in parallel for large subtrees if 'parallel'.
+template<class Acc, class Leaf, class Combine>
+Acc reduce_tree(std::size_t lo, std::size_t hi, const Leaf& leaf, const Combine& combine, bool parallel) {
+    if (hi - lo == 1) return leaf(lo);
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (parallel && (hi - lo) * leaf_size >= parallel_min_size) {
+        std::optional<Acc> left, right;
+        tbb::parallel_invoke([&]{ left = reduce_tree<Acc>(lo, mid, leaf, combine, parallel); },
+                             [&]{ right = reduce_tree<Acc>(mid, hi, leaf, combine, parallel); });
+        return combine(std::move(*left), std::move(*right));
+    }
+    Acc left = reduce_tree<Acc>(lo, mid, leaf, combine, parallel);
+    return combine(std::move(left), reduce_tree<Acc>(mid, hi, leaf, combine, parallel));
+}
+
+// Reduces value(0), ..., value(n - 1) with op in the order described at the top
+// of the file, then combines init with the result. Kernel is a KernelInput, or
+// std::nullptr_t to always use the generic loop.
+template<bool Kahan, class T, class BinaryOp, class Value, class Kernel>
+T reduce_values(std::size_t n, T init, BinaryOp& op, const Value& value, Kernel kernel) {
+    if (n == 0) return init;
+    constexpr std::size_t lanes = lane_count<T>;
+    using Acc = std::conditional_t<Kahan, Compensated<T>, T>;
+
+    const auto combine = [&](Acc a, Acc b) -> Acc {
+        if constexpr (Kahan) return compensated_add(a, b);
+        else return op(std::move(a), std::move(b));
+    };
+    const auto leaf = [&](std::size_t l) -> Acc {
+        const std::size_t begin = l * leaf_size;
+        const std::size_t count = std::min(leaf_size, n - begin);
+        std::vector<Acc> acc;
+        acc.reserve(std::min(lanes, count));
+        std::size_t i = 0;
+        if constexpr (!std::is_null_pointer_v<Kernel>) {
+            if (count >= lanes) {
+                constexpr bool dot = std::is_same_v<Kernel, KernelInput<T, true>>;
+                T sums[lanes];
+                T compensations[lanes];
+                i = count / lanes * lanes;
+                lanes_vectorized<Kahan, dot>(kernel.x + begin, dot ? kernel.y + begin : nullptr, i, sums, compensations);
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    if constexpr (Kahan) acc.push_back({sums[k], compensations[k]});
+                    else acc.push_back(sums[k]);
+                }
+            }
+        }
+        if (i == 0) {
+            for (; i < std::min(lanes, count); ++i) {
+                if constexpr (Kahan) acc.push_back({T(value(begin + i)), T(0)});
+                else acc.push_back(T(value(begin + i)));
+            }
+        }
+        const auto add = [&](Acc& a, std::size_t j) {
+            if constexpr (Kahan) kahan_add(a.sum, a.compensation, T(value(begin + j)));
+            else a = op(std::move(a), value(begin + j));
+        };
+        for (; i + lanes <= count; i += lanes) {
+            for (std::size_t k = 0; k < lanes; ++k) add(acc[k], i + k);
+        }
+        for (; i < count; ++i) add(acc[i % lanes], i);
+        return reduce_tree<Acc>(0, acc.size(), [&](std::size_t k){ return acc[k]; }, combine, false);
+    };
+
+    const std::size_t num_threads = tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    Acc total = reduce_tree<Acc>(0, (n + leaf_size - 1) / leaf_size, leaf, combine, num_threads > 1);
+    if constexpr (Kahan) return op(std::move(init), total.sum - total.compensation);
+    else return op(std::move(init), std::move(total));
+}
+
+template<class T, class BinaryOp, class Value, class Kernel>
+T reduce_values(std::size_t n, T init, BinaryOp& op, const Value& value, Kernel kernel, Summation summation) {
+    if constexpr (std::is_floating_point_v<T> && is_plus_v<T, BinaryOp>) {
+        if (summation == Summation::kahan) return reduce_values<true>(n, std::move(init), op, value, kernel);
+    }
+    return reduce_values<false>(n, std::move(init), op, value, kernel);
+}
+
+} // namespace detail
+
+template<std::random_access_iterator It, class T, class BinaryOp, class UnaryOp>
+T transform_reduce(It first, It last, T init, BinaryOp reduce, UnaryOp transform, Summation summation = Summation::pairwise) {
+    const auto value = [&](std::size_t i) -> decltype(auto) { return std::invoke(transform, first[i]); };
+    const auto n = static_cast<std::size_t>(last - first);
+    if constexpr (detail::is_sum_kernel_v<T, It, BinaryOp, UnaryOp>) {
+        const detail::KernelInput<T, false> kernel{std::to_address(first), nullptr};
+        return detail::reduce_values(n, std::move(init), reduce, value, kernel, summation);
+    } else {
+        return detail::reduce_values(n, std::move(init), reduce, value, nullptr, summation);
+    }
+}
+
+template<std::random_access_iterator It1, std::random_access_iterator It2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce(It1 first1, It1 last1, It2 first2, T init, BinaryOp1 reduce, BinaryOp2 transform,
+                   Summation summation = Summation::pairwise) {
+    const auto value = [&](std::size_t i) -> decltype(auto) { return std::invoke(transform, first1[i], first2[i]); };
+    const auto n = static_cast<std::size_t>(last1 - first1);
+    if constexpr (detail::is_dot_kernel_v<T, It1, It2, BinaryOp1, BinaryOp2>) {
+        const detail::KernelInput<T, true> kernel{std::to_address(first1), std::to_address(first2)};
+        return detail::reduce_values(n, std::move(init), reduce, value, kernel, summation);
+    } else {
+        return detail::reduce_values(n, std::move(init), reduce, value, nullptr, summation);
+    }
+}
+
+template<std::random_access_iterator It1, std::random_access_iterator It2, class T>
+T transform_reduce(It1 first1, It1 last1, It2 first2, T init, Summation summation = Summation::pairwise) {
+    return deterministic::transform_reduce(first1, last1, first2, std::move(init), std::plus<>(), std::multiplies<>(), summation);
+}
+
+template<std::random_access_iterator It, class T, class BinaryOp = std::plus<>>
+T reduce(It first, It last, T init, BinaryOp op = {}, Summation summation = Summation::pairwise) {
+    return deterministic::transform_reduce(first, last, std::move(init), op, std::identity(), summation);
+}
+
+template<std::random_access_iterator It>
+std::iter_value_t<It> reduce(It first, It last) {
+    return deterministic::reduce(first, last, std::iter_value_t<It>{});
+}
+
+// Same as reduce: the elements are not combined left to right as by std::accumulate.
+template<std::random_access_iterator It, class T, class BinaryOp = std::plus<>>
+T accumulate(It first, It last, T init, BinaryOp op = {}, Summation summation = Summation::pairwise) {
+    return deterministic::reduce(first, last, std::move(init), op, summation);
+}
+
+template<std::random_access_iterator It1, std::random_access_iterator It2, class T>
+T inner_product(It1 first1, It1 last1, It2 first2, T init, Summation summation = Summation::pairwise) {
+    return deterministic::transform_reduce(first1, last1, first2, std::move(init), summation);
+}
+
+template<std::random_access_iterator It1, std::random_access_iterator It2, class T, class BinaryOp1, class BinaryOp2>
+T inner_product(It1 first1, It1 last1, It2 first2, T init, BinaryOp1 op1, BinaryOp2 op2, Summation summation = Summation::pairwise) {
+    return deterministic::transform_reduce(first1, last1, first2, std::move(init), op1, op2, summation);
+}
+
+} // namespace stl_examples::deterministic
+
+#endif // STL_EXAMPLES_PARALLEL_REDUCE_H
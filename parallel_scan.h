@@ -0,0 +1,334 @@
+#ifndef STL_EXAMPLES_PARALLEL_SCAN_H
+#define STL_EXAMPLES_PARALLEL_SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/parallel_for.h>
+
+#include "simd_dispatch.h"
+
+// Prefix scans for very large arrays, with the same arguments as std::inclusive_scan,
+// exclusive_scan, transform_inclusive_scan, transform_exclusive_scan, and partial_sum.
+//
+//       std::vector<long long> offsets(sizes.size());
+//       scan::exclusive_scan(sizes.cbegin(), sizes.cend(), offsets.begin(), 0LL);
+//
+// Unlike the std versions, the output must be a random-access range of n elements
+// (a pre-sized vector, an array, or the input itself), not a back_inserter.
+//
+// Large inputs are scanned in two passes over blocks spread across the TBB threads
+// (see parallel::ThreadLimit): the first reduces each block, the second scans each
+// block starting from the combined sums of the blocks before it. The operator must
+// therefore be associative, as for std::inclusive_scan, but need not be commutative.
+//
+// Integer sums with std::plus into a contiguous output of 32- or 64-bit integers
+// are computed in SIMD registers, 8 or 16 elements at a time.
+namespace stl_examples::scan {
+
+namespace detail {
+
+// Inputs shorter than this are scanned on the calling thread.
+inline constexpr std::size_t min_block_size = 1 << 16;
+// More blocks than threads, so that threads that finish early can take another.
+inline constexpr std::size_t blocks_per_thread = 4;
+// Transform scans, and scans that convert the elements to a wider type, write this
+// many converted elements to the output, then scan them while they are in L1.
+inline constexpr std::size_t transform_chunk_size = 2048;
+
+template<class T, class BinaryOp>
+inline constexpr bool is_plus_v = std::is_same_v<BinaryOp, std::plus<>> || std::is_same_v<BinaryOp, std::plus<T>>;
+
+template<class InIt, class UnaryOp>
+using transform_value_t = std::decay_t<std::invoke_result_t<UnaryOp&, std::iter_reference_t<InIt>>>;
+
+// True if the block scan of InIt into OutIt can use the SIMD kernels. Integer
+// additions wrap, so converting each element to T before adding it gives the
+// same sums as std, whatever the input integer type.
+template<class T, class InIt, class OutIt, class BinaryOp, class UnaryOp>
+inline constexpr bool is_vectorizable_v =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8) &&
+        is_plus_v<T, BinaryOp> && std::contiguous_iterator<OutIt> && std::is_same_v<std::iter_value_t<OutIt>, T> &&
+        std::is_integral_v<transform_value_t<InIt, UnaryOp>>;
+
+#if STL_EXAMPLES_SIMD_X86
+// The kernels add S lanes (int32_t or int64_t), loaded from Src elements of the
+// same width, or from 32-bit elements widened to 64 bits.
+
+template<class S>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_add(__m256i a, __m256i b) {
+    if constexpr (sizeof(S) == 4) return _mm256_add_epi32(a, b);
+    else return _mm256_add_epi64(a, b);
+}
+
+template<class S>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_sub(__m256i a, __m256i b) {
+    if constexpr (sizeof(S) == 4) return _mm256_sub_epi32(a, b);
+    else return _mm256_sub_epi64(a, b);
+}
+
+template<class S, class Src>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_load(const Src* p) {
+    if constexpr (sizeof(Src) == sizeof(S)) return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    else if constexpr (std::is_signed_v<Src>) return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    else return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+// Inclusive scan of the lanes of x: log2(lanes) steps, each adding x shifted up
+// by 1, 2, 4, ... elements, with zeros shifted in.
+template<class S>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_scan(__m256i x) {
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int shift = sizeof(S) / 4; shift < 8; shift *= 2) {
+        const __m256i from = _mm256_sub_epi32(iota, _mm256_set1_epi32(shift));
+        const __m256i keep = _mm256_cmpgt_epi32(iota, _mm256_set1_epi32(shift - 1));
+        x = avx2_add<S>(x, _mm256_and_si256(_mm256_permutevar8x32_epi32(x, from), keep));
+    }
+    return x;
+}
+
+// Scans the first n - n % lanes elements of src into dst, which may equal src.
+// Returns the number of elements scanned, and updates 'carry'.
+template<class S, class Src, bool Inclusive>
+STL_EXAMPLES_TARGET_AVX2 std::size_t scan_avx2(const Src* src, S* dst, std::size_t n, S& carry) {
+    constexpr std::size_t lanes = 32 / sizeof(S);
+    const __m256i last = sizeof(S) == 4 ? _mm256_set1_epi32(7) : _mm256_setr_epi32(6, 7, 6, 7, 6, 7, 6, 7);
+    __m256i running = sizeof(S) == 4 ? _mm256_set1_epi32(static_cast<int>(carry)) : _mm256_set1_epi64x(carry);
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i x = avx2_load<S>(src + i);
+        const __m256i prefix = avx2_scan<S>(x);
+        const __m256i sums = avx2_add<S>(prefix, running);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), Inclusive ? sums : avx2_sub<S>(sums, x));
+        // Adding the total of this vector, rather than broadcasting the last sum,
+        // leaves a single addition per vector on the path from one carry to the next.
+        running = avx2_add<S>(running, _mm256_permutevar8x32_epi32(prefix, last));
+    }
+    if (i > 0) carry = static_cast<S>(_mm_cvtsi128_si64(_mm256_castsi256_si128(running)));
+    return i;
+}
+
+// The AVX-512 kernels use the zero-masked forms of the conversions, permutes and
+// extract, with every lane kept: GCC 12 warns that the unmasked ones read an
+// uninitialized register.
+template<class S>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_add(__m512i a, __m512i b) {
+    if constexpr (sizeof(S) == 4) return _mm512_add_epi32(a, b);
+    else return _mm512_add_epi64(a, b);
+}
+
+template<class S>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_sub(__m512i a, __m512i b) {
+    if constexpr (sizeof(S) == 4) return _mm512_sub_epi32(a, b);
+    else return _mm512_sub_epi64(a, b);
+}
+
+template<class S, class Src>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_load(const Src* p) {
+    if constexpr (sizeof(Src) == sizeof(S)) return _mm512_loadu_si512(p);
+    else if constexpr (std::is_signed_v<Src>) return _mm512_maskz_cvtepi32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    else return _mm512_maskz_cvtepu32_epi64(0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+// Every lane set to the last lane of x.
+template<class S>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_broadcast_last(__m512i x) {
+    if constexpr (sizeof(S) == 4) return _mm512_maskz_permutexvar_epi32(0xffff, _mm512_set1_epi32(15), x);
+    else return _mm512_maskz_permutexvar_epi64(0xff, _mm512_set1_epi64(7), x);
+}
+
+template<class S>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_scan(__m512i x) {
+    constexpr int lanes = 64 / sizeof(S);
+    for (int shift = 1; shift < lanes; shift *= 2) {
+        if constexpr (sizeof(S) == 4) {
+            const __m512i from = _mm512_sub_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                                  _mm512_set1_epi32(shift));
+            x = _mm512_add_epi32(x, _mm512_maskz_permutexvar_epi32(static_cast<__mmask16>(0xffffu << shift), from, x));
+        } else {
+            const __m512i from = _mm512_sub_epi64(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7), _mm512_set1_epi64(shift));
+            x = _mm512_add_epi64(x, _mm512_maskz_permutexvar_epi64(static_cast<__mmask8>(0xffu << shift), from, x));
+        }
+    }
+    return x;
+}
+
+template<class S, class Src, bool Inclusive>
+STL_EXAMPLES_TARGET_AVX512 std::size_t scan_avx512(const Src* src, S* dst, std::size_t n, S& carry) {
+    constexpr std::size_t lanes = 64 / sizeof(S);
+    __m512i running = sizeof(S) == 4 ? _mm512_set1_epi32(static_cast<int>(carry)) : _mm512_set1_epi64(carry);
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const __m512i x = avx512_load<S>(src + i);
+        const __m512i prefix = avx512_scan<S>(x);
+        const __m512i sums = avx512_add<S>(prefix, running);
+        _mm512_storeu_si512(dst + i, Inclusive ? sums : avx512_sub<S>(sums, x));
+        running = avx512_add<S>(running, avx512_broadcast_last<S>(prefix));
+    }
+    if (i > 0) carry = static_cast<S>(_mm_cvtsi128_si64(_mm512_maskz_extracti32x4_epi32(0xf, running, 0)));
+    return i;
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// True if the kernels can load Src elements directly into T lanes.
+template<class T, class Src>
+inline constexpr bool is_kernel_input_v =
+        std::is_integral_v<Src> && !std::is_same_v<Src, bool> && (sizeof(Src) == sizeof(T) || (sizeof(Src) == 4 && sizeof(T) == 8));
+
+// Dispatches to the best kernel for the current Level. Returns the number of
+// elements scanned, a multiple of the vector width; the caller scans the rest.
+template<bool Inclusive, class T, class Src>
+std::size_t scan_vectorized(const Src* src, T* dst, std::size_t n, T& carry) {
+#if STL_EXAMPLES_SIMD_X86
+    // Additions wrap the same way for signed and unsigned lanes. Only the
+    // signedness of narrower inputs matters, to widen them correctly.
+    using S = std::make_signed_t<T>;
+    using Lane = std::conditional_t<sizeof(Src) == sizeof(T), S, Src>;
+    const Lane* s = reinterpret_cast<const Lane*>(src);
+    S* d = reinterpret_cast<S*>(dst);
+    S c = static_cast<S>(carry);
+    std::size_t done = 0;
+    switch (simd::level()) {
+        case simd::Level::avx512: done = scan_avx512<S, Lane, Inclusive>(s, d, n, c); break;
+        case simd::Level::avx2: done = scan_avx2<S, Lane, Inclusive>(s, d, n, c); break;
+        case simd::Level::scalar: break;
+    }
+    carry = static_cast<T>(c);
+    return done;
+#else
+    return 0;
+#endif
+}
+
+// Scans n elements from 'first' into 'out', continuing from 'carry'.
+// An empty 'carry' starts an inclusive scan without an initial value.
+template<bool Inclusive, class T, class InIt, class OutIt, class BinaryOp, class UnaryOp>
+void scan_block(InIt first, std::size_t n, OutIt out, std::optional<T> carry, BinaryOp& op, UnaryOp& unary) {
+    std::size_t i = 0;
+    if (!carry) {
+        if (n == 0) return;
+        carry = T(std::invoke(unary, *first));
+        *out = *carry;
+        i = 1;
+    }
+    T acc = std::move(*carry);
+    // Copies x before writing the result, so the output may be the input.
+    const auto step = [&](auto x, auto&& result) {
+        if constexpr (Inclusive) {
+            acc = op(std::move(acc), std::move(x));
+            result = acc;
+        } else {
+            result = acc;
+            acc = op(std::move(acc), std::move(x));
+        }
+    };
+
+    if constexpr (is_vectorizable_v<T, InIt, OutIt, BinaryOp, UnaryOp>) {
+        T* dst = std::to_address(out);
+        if constexpr (std::is_same_v<UnaryOp, std::identity> && std::contiguous_iterator<InIt> &&
+                      is_kernel_input_v<T, std::iter_value_t<InIt>>) {
+            i += scan_vectorized<Inclusive>(std::to_address(first) + i, dst + i, n - i, acc);
+        } else {
+            while (i < n) {
+                const std::size_t end = i + std::min(transform_chunk_size, n - i);
+                std::transform(first + i, first + end, dst + i, [&](const auto& x){ return static_cast<T>(std::invoke(unary, x)); });
+                i += scan_vectorized<Inclusive>(dst + i, dst + i, end - i, acc);
+                for (; i < end; ++i) step(dst[i], dst[i]);
+            }
+            return;
+        }
+    }
+
+    for (; i < n; ++i) step(std::invoke(unary, first[i]), out[i]);
+}
+
+// Combines the n elements from 'first', left to right.
+template<class T, class InIt, class BinaryOp, class UnaryOp>
+T reduce_block(InIt first, std::size_t n, BinaryOp& op, UnaryOp& unary) {
+    T acc(std::invoke(unary, first[0]));
+    for (std::size_t i = 1; i < n; ++i) acc = op(std::move(acc), std::invoke(unary, first[i]));
+    return acc;
+}
+
+template<bool Inclusive, class T, class InIt, class OutIt, class BinaryOp, class UnaryOp>
+OutIt scan(InIt first, InIt last, OutIt d_first, std::optional<T> init, BinaryOp op, UnaryOp unary) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t num_threads = tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    const std::size_t num_blocks = std::min(num_threads * blocks_per_thread, n / min_block_size);
+    if (num_threads <= 1 || num_blocks <= 1) {
+        scan_block<Inclusive>(first, n, d_first, std::move(init), op, unary);
+        return d_first + n;
+    }
+    const auto block_begin = [&](std::size_t b){ return n / num_blocks * b + std::min(b, n % num_blocks); };
+
+    // First pass: carries[b + 1] is the reduction of block b. The last block is not needed.
+    std::vector<std::optional<T>> carries(num_blocks);
+    tbb::parallel_for(std::size_t{0}, num_blocks - 1, [&](std::size_t b) {
+        const std::size_t begin = block_begin(b);
+        carries[b + 1] = reduce_block<T>(first + begin, block_begin(b + 1) - begin, op, unary);
+    });
+
+    // carries[b] becomes everything before block b, combined in order.
+    carries[0] = std::move(init);
+    for (std::size_t b = 1; b < num_blocks; ++b) {
+        if (carries[b - 1]) carries[b] = op(*carries[b - 1], std::move(*carries[b]));
+    }
+
+    // Second pass: each block is scanned independently from its carry.
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t b) {
+        const std::size_t begin = block_begin(b);
+        scan_block<Inclusive>(first + begin, block_begin(b + 1) - begin, d_first + begin, std::move(carries[b]), op, unary);
+    });
+    return d_first + n;
+}
+
+} // namespace detail
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class BinaryOp, class UnaryOp>
+OutIt transform_inclusive_scan(InIt first, InIt last, OutIt d_first, BinaryOp op, UnaryOp unary) {
+    using T = detail::transform_value_t<InIt, UnaryOp>;
+    return detail::scan<true, T>(first, last, d_first, std::nullopt, op, unary);
+}
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class BinaryOp, class UnaryOp, class T>
+OutIt transform_inclusive_scan(InIt first, InIt last, OutIt d_first, BinaryOp op, UnaryOp unary, T init) {
+    return detail::scan<true, T>(first, last, d_first, std::optional<T>(std::move(init)), op, unary);
+}
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class T, class BinaryOp, class UnaryOp>
+OutIt transform_exclusive_scan(InIt first, InIt last, OutIt d_first, T init, BinaryOp op, UnaryOp unary) {
+    return detail::scan<false, T>(first, last, d_first, std::optional<T>(std::move(init)), op, unary);
+}
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class BinaryOp = std::plus<>>
+OutIt inclusive_scan(InIt first, InIt last, OutIt d_first, BinaryOp op = {}) {
+    return transform_inclusive_scan(first, last, d_first, op, std::identity());
+}
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class BinaryOp, class T>
+OutIt inclusive_scan(InIt first, InIt last, OutIt d_first, BinaryOp op, T init) {
+    return transform_inclusive_scan(first, last, d_first, op, std::identity(), std::move(init));
+}
+
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class T, class BinaryOp = std::plus<>>
+OutIt exclusive_scan(InIt first, InIt last, OutIt d_first, T init, BinaryOp op = {}) {
+    return transform_exclusive_scan(first, last, d_first, std::move(init), op, std::identity());
+}
+
+// Same as inclusive_scan: for an associative operator, the order in which
+// std::partial_sum combines the elements gives the same result.
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, class BinaryOp = std::plus<>>
+OutIt partial_sum(InIt first, InIt last, OutIt d_first, BinaryOp op = {}) {
+    return inclusive_scan(first, last, d_first, op);
+}
+
+} // namespace stl_examples::scan
+
+#endif // STL_EXAMPLES_PARALLEL_SCAN_H
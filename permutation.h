@@ -0,0 +1,206 @@
+#ifndef STL_EXAMPLES_PERMUTATION_H
+#define STL_EXAMPLES_PERMUTATION_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "radix_sort.h"
+#include "simd_compare.h"
+
+// A drop-in replacement for std::is_permutation that is not quadratic, and
+// multiset_equal, the same test on two whole ranges, as when reconciling two
+// batches of records that should hold the same ids in any order:
+//
+//       if (!adaptive::multiset_equal(sent_ids, received_ids)) { ... }
+//
+// std::is_permutation counts the matches of each element in both ranges, which is
+// O(n^2) comparisons when the ranges are in different orders. When the elements
+// are compared with std::equal_to, this picks an algorithm from the element type
+// and the size of the ranges instead:
+//
+//   - Below permutation_small_size elements, std::is_permutation, which needs no
+//     memory.
+//   - For 8-bit integers (and 16-bit ones, from histogram_min_size elements on),
+//     a histogram of the values: +1 for each element of the first range, -1 for
+//     each of the second. O(n).
+//   - For other integers, floats, and doubles, the sum and the xor of the elements
+//     of each range first: when they differ, the ranges are not permutations of
+//     each other, without further work. Otherwise, both ranges are copied, radix
+//     sorted, and compared. O(n).
+//   - For other types with a std::hash, the number of copies of each element of
+//     the first range, in a hash map, less those of the second. O(n) expected.
+//   - Anything else, and any other predicate, uses std::is_permutation.
+//
+// Every variant returns what std::is_permutation does: -0.0 equals 0.0, and any
+// NaN makes the result false, as with std::is_permutation.
+namespace stl_examples::adaptive {
+
+namespace detail {
+
+// Below this many elements, the quadratic std::is_permutation is faster than
+// building counts or sorted copies.
+inline constexpr std::size_t permutation_small_size = 32;
+
+// A histogram of 16-bit values pays for clearing its 64K counts from this many elements.
+inline constexpr std::size_t histogram_min_size = std::size_t{1} << 12;
+
+template<class T>
+inline constexpr bool is_histogram_key_v = std::is_integral_v<T> && sizeof(T) <= 2;
+
+template<class T>
+concept hashable = requires(const T& x) {
+    { std::hash<T>{}(x) } -> std::convertible_to<std::size_t>;
+};
+
+// True if is_permutation on [It1, It1) and [It2, It2) with 'Pred' can count
+// the elements instead.
+template<class It1, class It2, class Pred>
+inline constexpr bool is_counted_permutation_v =
+        std::is_same_v<std::iter_value_t<It1>, std::iter_value_t<It2>> &&
+        (std::is_same_v<Pred, std::equal_to<>> || std::is_same_v<Pred, std::equal_to<std::iter_value_t<It1>>>);
+
+template<class T>
+std::size_t histogram_index(T x) {
+    if constexpr (std::is_same_v<T, bool>) return x ? 1 : 0;
+    else return static_cast<std::make_unsigned_t<T>>(x);
+}
+
+template<class It1, class It2>
+bool histogram_equal(It1 first1, It1 last1, It2 first2, It2 last2) {
+    using T = std::iter_value_t<It1>;
+    std::vector<std::int64_t> counts(std::size_t{1} << (8 * sizeof(T)));
+    for (; first1 != last1; ++first1) ++counts[histogram_index<T>(*first1)];
+    for (; first2 != last2; ++first2) {
+        if (--counts[histogram_index<T>(*first2)] < 0) return false;
+    }
+    // As many elements in both ranges, and no count below zero: every count is zero.
+    return true;
+}
+
+// The sum and the xor of the bits of the elements of a range, equal for any two
+// permutations of the same elements. 'unordered' is set if there is a NaN.
+struct fingerprint {
+    std::uint64_t sum = 0;
+    std::uint64_t bits = 0;
+    bool unordered = false;
+
+    bool operator==(const fingerprint&) const = default;
+};
+
+template<class It>
+fingerprint fingerprint_of(It first, It last) {
+    using T = std::iter_value_t<It>;
+    fingerprint f;
+    for (; first != last; ++first) {
+        T x = *first;
+        std::uint64_t bits;
+        if constexpr (std::is_floating_point_v<T>) {
+            f.unordered |= x != x;
+            // -0.0 equals 0.0, so they must have the same bits.
+            if (x == T{0}) x = T{0};
+            bits = std::bit_cast<typename stl_examples::detail::unsigned_of_size<sizeof(T)>::type>(x);
+        } else {
+            bits = static_cast<std::make_unsigned_t<T>>(x);
+        }
+        f.sum += bits;
+        f.bits ^= bits;
+    }
+    return f;
+}
+
+template<class It1, class It2>
+bool sorted_equal(It1 first1, It1 last1, It2 first2, It2 last2) {
+    using T = std::iter_value_t<It1>;
+    std::vector<T> a(first1, last1);
+    std::vector<T> b(first2, last2);
+    stl_examples::radix_sort(a.begin(), a.end());
+    stl_examples::radix_sort(b.begin(), b.end());
+    // -0.0 sorts before 0.0, but the zeros are next to each other, and compare equal.
+    return simd::equal(a.cbegin(), a.cend(), b.cbegin());
+}
+
+template<class It1, class It2>
+bool hash_counts_equal(It1 first1, It1 last1, It2 first2, It2 last2, std::size_t n) {
+    using T = std::iter_value_t<It1>;
+    // Keyed by the address of the first copy of each element, so that nothing is copied.
+    const auto hash = [](const T* x) { return std::hash<T>{}(*x); };
+    const auto equal = [](const T* x, const T* y) { return *x == *y; };
+    std::unordered_map<const T*, std::ptrdiff_t, decltype(hash), decltype(equal)> counts(n, hash, equal);
+    for (; first1 != last1; ++first1) ++counts[std::addressof(*first1)];
+    for (; first2 != last2; ++first2) {
+        const auto it = counts.find(std::addressof(*first2));
+        if (it == counts.end() || --it->second < 0) return false;
+    }
+    return true;
+}
+
+// is_permutation of two ranges of n elements each, with no common prefix.
+template<class It1, class It2>
+bool counted_is_permutation(It1 first1, It1 last1, It2 first2, It2 last2, std::size_t n) {
+    using T = std::iter_value_t<It1>;
+    if (n < permutation_small_size) return std::is_permutation(first1, last1, first2, last2);
+    if constexpr (is_histogram_key_v<T>) {
+        if (sizeof(T) == 1 || n >= histogram_min_size) return histogram_equal(first1, last1, first2, last2);
+    }
+    if constexpr (stl_examples::detail::is_radix_key_v<T>) {
+        const fingerprint f1 = fingerprint_of(first1, last1);
+        const fingerprint f2 = fingerprint_of(first2, last2);
+        if (f1.unordered || f2.unordered || f1 != f2) return false;
+        return sorted_equal(first1, last1, first2, last2);
+    } else if constexpr (hashable<T> && std::is_lvalue_reference_v<std::iter_reference_t<It1>> &&
+                         std::is_lvalue_reference_v<std::iter_reference_t<It2>>) {
+        return hash_counts_equal(first1, last1, first2, last2, n);
+    } else {
+        return std::is_permutation(first1, last1, first2, last2);
+    }
+}
+
+} // namespace detail
+
+template<class ForwardIt1, class ForwardIt2, class BinaryPred>
+bool is_permutation(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, BinaryPred pred) {
+    if constexpr (detail::is_counted_permutation_v<ForwardIt1, ForwardIt2, BinaryPred>) {
+        // Skips the common prefix, as std::is_permutation does.
+        std::tie(first1, first2) = simd::mismatch(first1, last1, first2, last2);
+        const auto n = std::distance(first1, last1);
+        if (n != std::distance(first2, last2)) return false;
+        return detail::counted_is_permutation(first1, last1, first2, last2, static_cast<std::size_t>(n));
+    } else {
+        return std::is_permutation(first1, last1, first2, last2, pred);
+    }
+}
+
+template<class ForwardIt1, class ForwardIt2>
+bool is_permutation(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2) {
+    return adaptive::is_permutation(first1, last1, first2, last2, std::equal_to<>());
+}
+
+template<class ForwardIt1, class ForwardIt2, class BinaryPred>
+bool is_permutation(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, BinaryPred pred) {
+    return adaptive::is_permutation(first1, last1, first2, std::next(first2, std::distance(first1, last1)), pred);
+}
+
+template<class ForwardIt1, class ForwardIt2>
+bool is_permutation(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2) {
+    return adaptive::is_permutation(first1, last1, first2, std::equal_to<>());
+}
+
+// True if the two ranges hold the same elements, as many times each, in any order.
+template<class Range1, class Range2>
+bool multiset_equal(const Range1& r1, const Range2& r2) {
+    return adaptive::is_permutation(std::begin(r1), std::end(r1), std::begin(r2), std::end(r2));
+}
+
+} // namespace stl_examples::adaptive
+
+#endif // STL_EXAMPLES_PERMUTATION_H
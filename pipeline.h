@@ -0,0 +1,260 @@
+#ifndef STL_EXAMPLES_PIPELINE_H
+#define STL_EXAMPLES_PIPELINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+// Chains of algorithms that run in a single pass, without a vector between
+// each step. Instead of
+//
+//       std::vector<int> positive;
+//       std::copy_if(v.cbegin(), v.cend(), std::back_inserter(positive), is_positive);
+//       std::vector<long> squares;
+//       std::transform(positive.cbegin(), positive.cend(), std::back_inserter(squares), square);
+//       const long total = std::accumulate(squares.cbegin(), squares.cend(), 0L);
+//
+// the stages are C++20 views, each element flows through all of them in turn,
+// and a sink at the end consumes it:
+//
+//       const long total = v | std::views::filter(is_positive) | std::views::transform(square)
+//                            | pipeline::reduce(0L);
+//
+// Stages: std::views::filter, transform, take_while, and the other views, plus
+// pipeline::scan, a lazy inclusive scan. Sinks: pipeline::reduce, to_vector, and
+// to_pmr_vector, which allocates from a memory resource such as an arena.
+//
+// The parallel executor runs the same stages on chunks of a random-access range,
+// on the TBB threads (see parallel::ThreadLimit):
+//
+//       const auto stages = std::views::filter(is_positive) | std::views::transform(square);
+//       const long total = pipeline::parallel_reduce(v, stages, 0L);
+//
+// The chunks have a fixed size, and their results are combined in order, so the
+// result does not depend on the number of threads; the operator must be
+// associative, as for std::reduce. The stages must treat each element on its
+// own: a scan, or a take_while, would see each chunk as a range of its own.
+namespace stl_examples::pipeline {
+
+namespace detail {
+
+// Holds a function object, and makes it assignable even if it is not, as
+// lambdas with captures are not, so that views holding it stay views.
+template<class F>
+class Box {
+public:
+    explicit Box(F f) : f_(std::move(f)) {}
+    Box(const Box&) = default;
+    Box(Box&&) = default;
+    Box& operator=(const Box& other) {
+        if (this != &other) f_.emplace(*other.f_);
+        return *this;
+    }
+    Box& operator=(Box&& other) noexcept {
+        if (this != &other) f_.emplace(std::move(*other.f_));
+        return *this;
+    }
+
+    F& operator*() { return *f_; }
+    const F& operator*() const { return *f_; }
+
+private:
+    std::optional<F> f_;
+};
+
+// Elements per chunk of the parallel executor.
+inline constexpr std::size_t chunk_size = std::size_t{1} << 16;
+
+} // namespace detail
+
+// The running totals of a range: op(op(x0, x1), x2)... Like std::inclusive_scan,
+// the totals have the value type of the range.
+template<std::ranges::input_range V, class Op>
+    requires std::ranges::view<V>
+class scan_view : public std::ranges::view_interface<scan_view<V, Op>> {
+public:
+    using value_type = std::ranges::range_value_t<V>;
+
+    scan_view(V base, Op op) : base_(std::move(base)), op_(std::move(op)) {}
+
+    class iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = scan_view::value_type;
+        using difference_type = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        iterator(scan_view& parent, std::ranges::iterator_t<V> current, std::ranges::sentinel_t<V> end)
+            : parent_(&parent), current_(std::move(current)), end_(std::move(end)) {
+            if (current_ != end_) total_.emplace(*current_);
+        }
+
+        const value_type& operator*() const { return *total_; }
+
+        iterator& operator++() {
+            if (++current_ != end_) {
+                total_ = std::invoke(*parent_->op_, std::move(*total_), *current_);
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.current_ == it.end_;
+        }
+
+    private:
+        scan_view* parent_ = nullptr;
+        std::ranges::iterator_t<V> current_{};
+        std::ranges::sentinel_t<V> end_{};
+        std::optional<value_type> total_;
+    };
+
+    iterator begin() { return iterator(*this, std::ranges::begin(base_), std::ranges::end(base_)); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+    V base_;
+    detail::Box<Op> op_;
+};
+
+template<class R, class Op>
+scan_view(R&&, Op) -> scan_view<std::views::all_t<R>, Op>;
+
+template<class Op>
+struct scan_stage {
+    Op op;
+};
+
+// A stage that replaces each element by the running total up to it.
+template<class Op = std::plus<>>
+scan_stage<Op> scan(Op op = {}) { return {std::move(op)}; }
+
+template<std::ranges::viewable_range R, class Op>
+auto operator|(R&& range, scan_stage<Op> stage) {
+    return scan_view(std::forward<R>(range), std::move(stage.op));
+}
+
+template<class T, class Op>
+struct reduce_sink {
+    T init;
+    Op op;
+};
+
+// A sink that folds the elements into init, from left to right, like std::accumulate.
+template<class T, class Op = std::plus<>>
+reduce_sink<T, Op> reduce(T init, Op op = {}) { return {std::move(init), std::move(op)}; }
+
+template<std::ranges::input_range R, class T, class Op>
+T operator|(R&& range, reduce_sink<T, Op> sink) {
+    T total = std::move(sink.init);
+    for (auto&& x : range) total = std::invoke(sink.op, std::move(total), std::forward<decltype(x)>(x));
+    return total;
+}
+
+struct to_vector_sink {};
+
+// A sink that collects the elements into a std::vector.
+inline constexpr to_vector_sink to_vector;
+
+template<std::ranges::input_range R>
+std::vector<std::ranges::range_value_t<R>> operator|(R&& range, to_vector_sink) {
+    std::vector<std::ranges::range_value_t<R>> result;
+    if constexpr (std::ranges::sized_range<R>) result.reserve(std::ranges::size(range));
+    for (auto&& x : range) result.push_back(std::forward<decltype(x)>(x));
+    return result;
+}
+
+struct to_pmr_vector_sink {
+    std::pmr::memory_resource* resource;
+};
+
+// A sink that collects the elements into a std::pmr::vector allocated from 'resource'.
+inline to_pmr_vector_sink to_pmr_vector(std::pmr::memory_resource* resource) { return {resource}; }
+
+template<std::ranges::input_range R>
+std::pmr::vector<std::ranges::range_value_t<R>> operator|(R&& range, to_pmr_vector_sink sink) {
+    std::pmr::vector<std::ranges::range_value_t<R>> result(sink.resource);
+    if constexpr (std::ranges::sized_range<R>) result.reserve(std::ranges::size(range));
+    for (auto&& x : range) result.push_back(std::forward<decltype(x)>(x));
+    return result;
+}
+
+namespace detail {
+
+// Runs 'consume(chunk, stages(subrange of the chunk))' for every chunk, in parallel.
+template<class R, class Stages, class Consume>
+void for_each_chunk(R& range, Stages& stages, std::size_t num_chunks, Consume consume) {
+    const auto first = std::ranges::begin(range);
+    const auto n = static_cast<std::size_t>(std::ranges::distance(range));
+    tbb::parallel_for(std::size_t{0}, num_chunks, [&](std::size_t chunk) {
+        const std::size_t lo = chunk * chunk_size;
+        const std::size_t hi = std::min(n, lo + chunk_size);
+        using Difference = std::ranges::range_difference_t<R>;
+        auto chunk_range = std::ranges::subrange(first + static_cast<Difference>(lo), first + static_cast<Difference>(hi));
+        consume(chunk, std::invoke(stages, chunk_range));
+    });
+}
+
+template<class R, class Stages>
+using stage_output_t = std::invoke_result_t<Stages&, std::ranges::subrange<std::ranges::iterator_t<R>>>;
+
+} // namespace detail
+
+// Like range | stages | reduce(init, op), on chunks of the range in parallel.
+// Each chunk is reduced on its own, starting from its first element, and the
+// chunk totals are then folded into init in order.
+template<std::ranges::random_access_range R, class Stages, class T, class Op = std::plus<>>
+T parallel_reduce(R&& range, Stages stages, T init, Op op = {}) {
+    const auto n = static_cast<std::size_t>(std::ranges::distance(range));
+    const std::size_t num_chunks = (n + detail::chunk_size - 1) / detail::chunk_size;
+    std::vector<std::optional<T>> totals(num_chunks);
+    detail::for_each_chunk(range, stages, num_chunks, [&](std::size_t chunk, auto&& output) {
+        std::optional<T> total;
+        for (auto&& x : output) {
+            if (total) total = std::invoke(op, std::move(*total), std::forward<decltype(x)>(x));
+            else total.emplace(std::forward<decltype(x)>(x));
+        }
+        totals[chunk] = std::move(total);
+    });
+    for (auto& total : totals) {
+        if (total) init = std::invoke(op, std::move(init), std::move(*total));
+    }
+    return init;
+}
+
+// Like range | stages | to_vector, on chunks of the range in parallel. The
+// output of each chunk is collected on its own, then copied to its place.
+template<std::ranges::random_access_range R, class Stages>
+auto parallel_to_vector(R&& range, Stages stages) {
+    using Value = std::ranges::range_value_t<detail::stage_output_t<R, Stages>>;
+    const auto n = static_cast<std::size_t>(std::ranges::distance(range));
+    const std::size_t num_chunks = (n + detail::chunk_size - 1) / detail::chunk_size;
+    std::vector<std::vector<Value>> outputs(num_chunks);
+    detail::for_each_chunk(range, stages, num_chunks, [&](std::size_t chunk, auto&& output) {
+        outputs[chunk] = output | to_vector;
+    });
+
+    std::vector<std::size_t> offsets(num_chunks + 1, 0);
+    for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) offsets[chunk + 1] = offsets[chunk] + outputs[chunk].size();
+    std::vector<Value> result(offsets.back());
+    tbb::parallel_for(std::size_t{0}, num_chunks, [&](std::size_t chunk) {
+        std::move(outputs[chunk].begin(), outputs[chunk].end(), result.begin() + static_cast<std::ptrdiff_t>(offsets[chunk]));
+        outputs[chunk] = {};
+    });
+    return result;
+}
+
+} // namespace stl_examples::pipeline
+
+#endif // STL_EXAMPLES_PIPELINE_H
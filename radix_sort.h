@@ -0,0 +1,142 @@
+#ifndef STL_EXAMPLES_RADIX_SORT_H
+#define STL_EXAMPLES_RADIX_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+// LSD radix sort for integer and floating-point keys, as an alternative to
+// std::sort and std::qsort for large arrays.
+//
+//       radix_sort(v.begin(), v.end());                            // Like std::sort.
+//       radix_sort(v.begin(), v.end(), SortOrder::descending);     // Like std::sort with std::greater.
+//       radix_sort(people.begin(), people.end(), [](const Person& p){ return p.age; });
+//
+// The sort makes one counting pass over the keys, then one stable scatter pass
+// per byte of the key, skipping the bytes that are equal in every key. It never
+// compares elements, so it does O(n) work for any input order.
+//
+// The sort is stable. Floating-point keys are ordered by their IEEE-754 bits:
+// -0.0 sorts before +0.0, and NaNs sort after +infinity (or before -infinity, if
+// negative), so arrays containing NaN still come out in a well-defined order.
+namespace stl_examples {
+
+enum class SortOrder { ascending, descending };
+
+namespace detail {
+
+template<class Key>
+inline constexpr bool is_radix_key_v = (std::is_integral_v<Key> && !std::is_same_v<Key, bool>) ||
+                                       std::is_same_v<Key, float> || std::is_same_v<Key, double>;
+
+template<std::size_t Size>
+struct unsigned_of_size;
+template<> struct unsigned_of_size<1> { using type = std::uint8_t; };
+template<> struct unsigned_of_size<2> { using type = std::uint16_t; };
+template<> struct unsigned_of_size<4> { using type = std::uint32_t; };
+template<> struct unsigned_of_size<8> { using type = std::uint64_t; };
+
+template<class Key>
+using radix_bits_t = typename unsigned_of_size<sizeof(Key)>::type;
+
+// Maps 'key' to an unsigned integer with the same order.
+template<class Key>
+constexpr radix_bits_t<Key> radix_bits(Key key) {
+    using Bits = radix_bits_t<Key>;
+    constexpr Bits sign = Bits{1} << (sizeof(Key) * 8 - 1);
+    if constexpr (std::is_floating_point_v<Key>) {
+        // Negative floats are ordered backwards, so all of their bits are flipped.
+        const Bits bits = std::bit_cast<Bits>(key);
+        return (bits & sign) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+    } else if constexpr (std::is_signed_v<Key>) {
+        return static_cast<Bits>(static_cast<Bits>(key) ^ sign);
+    } else {
+        return static_cast<Bits>(key);
+    }
+}
+
+// Below this size, a comparison sort on the same keys is faster than the counting passes.
+inline constexpr std::size_t radix_sort_cutoff = 64;
+
+// Moves [src, src + n) into 'dst', ordered by the byte of each key at 'shift'.
+// 'offsets' holds the starting position of each byte value.
+template<class Src, class Dst, class BitsOf>
+void radix_scatter(Src src, Dst dst, std::size_t n, BitsOf bits_of, int shift, std::array<std::size_t, 256> offsets) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t digit = (bits_of(src[i]) >> shift) & 0xff;
+        dst[offsets[digit]++] = std::move(src[i]);
+    }
+}
+
+// Stable LSD radix sort of [first, first + n) by bits_of(element).
+template<class RandomIt, class BitsOf>
+void lsd_radix_sort(RandomIt first, std::size_t n, BitsOf bits_of) {
+    using T = std::iter_value_t<RandomIt>;
+    using Bits = std::invoke_result_t<BitsOf, const T&>;
+    constexpr int num_bytes = sizeof(Bits);
+
+    if (n < radix_sort_cutoff) {
+        std::stable_sort(first, first + n, [&](const T& a, const T& b){ return bits_of(a) < bits_of(b); });
+        return;
+    }
+
+    // Histograms for every byte, in a single pass over the keys.
+    std::array<std::array<std::size_t, 256>, num_bytes> counts{};
+    for (std::size_t i = 0; i < n; ++i) {
+        const Bits bits = bits_of(first[i]);
+        for (int b = 0; b < num_bytes; ++b) ++counts[b][(bits >> (8 * b)) & 0xff];
+    }
+
+    std::vector<T> buffer(n);
+    bool in_buffer = false;
+    const Bits first_bits = bits_of(first[0]);
+    for (int b = 0; b < num_bytes; ++b) {
+        // Every key has the same value in this byte, so the pass would not move anything.
+        if (counts[b][(first_bits >> (8 * b)) & 0xff] == n) continue;
+
+        std::array<std::size_t, 256> offsets;
+        std::exclusive_scan(counts[b].cbegin(), counts[b].cend(), offsets.begin(), std::size_t{0});
+        if (in_buffer) radix_scatter(buffer.begin(), first, n, bits_of, 8 * b, offsets);
+        else radix_scatter(first, buffer.begin(), n, bits_of, 8 * b, offsets);
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) std::move(buffer.begin(), buffer.end(), first);
+}
+
+} // namespace detail
+
+// Sorts the range [first, last) by key(element), which must return an integer or
+// floating-point type. Elements must be default constructible and movable.
+template<class RandomIt, class KeyFn>
+    requires std::invocable<KeyFn&, const std::iter_value_t<RandomIt>&>
+void radix_sort(RandomIt first, RandomIt last, KeyFn key, SortOrder order = SortOrder::ascending) {
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const std::iter_value_t<RandomIt>&>>;
+    static_assert(detail::is_radix_key_v<Key>, "radix_sort requires an integer or floating-point key");
+    const std::size_t n = last - first;
+    if (order == SortOrder::ascending) {
+        detail::lsd_radix_sort(first, n, [&](const auto& x){ return detail::radix_bits<Key>(std::invoke(key, x)); });
+    } else {
+        // Reversing the order of every key keeps equal keys in their original order.
+        detail::lsd_radix_sort(first, n, [&](const auto& x){
+            return static_cast<detail::radix_bits_t<Key>>(~detail::radix_bits<Key>(std::invoke(key, x)));
+        });
+    }
+}
+
+// Sorts a range of integers or floating-point numbers.
+template<class RandomIt>
+void radix_sort(RandomIt first, RandomIt last, SortOrder order = SortOrder::ascending) {
+    radix_sort(first, last, std::identity(), order);
+}
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_RADIX_SORT_H
@@ -0,0 +1,378 @@
+#ifndef STL_EXAMPLES_RANDOM_SAMPLING_H
+#define STL_EXAMPLES_RANDOM_SAMPLING_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/parallel_invoke.h>
+
+// Fast generators, and shuffling and sampling that scale to large inputs:
+//
+//       sampling::shuffle(v.begin(), v.end(), seed);              // Parallel, in place.
+//       sampling::Xoshiro256pp gen(seed);
+//       sampling::reservoir_sample(lines.begin(), lines.end(), out.begin(), k, gen);
+//       sampling::weighted_sample(items.begin(), items.end(), weights.begin(), out.begin(), k, gen);
+//
+// The generators satisfy std::uniform_random_bit_generator, so they also work
+// with std::shuffle and the <random> distributions. Unlike std::mt19937, whose
+// 2.5 KB state is slow to seed properly, they keep 16 or 32 bytes of state and
+// are seeded from a 64-bit seed and a stream number: the same pair always gives
+// the same sequence, on every platform, and different streams are unrelated.
+//
+// The algorithms draw bounded integers with Lemire's multiply-and-shift method
+// rather than std::uniform_int_distribution, which divides on every draw.
+namespace stl_examples::sampling {
+
+namespace detail {
+
+// The finalizer of SplitMix64: a bijection that scrambles every input bit into every output bit.
+constexpr std::uint64_t mix64(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+// Expands a seed into generator state, as the authors of xoshiro recommend.
+struct SplitMix64 {
+    std::uint64_t state;
+
+    constexpr std::uint64_t operator()() { return mix64(state += 0x9e3779b97f4a7c15); }
+};
+
+constexpr std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+} // namespace detail
+
+// xoshiro256++ (Blackman and Vigna): 64 bits per call, a period of 2^256 - 1.
+class Xoshiro256pp {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    explicit constexpr Xoshiro256pp(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+        detail::SplitMix64 expand{detail::mix64(seed) ^ stream};
+        for (auto& word : state_) word = expand();
+    }
+    // Starts from the given state, which must not be all zero.
+    explicit constexpr Xoshiro256pp(const std::array<std::uint64_t, 4>& state) : state_(state) {}
+
+    constexpr result_type operator()() {
+        auto& s = state_;
+        const std::uint64_t result = detail::rotl(s[0] + s[3], 23) + s[0];
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = detail::rotl(s[3], 45);
+        return result;
+    }
+
+    friend constexpr bool operator==(const Xoshiro256pp&, const Xoshiro256pp&) = default;
+
+private:
+    std::array<std::uint64_t, 4> state_{};
+};
+
+// PCG32, the XSH-RR variant (O'Neill): 32 bits per call from 64 bits of state.
+// Seeded like the reference pcg32_srandom_r(seed, stream).
+class Pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    explicit constexpr Pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0) : increment_((stream << 1) | 1) {
+        (*this)();
+        state_ += seed;
+        (*this)();
+    }
+
+    constexpr result_type operator()() {
+        const std::uint64_t old = state_;
+        state_ = old * 6364136223846793005 + increment_;
+        const auto xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rotation = static_cast<int>(old >> 59);
+        return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+    }
+
+    friend constexpr bool operator==(const Pcg32&, const Pcg32&) = default;
+
+private:
+    std::uint64_t state_ = 0;
+    std::uint64_t increment_;
+};
+
+// 64 random bits from any generator; two calls of a 32-bit one.
+template<std::uniform_random_bit_generator URBG>
+std::uint64_t random_bits(URBG& gen) {
+    if constexpr (URBG::min() == 0 && URBG::max() == std::numeric_limits<std::uint64_t>::max()) {
+        return gen();
+    } else if constexpr (URBG::min() == 0 && URBG::max() == std::numeric_limits<std::uint32_t>::max()) {
+        const std::uint64_t high = gen();
+        return (high << 32) | gen();
+    } else {
+        return std::uniform_int_distribution<std::uint64_t>()(gen);
+    }
+}
+
+// A uniformly distributed integer in [0, n), for n > 0. Lemire's method: the high
+// half of random_bits * n, redrawn in the rare case it would be biased, so that
+// it takes one multiplication and almost never a division.
+template<std::uniform_random_bit_generator URBG>
+std::uint64_t uniform_below(URBG& gen, std::uint64_t n) {
+    auto product = static_cast<unsigned __int128>(random_bits(gen)) * n;
+    if (static_cast<std::uint64_t>(product) < n) {
+        const std::uint64_t threshold = -n % n;
+        while (static_cast<std::uint64_t>(product) < threshold) {
+            product = static_cast<unsigned __int128>(random_bits(gen)) * n;
+        }
+    }
+    return static_cast<std::uint64_t>(product >> 64);
+}
+
+// A uniformly distributed double in (0, 1]: never 0, so that its log is finite.
+template<std::uniform_random_bit_generator URBG>
+double uniform_positive(URBG& gen) {
+    return static_cast<double>((random_bits(gen) >> 11) + 1) * 0x1.0p-53;
+}
+
+namespace detail {
+
+// Shuffled blocks fit in the L2 cache, where Fisher–Yates' random swaps are cheap.
+constexpr std::size_t shuffle_leaf_bytes = std::size_t{1} << 19;
+
+template<class RandomIt, class URBG>
+void fisher_yates(RandomIt first, std::size_t n, URBG& gen) {
+    using std::swap;
+    for (std::size_t i = n; i > 1; --i) swap(first[i - 1], first[uniform_below(gen, i)]);
+}
+
+// Merges the shuffled halves [0, mid) and [mid, n) into a shuffled whole: each
+// position takes the next element of either half on a coin flip, until one half
+// runs out; the rest are then inserted at random positions, as in Fisher–Yates.
+// This is the merge of MergeShuffle (Bacher, Bodini, Hollender, Lumbroso), which
+// swaps in place and reads both halves sequentially.
+template<class RandomIt, class URBG>
+void merge_shuffled(RandomIt first, std::size_t mid, std::size_t n, URBG& gen) {
+    using std::swap;
+    std::size_t i = 0;
+    std::size_t j = mid;
+    // Without branches on the coin, which would be mispredicted half the time:
+    // first[i] is swapped with first[j] or, to take from the first half, with itself.
+    const auto step = [&](std::uint64_t from_second) {
+        const std::size_t k = i + ((j - i) & (0 - from_second));
+        swap(first[i], first[k]);
+        j += from_second;
+        ++i;
+    };
+    // 64 flips at a time while neither half can run out within them.
+    while (j + 64 <= n && i + 64 <= j) {
+        std::uint64_t flips = random_bits(gen);
+        for (int f = 0; f < 64; ++f, flips >>= 1) step(flips & 1);
+    }
+    while (true) {
+        const std::uint64_t from_second = random_bits(gen) >> 63;
+        if ((from_second ? j == n : i == j)) break; // The half to take from is exhausted.
+        step(from_second);
+    }
+    for (; i < n; ++i) swap(first[i], first[uniform_below(gen, i + 1)]);
+}
+
+// Shuffles the halves, in parallel if allowed, then merges them. Each node of the
+// recursion draws from its own stream, numbered as in a binary heap, so the
+// result depends on the seed alone and not on the number of threads.
+template<class URBG, class RandomIt>
+void merge_shuffle(RandomIt first, std::size_t n, std::uint64_t seed, std::uint64_t node, bool parallel) {
+    constexpr std::size_t leaf_size = std::max<std::size_t>(2, shuffle_leaf_bytes / sizeof(std::iter_value_t<RandomIt>));
+    if (n <= leaf_size) {
+        URBG gen(seed, node);
+        fisher_yates(first, n, gen);
+        return;
+    }
+    const std::size_t mid = n / 2;
+    if (parallel) {
+        tbb::parallel_invoke([&]{ merge_shuffle<URBG>(first, mid, seed, 2 * node, parallel); },
+                             [&]{ merge_shuffle<URBG>(first + mid, n - mid, seed, 2 * node + 1, parallel); });
+    } else {
+        merge_shuffle<URBG>(first, mid, seed, 2 * node, parallel);
+        merge_shuffle<URBG>(first + mid, n - mid, seed, 2 * node + 1, parallel);
+    }
+    URBG gen(seed, node);
+    merge_shuffled(first, mid, n, gen);
+}
+
+} // namespace detail
+
+// Puts [first, last) in a uniformly random order that depends only on 'seed'.
+// Blocks of the range are shuffled on different TBB threads (see parallel::ThreadLimit)
+// and merged in place, so no memory is allocated. URBG must be constructible
+// from (seed, stream), like Xoshiro256pp and Pcg32.
+template<class URBG = Xoshiro256pp, std::random_access_iterator RandomIt>
+void shuffle(RandomIt first, RandomIt last, std::uint64_t seed) {
+    static_assert(std::is_constructible_v<URBG, std::uint64_t, std::uint64_t>, "URBG is seeded with (seed, stream)");
+    const std::size_t num_threads = tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    detail::merge_shuffle<URBG>(first, static_cast<std::size_t>(last - first), seed, 1, num_threads > 1);
+}
+
+// Copies a uniformly random sample of min(k, n) of the n elements of [first, last)
+// to [out, out + min(k, n)), reading the input once, and returns the end of the
+// sample. The sample is in no particular order. Like std::sample on input
+// iterators, but with Li's Algorithm L: instead of a random number per element,
+// it draws how many elements to skip before the next one enters the sample, so
+// it takes O(k (1 + log(n / k))) random numbers. With random access iterators,
+// the skipped elements are not even visited.
+template<std::input_iterator InputIt, std::random_access_iterator RandomIt, std::uniform_random_bit_generator URBG>
+RandomIt reservoir_sample(InputIt first, InputIt last, RandomIt out, std::size_t k, URBG& gen) {
+    std::size_t filled = 0;
+    for (; filled < k && first != last; ++first) out[filled++] = *first;
+    if (filled < k || k == 0) return out + filled;
+
+    const double inverse_k = 1.0 / static_cast<double>(k);
+    // The largest of the k keys in the sample, if every element had a uniform key and the k smallest were kept.
+    double w = std::exp(std::log(uniform_positive(gen)) * inverse_k);
+    while (first != last) {
+        const double skip = std::floor(std::log(uniform_positive(gen)) / std::log1p(-w));
+        if constexpr (std::random_access_iterator<InputIt>) {
+            if (!(skip < static_cast<double>(last - first))) break;
+            first += static_cast<std::iter_difference_t<InputIt>>(skip);
+        } else {
+            if (!(skip < 0x1.0p63)) break;
+            for (auto s = static_cast<std::uint64_t>(skip); s > 0 && first != last; --s) ++first;
+            if (first == last) break;
+        }
+        out[uniform_below(gen, k)] = *first;
+        ++first;
+        w *= std::exp(std::log(uniform_positive(gen)) * inverse_k);
+    }
+    return out + k;
+}
+
+// Copies a weighted random sample of min(k, m) distinct elements of [first, last)
+// to [out, ...), where m is the number of elements of positive weight, and
+// returns the end of the sample. The weight of *(first + i) is *(weights + i);
+// elements of weight zero or less are never chosen. Like successive draws
+// without replacement, each draw chooses an element with probability
+// proportional to its weight among those left.
+//
+// One pass, with the exponential jumps of Efraimidis and Spirakis (A-ExpJ):
+// each element gets the key u^(1/w), the k largest are kept in a heap, and
+// random numbers are only drawn for the elements that enter it.
+template<std::input_iterator InputIt, std::input_iterator WeightIt, std::random_access_iterator RandomIt,
+         std::uniform_random_bit_generator URBG>
+RandomIt weighted_sample(InputIt first, InputIt last, WeightIt weights, RandomIt out, std::size_t k, URBG& gen) {
+    if (k == 0) return out;
+    // (log of the key, position in the sample), with the least key on top.
+    using Entry = std::pair<double, std::size_t>;
+    std::vector<Entry> heap;
+    heap.reserve(k);
+    const auto greater = [](const Entry& a, const Entry& b) { return a.first > b.first; };
+
+    for (; heap.size() < k && first != last; ++first, ++weights) {
+        const double w = static_cast<double>(*weights);
+        if (!(w > 0)) continue;
+        out[heap.size()] = *first;
+        heap.emplace_back(std::log(uniform_positive(gen)) / w, heap.size());
+        std::push_heap(heap.begin(), heap.end(), greater);
+    }
+    if (heap.size() < k) return out + heap.size();
+    if (!(heap.front().first < 0)) return out + k; // Every key is 1: nothing can displace them.
+
+    // The weight to skip before the next element enters the sample.
+    auto jump = [&]{ return std::log(uniform_positive(gen)) / heap.front().first; };
+    double remaining = jump();
+    for (; first != last; ++first, ++weights) {
+        const double w = static_cast<double>(*weights);
+        if (!(w > 0)) continue;
+        remaining -= w;
+        if (remaining > 0) continue;
+        // Its key is uniform between the threshold and 1.
+        const double threshold = std::exp(w * heap.front().first);
+        const double key = threshold + (1 - threshold) * uniform_positive(gen);
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        out[heap.back().second] = *first;
+        heap.back().first = std::log(std::min(key, 1.0)) / w;
+        std::push_heap(heap.begin(), heap.end(), greater);
+        if (!(heap.front().first < 0)) break; // Every key is 1: nothing can displace them.
+        remaining = jump();
+    }
+    return out + k;
+}
+
+// Draws indices in [0, n) with probability proportional to n given weights, in
+// constant time per draw: a drop-in for std::discrete_distribution, whose draws
+// take a binary search. Vose's alias method: each index owns an equal slice of
+// probability, split between itself and one alias.
+class AliasTable {
+public:
+    using result_type = std::size_t;
+
+    // The weights must not be negative, and must not all be zero.
+    template<std::input_iterator WeightIt>
+    AliasTable(WeightIt first, WeightIt last) {
+        std::vector<double> scaled;
+        for (; first != last; ++first) {
+            const double w = static_cast<double>(*first);
+            if (!(w >= 0) || std::isinf(w)) throw std::invalid_argument("AliasTable: weights must be finite and not negative");
+            scaled.push_back(w);
+        }
+        double total = 0;
+        for (const double w : scaled) total += w;
+        if (!(total > 0)) throw std::invalid_argument("AliasTable: the weights must not all be zero");
+
+        const std::size_t n = scaled.size();
+        probability_.assign(n, 1.0);
+        alias_.resize(n);
+        std::vector<std::size_t> small;
+        std::vector<std::size_t> large;
+        for (std::size_t i = 0; i < n; ++i) {
+            alias_[i] = i;
+            scaled[i] *= static_cast<double>(n) / total;
+            (scaled[i] < 1 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            const std::size_t s = small.back();
+            const std::size_t l = large.back();
+            small.pop_back();
+            probability_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= 1 - scaled[s];
+            if (scaled[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // What is left is 1 up to rounding.
+    }
+
+    std::size_t size() const { return alias_.size(); }
+
+    template<std::uniform_random_bit_generator URBG>
+    std::size_t operator()(URBG& gen) const {
+        const auto i = static_cast<std::size_t>(uniform_below(gen, alias_.size()));
+        return uniform_positive(gen) <= probability_[i] ? i : alias_[i];
+    }
+
+private:
+    std::vector<double> probability_;
+    std::vector<std::size_t> alias_;
+};
+
+} // namespace stl_examples::sampling
+
+#endif // STL_EXAMPLES_RANDOM_SAMPLING_H
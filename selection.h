@@ -0,0 +1,300 @@
+#ifndef STL_EXAMPLES_SELECTION_H
+#define STL_EXAMPLES_SELECTION_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dary_heap.h"
+#include "simd_dispatch.h"
+#include "simd_search.h"
+
+// Selecting the k first elements of a range, by a comparison, faster than
+// std::partial_sort and std::nth_element when k is much smaller than n:
+//
+//       selection::TopK<double, std::greater<>> top(100);    // The 100 largest.
+//       for (const auto& chunk : chunks) top.push(chunk.begin(), chunk.end());
+//       const std::vector<double> largest = top.sorted();
+//
+//       selection::top_k(v.cbegin(), v.cend(), out.begin(), out.end());   // Like std::partial_sort_copy.
+//       selection::nth_element(v.begin(), v.begin() + n / 2, v.end());   // Like std::nth_element.
+//
+// TopK and top_k read their input once, from input iterators or chunk by chunk,
+// and keep the k first elements seen in a bounded 4-ary max heap, whose top is
+// the threshold: an element only enters if it comes before the threshold. Once
+// the heap is full, that one comparison rejects almost every element, so the
+// cost is that of reading the input. For contiguous chunks of arithmetic types
+// ordered by std::less or std::greater, the comparison is vectorized: a whole
+// SIMD register of elements is tested against the threshold at once (see simd::level).
+//
+// nth_element and partial_sort work in memory with Floyd and Rivest's SELECT:
+// the pivots are chosen by recursively selecting from a small sample, so that
+// they bracket the nth element closely, and the range shrinks to about n^(2/3)
+// elements after one partitioning pass. It takes about n + min(k, n - k)
+// comparisons, against about 2n to 3n for introselect.
+namespace stl_examples::selection {
+
+namespace detail {
+
+// -1 if Compare orders T by std::less, 1 if by std::greater, and 0 otherwise.
+template<class T, class Compare>
+inline constexpr int natural_direction_v =
+        std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>> ? -1
+        : std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>> ? 1
+        : 0;
+
+// Index of the first element of [data, data + n) less than t (with Greater,
+// greater than t), or n. NaNs are never less or greater.
+template<class F, bool Greater>
+std::size_t find_beyond_scalar(const F* data, std::size_t n, F t) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (Greater ? data[i] > t : data[i] < t) return i;
+    }
+    return n;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+template<class F, bool Greater>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_beyond_mask(const F* p, F t) {
+    constexpr int op = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+    if constexpr (std::is_same_v<F, float>) {
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(t), op)));
+    } else {
+        return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(t), op)));
+    }
+}
+
+template<class F, bool Greater>
+STL_EXAMPLES_TARGET_AVX2 std::size_t find_beyond_avx2(const F* data, std::size_t n, F t) {
+    constexpr std::size_t lanes = 32 / sizeof(F);
+    std::size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        const std::uint32_t m = avx2_beyond_mask<F, Greater>(data + i, t)
+                              | avx2_beyond_mask<F, Greater>(data + i + lanes, t) << lanes
+                              | avx2_beyond_mask<F, Greater>(data + i + 2 * lanes, t) << 2 * lanes
+                              | avx2_beyond_mask<F, Greater>(data + i + 3 * lanes, t) << 3 * lanes;
+        if (m != 0) return i + std::countr_zero(m);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        if (const std::uint32_t m = avx2_beyond_mask<F, Greater>(data + i, t); m != 0) return i + std::countr_zero(m);
+    }
+    return i + find_beyond_scalar<F, Greater>(data + i, n - i, t);
+}
+
+template<class F, bool Greater>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_beyond_mask(const F* p, F t) {
+    constexpr int op = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+    if constexpr (std::is_same_v<F, float>) return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_set1_ps(t), op);
+    else return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_set1_pd(t), op);
+}
+
+template<class F, bool Greater>
+STL_EXAMPLES_TARGET_AVX512 std::size_t find_beyond_avx512(const F* data, std::size_t n, F t) {
+    constexpr std::size_t lanes = 64 / sizeof(F);
+    std::size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        const std::uint64_t m = avx512_beyond_mask<F, Greater>(data + i, t)
+                              | avx512_beyond_mask<F, Greater>(data + i + lanes, t) << lanes
+                              | avx512_beyond_mask<F, Greater>(data + i + 2 * lanes, t) << 2 * lanes
+                              | avx512_beyond_mask<F, Greater>(data + i + 3 * lanes, t) << 3 * lanes;
+        if (m != 0) return i + std::countr_zero(m);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        if (const std::uint64_t m = avx512_beyond_mask<F, Greater>(data + i, t); m != 0) return i + std::countr_zero(m);
+    }
+    return i + find_beyond_scalar<F, Greater>(data + i, n - i, t);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Index of the first element of [data, data + n) that comes before t in the
+// Direction order (see natural_direction_v), or n.
+template<int Direction, class T>
+std::size_t find_before(const T* data, std::size_t n, T t) {
+    constexpr bool greater = Direction > 0;
+    if constexpr (std::is_integral_v<T>) {
+        // Integers before t form a closed range, for which simd_search has kernels.
+        if (t == (greater ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min())) return n;
+        const auto range = greater ? simd::in_range<T>{static_cast<T>(t + 1), std::numeric_limits<T>::max()}
+                                   : simd::in_range<T>{std::numeric_limits<T>::min(), static_cast<T>(t - 1)};
+        return static_cast<std::size_t>(simd::find_if(data, data + n, range) - data);
+    } else {
+#if STL_EXAMPLES_SIMD_X86
+        switch (simd::level()) {
+            case simd::Level::avx512: return find_beyond_avx512<T, greater>(data, n, t);
+            case simd::Level::avx2: return find_beyond_avx2<T, greater>(data, n, t);
+            case simd::Level::scalar: break;
+        }
+#endif
+        return find_beyond_scalar<T, greater>(data, n, t);
+    }
+}
+
+template<class Iter, class T, class Compare>
+inline constexpr bool is_prefilterable_v = std::contiguous_iterator<Iter> && std::is_same_v<std::iter_value_t<Iter>, T> &&
+        natural_direction_v<T, Compare> != 0 &&
+        (simd::detail::is_lane_type_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+// Offers [first, last) to the heap [heap, heap + size) of the at most k first
+// elements so far, whose top is the last of them. Returns the new size.
+template<class HeapIt, class InputIt, class Compare>
+std::size_t offer(HeapIt heap, std::size_t size, std::size_t k, InputIt first, InputIt last, Compare& comp) {
+    using T = std::iter_value_t<HeapIt>;
+    for (; size < k && first != last; ++first) {
+        heap[size++] = *first;
+        dary::push_heap<4>(heap, heap + size, comp);
+    }
+    if (size < k || k == 0) return size;
+
+    // The element replaces the top, which is no longer among the k first.
+    const auto replace_top = [&](T value) { dary::detail::sift_down<4>(heap, k, 0, std::move(value), comp); };
+    if constexpr (is_prefilterable_v<InputIt, T, Compare>) {
+        const T* data = std::to_address(first);
+        const auto n = static_cast<std::size_t>(last - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            i += find_before<natural_direction_v<T, Compare>>(data + i, n - i, T(heap[0]));
+            if (i == n) break;
+            replace_top(data[i]);
+        }
+    } else {
+        for (; first != last; ++first) {
+            if (comp(*first, heap[0])) replace_top(*first);
+        }
+    }
+    return size;
+}
+
+// Ranges of this many elements or fewer are partitioned without sampling first.
+inline constexpr std::ptrdiff_t floyd_rivest_cutoff = 600;
+
+// Puts the element of rank k of [first + left, first + right] at first + k, with
+// no element after it before it, nor before it after it (Floyd and Rivest, 1975).
+template<class RandomIt, class Compare>
+void floyd_rivest_select(RandomIt first, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t k, Compare& comp) {
+    using std::swap;
+    // Like introselect, give up on an unlucky sequence of pivots rather than go quadratic.
+    int rounds_left = 2 * std::bit_width(static_cast<std::size_t>(right - left + 1)) + 8;
+    while (right > left) {
+        if (--rounds_left < 0) {
+            std::nth_element(first + left, first + k, first + right + 1, comp);
+            return;
+        }
+        if (right - left > floyd_rivest_cutoff) {
+            // Select from a sample around k, of about n^(2/3) elements, so that the
+            // pivot below is likely just past rank k, and the range shrinks to the sample.
+            const double n = static_cast<double>(right - left + 1);
+            const double i = static_cast<double>(k - left + 1);
+            const double z = std::log(n);
+            const double s = 0.5 * std::exp(2 * z / 3);
+            const double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+            const auto sample_left = std::max(left, static_cast<std::ptrdiff_t>(static_cast<double>(k) - i * s / n + sd));
+            const auto sample_right = std::min(right, static_cast<std::ptrdiff_t>(static_cast<double>(k) + (n - i) * s / n + sd));
+            floyd_rivest_select(first, sample_left, sample_right, k, comp);
+        }
+        // Partition [left, right] around t, which ends up at j.
+        const std::iter_value_t<RandomIt> t = first[k];
+        std::ptrdiff_t i = left;
+        std::ptrdiff_t j = right;
+        swap(first[left], first[k]);
+        if (comp(t, first[right])) swap(first[right], first[left]);
+        while (i < j) {
+            swap(first[i], first[j]);
+            ++i;
+            --j;
+            while (comp(first[i], t)) ++i;
+            while (comp(t, first[j])) --j;
+        }
+        if (!comp(first[left], t) && !comp(t, first[left])) {
+            swap(first[left], first[j]);
+        } else {
+            ++j;
+            swap(first[j], first[right]);
+        }
+        if (j <= k) left = j + 1;
+        if (k <= j) right = j - 1;
+    }
+}
+
+} // namespace detail
+
+// The k first elements of a stream by comp, offered one at a time or in chunks.
+// T must be copyable.
+template<class T, class Compare = std::less<>>
+class TopK {
+public:
+    explicit TopK(std::size_t k, Compare comp = {}) : k_(k), comp_(std::move(comp)) {}
+
+    void push(const T& value) {
+        if (heap_.size() < k_) {
+            heap_.push_back(value);
+            dary::push_heap<4>(heap_.begin(), heap_.end(), comp_);
+        } else if (k_ > 0 && comp_(value, heap_.front())) {
+            dary::detail::sift_down<4>(heap_.begin(), k_, 0, value, comp_);
+        }
+    }
+
+    // Offers every element of [first, last).
+    template<std::input_iterator InputIt>
+    void push(InputIt first, InputIt last) {
+        // The heap only grows as it is filled, so that k may be larger than the stream.
+        for (; heap_.size() < k_ && first != last; ++first) push(*first);
+        detail::offer(heap_.begin(), heap_.size(), k_, first, last, comp_);
+    }
+
+    std::size_t k() const { return k_; }
+    std::size_t size() const { return heap_.size(); }
+    bool full() const { return heap_.size() == k_; }
+
+    // The last of the k first elements so far: once full(), only elements before it can enter.
+    // Requires size() > 0.
+    const T& threshold() const { return heap_.front(); }
+
+    // The k first elements so far, or all of them if fewer were offered, in order.
+    std::vector<T> sorted() const {
+        std::vector<T> result = heap_;
+        dary::sort_heap<4>(result.begin(), result.end(), comp_);
+        return result;
+    }
+
+private:
+    std::size_t k_;
+    Compare comp_;
+    std::vector<T> heap_;
+};
+
+// Like std::partial_sort_copy: copies the first min(n, d_last - d_first) elements
+// of [first, last), in order, to [d_first, ...), and returns the end of them.
+template<std::input_iterator InputIt, std::random_access_iterator RandomIt, class Compare = std::less<>>
+RandomIt top_k(InputIt first, InputIt last, RandomIt d_first, RandomIt d_last, Compare comp = {}) {
+    const auto k = static_cast<std::size_t>(d_last - d_first);
+    const std::size_t size = detail::offer(d_first, 0, k, first, last, comp);
+    dary::sort_heap<4>(d_first, d_first + size, comp);
+    return d_first + size;
+}
+
+// Like std::nth_element, with Floyd–Rivest selection. The element type must be copyable.
+template<std::random_access_iterator RandomIt, class Compare = std::less<>>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp = {}) {
+    if (nth == last) return;
+    detail::floyd_rivest_select(first, 0, last - first - 1, nth - first, comp);
+}
+
+// Like std::partial_sort: selects the elements of [first, middle), then sorts only them.
+template<std::random_access_iterator RandomIt, class Compare = std::less<>>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp = {}) {
+    if (first == middle) return;
+    selection::nth_element(first, middle - 1, last, comp);
+    std::sort(first, middle - 1, comp);
+}
+
+} // namespace stl_examples::selection
+
+#endif // STL_EXAMPLES_SELECTION_H
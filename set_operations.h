@@ -0,0 +1,261 @@
+#ifndef STL_EXAMPLES_SET_OPERATIONS_H
+#define STL_EXAMPLES_SET_OPERATIONS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "simd_dispatch.h"
+
+// Drop-in replacements for std::includes, set_difference, set_intersection,
+// set_symmetric_difference, and set_union that pick an algorithm from the sizes
+// of the two ranges, as when intersecting the posting lists of an inverted index:
+//
+//   - When one range is at least gallop_ratio times longer than the other, the
+//     merge skips over each run of elements that the shorter range does not
+//     reach with an exponential ("galloping") search, then copies or skips the
+//     whole run at once. That is O(m log(n / m)) comparisons instead of O(n + m).
+//   - set_intersection of two similar-sized ranges of 32-bit integers compares
+//     blocks of 8 elements from each range against each other in AVX2 registers.
+//   - Otherwise, the std algorithm is called.
+//
+// Every variant outputs exactly what the std algorithm does, including which
+// copies of duplicate elements are kept. Galloping needs random-access iterators;
+// other iterators always use the std algorithm.
+namespace stl_examples::adaptive {
+
+namespace detail {
+
+// Galloping pays off once one range is this many times longer than the other.
+inline constexpr std::size_t gallop_ratio = 32;
+
+// The first element of [first, last) that is not less than 'value', searching
+// 1, 2, 4, ... elements ahead of 'first' and then binary searching the last step.
+template<class RandomIt, class T, class Compare>
+RandomIt gallop_lower_bound(RandomIt first, RandomIt last, const T& value, Compare& comp) {
+    if (first == last || !comp(*first, value)) return first;
+    // Invariant: *lo is less than 'value'.
+    RandomIt lo = first;
+    std::ptrdiff_t step = 1;
+    while (step < last - lo && comp(lo[step], value)) {
+        lo += step;
+        step *= 2;
+    }
+    return std::lower_bound(lo + 1, step < last - lo ? lo + step : last, value, comp);
+}
+
+// What each set operation does with the parts of a merge.
+struct MergeActions {
+    bool copy_less_first;   // Elements of the first range less than the next of the second.
+    bool copy_less_second;  // Elements of the second range less than the next of the first.
+    bool copy_equal;        // One of each pair of equivalent elements, from the first range.
+};
+
+// The std merge loop, except that runs of elements from one range that are less
+// than the next element of the other are found by galloping, and handled at once.
+template<MergeActions Actions, class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt gallop_merge(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, Compare& comp) {
+    while (first1 != last1 && first2 != last2) {
+        if (comp(*first1, *first2)) {
+            const RandomIt1 run_end = gallop_lower_bound(first1, last1, *first2, comp);
+            if constexpr (Actions.copy_less_first) d_first = std::copy(first1, run_end, d_first);
+            first1 = run_end;
+        } else if (comp(*first2, *first1)) {
+            const RandomIt2 run_end = gallop_lower_bound(first2, last2, *first1, comp);
+            if constexpr (Actions.copy_less_second) d_first = std::copy(first2, run_end, d_first);
+            first2 = run_end;
+        } else {
+            if constexpr (Actions.copy_equal) *d_first++ = *first1;
+            ++first1;
+            ++first2;
+        }
+    }
+    if constexpr (Actions.copy_less_first) d_first = std::copy(first1, last1, d_first);
+    if constexpr (Actions.copy_less_second) d_first = std::copy(first2, last2, d_first);
+    return d_first;
+}
+
+// True if the sizes of [first1, last1) and [first2, last2) are skewed enough to gallop.
+template<class RandomIt1, class RandomIt2>
+bool should_gallop(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2) {
+    const auto n1 = static_cast<std::size_t>(last1 - first1);
+    const auto n2 = static_cast<std::size_t>(last2 - first2);
+    return std::min(n1, n2) * gallop_ratio <= std::max(n1, n2);
+}
+
+template<class T, class Compare>
+inline constexpr bool is_natural_order_v = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+// True if set_intersection of It1 and It2 can use the block-compare kernel.
+template<class It1, class It2, class Compare>
+inline constexpr bool is_block_intersectable_v = [] {
+    if constexpr (std::contiguous_iterator<It1> && std::contiguous_iterator<It2>) {
+        using T = std::iter_value_t<It1>;
+        return std::is_same_v<T, std::iter_value_t<It2>> && std::is_integral_v<T> && sizeof(T) == 4 &&
+               is_natural_order_v<T, Compare>;
+    } else {
+        return false;
+    }
+}();
+
+#if STL_EXAMPLES_SIMD_X86
+// The number of elements of the block 'v' that are not greater than 'x'.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline int avx2_count_not_greater(__m256i v, T x) {
+    // Ordered compares are signed, so unsigned values are biased by the sign bit.
+    const __m256i bias = _mm256_set1_epi32(std::is_unsigned_v<T> ? static_cast<int>(0x80000000u) : 0);
+    const __m256i greater = _mm256_cmpgt_epi32(_mm256_xor_si256(v, bias),
+                                               _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(x)), bias));
+    return 8 - _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(greater))));
+}
+
+STL_EXAMPLES_TARGET_AVX2 inline bool avx2_has_equal_neighbours(__m256i v) {
+    const __m256i next = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 7);
+    const __m256i equal = _mm256_cmpeq_epi32(v, _mm256_permutevar8x32_epi32(v, next));
+    return (_mm256_movemask_ps(_mm256_castsi256_ps(equal)) & 0x7f) != 0;
+}
+
+// Intersects a[i, n1) and b[j, n2) 8 elements at a time, while both have 8 left.
+// Each step compares all 64 pairs of the two blocks, outputs the elements of
+// 'a' that have a match in 'b', and advances past every element of either block
+// that can no longer match, which is where the plain merge would be too. Blocks
+// with equal neighbours are left to a few steps of the plain merge instead, so
+// each value occurs at most once per block; if many blocks have them, the rest
+// of the ranges too.
+template<class T, class OutputIt>
+STL_EXAMPLES_TARGET_AVX2 OutputIt intersect_avx2(const T* a, std::size_t n1, const T* b, std::size_t n2,
+                                                 std::size_t& i, std::size_t& j, OutputIt d_first) {
+    std::size_t blocks = 0;
+    std::size_t duplicate_blocks = 0;
+    while (i + 8 <= n1 && j + 8 <= n2) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        ++blocks;
+        if (avx2_has_equal_neighbours(va) || avx2_has_equal_neighbours(vb)) {
+            // Mostly duplicates: the plain merge is faster for the rest.
+            if (++duplicate_blocks * 4 > blocks && blocks >= 64) return d_first;
+            for (int step = 0; step < 8 && i < n1 && j < n2; ++step) {
+                if (a[i] < b[j]) ++i;
+                else if (b[j] < a[i]) ++j;
+                else { *d_first++ = a[i]; ++i; ++j; }
+            }
+            continue;
+        }
+
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        __m256i equal = _mm256_cmpeq_epi32(va, vb);
+        __m256i rotated = vb;
+        for (int r = 1; r < 8; ++r) {
+            rotated = _mm256_permutevar8x32_epi32(rotated, rotate);
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(va, rotated));
+        }
+        const auto matches = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(equal)));
+        if (matches != 0) {
+            // Packs the matching lanes to the front: pext picks the lane numbers
+            // whose bytes are selected by the mask, spread to one byte per lane.
+            const std::uint64_t byte_mask = _pdep_u64(matches, 0x0101010101010101) * 0xff;
+            const std::uint64_t lanes = _pext_u64(0x0706050403020100, byte_mask);
+            const __m256i packed = _mm256_permutevar8x32_epi32(va, _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(lanes))));
+            T buffer[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), packed);
+            d_first = std::copy_n(buffer, _mm_popcnt_u32(matches), d_first);
+        }
+
+        const T a_last = a[i + 7];
+        const T b_last = b[j + 7];
+        if (a_last < b_last) {
+            i += 8;
+            j += avx2_count_not_greater(vb, a_last);
+        } else if (b_last < a_last) {
+            j += 8;
+            i += avx2_count_not_greater(va, b_last);
+        } else {
+            i += 8;
+            j += 8;
+        }
+    }
+    return d_first;
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+} // namespace detail
+
+template<class InputIt1, class InputIt2, class Compare = std::less<>>
+bool includes(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, Compare comp = {}) {
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>) {
+        if (detail::should_gallop(first1, last1, first2, last2)) {
+            while (first2 != last2) {
+                first1 = detail::gallop_lower_bound(first1, last1, *first2, comp);
+                if (first1 == last1 || comp(*first2, *first1)) return false;
+                ++first1;
+                ++first2;
+            }
+            return true;
+        }
+    }
+    return std::includes(first1, last1, first2, last2, comp);
+}
+
+template<class InputIt1, class InputIt2, class OutputIt, class Compare = std::less<>>
+OutputIt set_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp = {}) {
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>) {
+        if (detail::should_gallop(first1, last1, first2, last2)) {
+            constexpr detail::MergeActions actions{.copy_less_first = true, .copy_less_second = false, .copy_equal = false};
+            return detail::gallop_merge<actions>(first1, last1, first2, last2, d_first, comp);
+        }
+    }
+    return std::set_difference(first1, last1, first2, last2, d_first, comp);
+}
+
+template<class InputIt1, class InputIt2, class OutputIt, class Compare = std::less<>>
+OutputIt set_intersection(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp = {}) {
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>) {
+        if (detail::should_gallop(first1, last1, first2, last2)) {
+            constexpr detail::MergeActions actions{.copy_less_first = false, .copy_less_second = false, .copy_equal = true};
+            return detail::gallop_merge<actions>(first1, last1, first2, last2, d_first, comp);
+        }
+    }
+#if STL_EXAMPLES_SIMD_X86
+    if constexpr (detail::is_block_intersectable_v<InputIt1, InputIt2, Compare>) {
+        if (simd::level() >= simd::Level::avx2) {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            d_first = detail::intersect_avx2(std::to_address(first1), static_cast<std::size_t>(last1 - first1),
+                                             std::to_address(first2), static_cast<std::size_t>(last2 - first2), i, j, d_first);
+            return std::set_intersection(first1 + i, last1, first2 + j, last2, d_first, comp);
+        }
+    }
+#endif
+    return std::set_intersection(first1, last1, first2, last2, d_first, comp);
+}
+
+template<class InputIt1, class InputIt2, class OutputIt, class Compare = std::less<>>
+OutputIt set_symmetric_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                                  Compare comp = {}) {
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>) {
+        if (detail::should_gallop(first1, last1, first2, last2)) {
+            constexpr detail::MergeActions actions{.copy_less_first = true, .copy_less_second = true, .copy_equal = false};
+            return detail::gallop_merge<actions>(first1, last1, first2, last2, d_first, comp);
+        }
+    }
+    return std::set_symmetric_difference(first1, last1, first2, last2, d_first, comp);
+}
+
+template<class InputIt1, class InputIt2, class OutputIt, class Compare = std::less<>>
+OutputIt set_union(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp = {}) {
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>) {
+        if (detail::should_gallop(first1, last1, first2, last2)) {
+            constexpr detail::MergeActions actions{.copy_less_first = true, .copy_less_second = true, .copy_equal = true};
+            return detail::gallop_merge<actions>(first1, last1, first2, last2, d_first, comp);
+        }
+    }
+    return std::set_union(first1, last1, first2, last2, d_first, comp);
+}
+
+} // namespace stl_examples::adaptive
+
+#endif // STL_EXAMPLES_SET_OPERATIONS_H
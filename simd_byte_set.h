@@ -0,0 +1,248 @@
+#ifndef STL_EXAMPLES_SIMD_BYTE_SET_H
+#define STL_EXAMPLES_SIMD_BYTE_SET_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include "simd_dispatch.h"
+
+// A set of bytes, compiled once, to find the first byte of a text in or out of it,
+// as a tokenizer does for its delimiters:
+//
+//       const simd::byte_set delimiters(" ,;\t\n");
+//       const auto end_of_token = simd::find_first_of(line.cbegin(), line.cend(), delimiters);
+//       const auto next_token = simd::find_first_not_of(end_of_token, line.cend(), delimiters);
+//
+// The set is a 256-bit bitmap, for the scalar loop and for use as a predicate,
+// and the same bits as two tables of 16 bytes, indexed by the low nibble of a byte:
+// the bit of its high nibble in the row for its low nibble tells whether it is in
+// the set. The kernels look up 32 (AVX2) or 64 (AVX-512) bytes at once in these
+// tables with byte shuffles, whatever the bytes in the set.
+//
+// With case_folding::ascii, the set holds both cases of each ASCII letter given,
+// and equal_ignore_case compares two chars that way: neither looks up the locale,
+// as std::tolower does for each char.
+namespace stl_examples::simd {
+
+enum class case_folding { none, ascii };
+
+// The lowercase of an ASCII letter, and any other char unchanged.
+constexpr char ascii_to_lower(char c) {
+    const auto u = static_cast<unsigned char>(c);
+    return static_cast<char>(u | (static_cast<unsigned char>(u - 'A') < 26 ? 0x20 : 0));
+}
+
+// Compares two chars ignoring the case of ASCII letters, as a predicate for
+// std::search, std::equal, std::find_first_of, and the like.
+struct equal_ignore_case {
+    constexpr bool operator()(char a, char b) const { return ascii_to_lower(a) == ascii_to_lower(b); }
+};
+
+class byte_set {
+public:
+    byte_set() = default;
+
+    // The chars of 'chars' (and with case_folding::ascii, the other case of its letters).
+    explicit byte_set(std::string_view chars, case_folding folding = case_folding::none)
+        : byte_set(chars.begin(), chars.end(), folding) {}
+
+    template<std::input_iterator Iter>
+    byte_set(Iter first, Iter last, case_folding folding = case_folding::none) {
+        for (; first != last; ++first) insert(static_cast<unsigned char>(*first), folding);
+    }
+
+    void insert(unsigned char c, case_folding folding = case_folding::none) {
+        add(c);
+        if (folding == case_folding::ascii && static_cast<unsigned char>((c | 0x20) - 'a') < 26) {
+            add(static_cast<unsigned char>(c ^ 0x20));
+        }
+    }
+
+    bool contains(unsigned char c) const { return (bits_[c >> 6] >> (c & 63)) & 1; }
+
+    template<class Byte>
+        requires (sizeof(Byte) == 1)
+    bool operator()(Byte c) const { return contains(static_cast<unsigned char>(c)); }
+
+    // Row i has bit h set if the byte 16 h + i is in the set, for h < 8 (low_rows)
+    // or h >= 8 (high_rows, as bit h - 8).
+    const std::array<std::uint8_t, 16>& low_rows() const { return low_rows_; }
+    const std::array<std::uint8_t, 16>& high_rows() const { return high_rows_; }
+
+private:
+    void add(unsigned char c) {
+        bits_[c >> 6] |= std::uint64_t{1} << (c & 63);
+        const unsigned high = c >> 4;
+        if (high < 8) low_rows_[c & 15] |= static_cast<std::uint8_t>(1u << high);
+        else high_rows_[c & 15] |= static_cast<std::uint8_t>(1u << (high - 8));
+    }
+
+    std::array<std::uint64_t, 4> bits_{};
+    std::array<std::uint8_t, 16> low_rows_{};
+    std::array<std::uint8_t, 16> high_rows_{};
+};
+
+namespace detail {
+
+template<class Iter>
+inline constexpr bool is_byte_iterator_v =
+        std::contiguous_iterator<Iter> && sizeof(std::iter_value_t<Iter>) == 1 &&
+        (std::is_integral_v<std::iter_value_t<Iter>> || std::is_same_v<std::iter_value_t<Iter>, std::byte>) &&
+        !std::is_same_v<std::iter_value_t<Iter>, bool>;
+
+// Index of the first byte in the set (or, with Negate, out of it), or n.
+template<bool Negate>
+std::size_t find_byte_scalar(const unsigned char* data, std::size_t n, const byte_set& set) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (set.contains(data[i]) != Negate) return i;
+    }
+    return n;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// The lookup tables, as vectors, with the 16 bytes of each repeated in every
+// 128-bit lane, as the byte shuffles look up within each lane.
+struct avx2_byte_tables {
+    __m256i low_rows;
+    __m256i high_rows;
+    __m256i bits; // Byte h holds bit h % 8.
+};
+
+STL_EXAMPLES_TARGET_AVX2 inline avx2_byte_tables avx2_tables(const byte_set& set) {
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.low_rows().data()));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.high_rows().data()));
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    return {_mm256_broadcastsi128_si256(low), _mm256_broadcastsi128_si256(high), _mm256_broadcastsi128_si256(bits)};
+}
+
+// One bit per byte of the 32 bytes at 'p', set for the bytes in the set.
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_in_set(const unsigned char* p, const avx2_byte_tables& tables) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i low = _mm256_and_si256(x, nibble);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+    // The row of the low nibble, from the table of the high one.
+    const __m256i is_high = _mm256_cmpgt_epi8(high, _mm256_set1_epi8(7));
+    const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(tables.low_rows, low),
+                                           _mm256_shuffle_epi8(tables.high_rows, low), is_high);
+    const __m256i bit = _mm256_shuffle_epi8(tables.bits, high);
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+}
+
+template<bool Negate>
+STL_EXAMPLES_TARGET_AVX2 std::size_t find_byte_avx2(const unsigned char* data, std::size_t n, const byte_set& set) {
+    const avx2_byte_tables tables = avx2_tables(set);
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        const std::uint32_t m0 = avx2_in_set(data + i, tables) ^ (Negate ? ~0u : 0u);
+        const std::uint32_t m1 = avx2_in_set(data + i + 32, tables) ^ (Negate ? ~0u : 0u);
+        if ((m0 | m1) != 0) return i + (m0 != 0 ? std::countr_zero(m0) : 32 + std::countr_zero(m1));
+    }
+    for (; i + 32 <= n; i += 32) {
+        const std::uint32_t m = avx2_in_set(data + i, tables) ^ (Negate ? ~0u : 0u);
+        if (m != 0) return i + std::countr_zero(m);
+    }
+    return i + find_byte_scalar<Negate>(data + i, n - i, set);
+}
+
+struct avx512_byte_tables {
+    __m512i low_rows;
+    __m512i high_rows;
+    __m512i bits;
+};
+
+// The 16-byte tables, repeated in each 128-bit lane, since vpshufb looks up
+// within a lane. The broadcasts are zero-masked with every lane kept: GCC 12
+// warns that the unmasked one reads an uninitialized register.
+STL_EXAMPLES_TARGET_AVX512 inline avx512_byte_tables avx512_tables(const byte_set& set) {
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.low_rows().data()));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.high_rows().data()));
+    return {_mm512_maskz_broadcast_i32x4(0xFFFF, low), _mm512_maskz_broadcast_i32x4(0xFFFF, high),
+            _mm512_set1_epi64(0x8040201008040201)};
+}
+
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_in_set(const unsigned char* p, const avx512_byte_tables& tables) {
+    const __m512i x = _mm512_loadu_si512(p);
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    const __m512i low = _mm512_and_si512(x, nibble);
+    const __m512i high = _mm512_and_si512(_mm512_srli_epi16(x, 4), nibble);
+    const __mmask64 is_high = _mm512_cmpgt_epu8_mask(high, _mm512_set1_epi8(7));
+    const __m512i row = _mm512_mask_blend_epi8(is_high, _mm512_shuffle_epi8(tables.low_rows, low),
+                                               _mm512_shuffle_epi8(tables.high_rows, low));
+    return _mm512_test_epi8_mask(row, _mm512_shuffle_epi8(tables.bits, high));
+}
+
+template<bool Negate>
+STL_EXAMPLES_TARGET_AVX512 std::size_t find_byte_avx512(const unsigned char* data, std::size_t n, const byte_set& set) {
+    // A short token is left to the scalar loop without building the tables.
+    if (n < 64) return find_byte_scalar<Negate>(data, n, set);
+    const avx512_byte_tables tables = avx512_tables(set);
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        const std::uint64_t m = avx512_in_set(data + i, tables) ^ (Negate ? ~std::uint64_t{0} : 0);
+        if (m != 0) return i + std::countr_zero(m);
+    }
+    return i + find_byte_scalar<Negate>(data + i, n - i, set);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Dispatches to the best kernel for the current Level.
+template<bool Negate>
+std::size_t find_byte(const unsigned char* data, std::size_t n, const byte_set& set) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return find_byte_avx512<Negate>(data, n, set);
+        case Level::avx2: return find_byte_avx2<Negate>(data, n, set);
+        case Level::scalar: break;
+    }
+#endif
+    return find_byte_scalar<Negate>(data, n, set);
+}
+
+template<bool Negate, class Iter>
+Iter find_byte(Iter first, Iter last, const byte_set& set) {
+    if constexpr (is_byte_iterator_v<Iter>) {
+        const auto* data = reinterpret_cast<const unsigned char*>(std::to_address(first));
+        return first + find_byte<Negate>(data, static_cast<std::size_t>(last - first), set);
+    } else if constexpr (Negate) {
+        return std::find_if_not(first, last, set);
+    } else {
+        return std::find_if(first, last, set);
+    }
+}
+
+} // namespace detail
+
+// The first byte of [first, last) in 'set', or last.
+template<class Iter>
+Iter find_first_of(Iter first, Iter last, const byte_set& set) {
+    return detail::find_byte</*Negate=*/false>(first, last, set);
+}
+
+// The first byte of [first, last) not in 'set', or last.
+template<class Iter>
+Iter find_first_not_of(Iter first, Iter last, const byte_set& set) {
+    return detail::find_byte</*Negate=*/true>(first, last, set);
+}
+
+// std::find_first_of: for contiguous ranges of bytes, [s_first, s_last) is
+// compiled into a byte_set first.
+template<class Iter1, class Iter2>
+Iter1 find_first_of(Iter1 first, Iter1 last, Iter2 s_first, Iter2 s_last) {
+    if constexpr (detail::is_byte_iterator_v<Iter1> && std::is_same_v<std::iter_value_t<Iter1>, std::iter_value_t<Iter2>>) {
+        return simd::find_first_of(first, last, byte_set(s_first, s_last));
+    } else {
+        return std::find_first_of(first, last, s_first, s_last);
+    }
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_BYTE_SET_H
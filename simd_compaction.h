@@ -0,0 +1,384 @@
+#ifndef STL_EXAMPLES_SIMD_COMPACTION_H
+#define STL_EXAMPLES_SIMD_COMPACTION_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/parallel_for.h>
+
+#include "simd_dispatch.h"
+#include "simd_search.h"
+
+// Drop-in replacements for std::copy_if, remove_if, remove, partition,
+// stable_partition, and partition_point that do not branch on the predicate:
+//
+//       simd::copy_if(v.cbegin(), v.cend(), out.begin(), simd::in_range<int>{0, 99});
+//       v.erase(simd::remove_if(v.begin(), v.end(), simd::equal_to<int>{0}), v.end());
+//       v.erase(simd::remove(v.begin(), v.end(), 0), v.end());
+//
+// On random data, the branch of the std loops on each element's predicate is
+// mispredicted half the time. Here, every element is written to the next free
+// slot and the slot advances by the predicate's result (stream compaction):
+//
+//   - For contiguous ranges of 32- or 64-bit integers, float, or double, and the
+//     predicates simd::equal_to and simd::in_range, 16 (AVX-512) or 8 (AVX2) 32-bit
+//     elements are compared at once, and the matching ones packed together with a
+//     compress instruction (AVX-512) or a permutation from a table (AVX2).
+//   - For contiguous ranges of other arithmetic types, or any other predicate,
+//     a scalar loop writes each element to both sides and advances one of them.
+//   - Anything else falls back to the std algorithm.
+//
+// The predicate is called once per element, in order, as by the std algorithms;
+// partition is stable here, which std::partition allows. stable_partition (and so
+// partition) needs a buffer for the elements that do not match, and splits large
+// ranges across the TBB threads (see parallel::ThreadLimit): each block of the range
+// is counted first, and the counts give each block where to write its elements.
+// It then calls the predicate twice per element, which must therefore be pure,
+// as for the parallel std algorithms.
+//
+// partition_point is a binary search whose next step is chosen with a conditional
+// move instead of a branch, for any predicate on a random-access range.
+namespace stl_examples::simd {
+
+namespace detail {
+
+// Inputs shorter than this are partitioned on the calling thread.
+inline constexpr std::size_t min_partition_block_size = 1 << 16;
+// More blocks than threads, so that threads that finish early can take another.
+inline constexpr std::size_t partition_blocks_per_thread = 4;
+// The scalar loop packs this many elements at a time into buffers on the stack.
+inline constexpr std::size_t scalar_compaction_block = 256;
+
+template<class T>
+inline constexpr bool is_compactable_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// True if the compaction of [InIt, InIt) into OutIt can use the scalar loop.
+template<class InIt, class OutIt>
+inline constexpr bool is_compactable_range_v =
+        std::contiguous_iterator<InIt> && std::contiguous_iterator<OutIt> &&
+        std::is_same_v<std::iter_value_t<InIt>, std::iter_value_t<OutIt>> && is_compactable_v<std::iter_value_t<InIt>> &&
+        std::is_assignable_v<std::iter_reference_t<OutIt>, std::iter_value_t<InIt>>;
+
+// True if elements of type T and the predicate can use the vector kernels.
+template<class T, class Pred>
+inline constexpr bool is_compaction_kernel_v = [] {
+    if constexpr (kernel_predicate<Pred>::value) {
+        using U = decltype(kernel_predicate<Pred>::lo(std::declval<Pred>()));
+        return std::is_same_v<T, U> && is_compactable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+    } else return false;
+}();
+
+// The integer with the bits of T, as the kernels load it.
+template<class T>
+using bits_t = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+// Writes the elements of [src, src + n) that match to out_true (if WriteTrue) and
+// the others to out_false (if WriteFalse), in order, and returns the number that
+// match. out_true or out_false may be 'src' itself, as every element is read
+// before the slot it is written to.
+template<bool WriteTrue, bool WriteFalse, class T, class Pred>
+std::size_t split_scalar(const T* src, std::size_t n, T* out_true, T* out_false, Pred& pred) {
+    std::size_t num_true = 0;
+    T buffer_true[scalar_compaction_block];
+    T buffer_false[scalar_compaction_block];
+    for (std::size_t i = 0; i < n; i += scalar_compaction_block) {
+        const std::size_t end = std::min(n, i + scalar_compaction_block);
+        std::size_t t = 0;
+        std::size_t f = 0;
+        for (std::size_t j = i; j < end; ++j) {
+            const T x = src[j];
+            const bool matches = pred(x);
+            if constexpr (WriteTrue) buffer_true[t] = x;
+            if constexpr (WriteFalse) buffer_false[f] = x;
+            t += matches;
+            f += !matches;
+        }
+        if constexpr (WriteTrue) std::copy(buffer_true, buffer_true + t, out_true + num_true);
+        if constexpr (WriteFalse) std::copy(buffer_false, buffer_false + f, out_false + (i - num_true));
+        num_true += t;
+    }
+    return num_true;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// For each 8-bit mask of 32-bit lanes, the indices of the set lanes, one per
+// byte: the permutation that packs the set lanes at the start of a vector.
+inline constexpr std::array<std::uint64_t, 256> avx2_compress_table = [] {
+    std::array<std::uint64_t, 256> table{};
+    for (std::uint32_t mask = 0; mask < 256; ++mask) {
+        std::uint64_t indices = 0;
+        int slot = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (mask & (1u << lane)) indices |= std::uint64_t(lane) << (8 * slot++);
+        }
+        table[mask] = indices;
+    }
+    return table;
+}();
+
+// Loaded at offset 8 - k, the mask of the first k 32-bit lanes.
+inline constexpr std::array<std::int32_t, 16> avx2_prefix_masks{-1, -1, -1, -1, -1, -1, -1, -1};
+
+// One bit per lane of 'x', set for the lanes that match. For unsigned integer
+// ranges, 'x', 'lo', and 'hi' have been flipped by sign_bit already.
+template<class T, bool Range>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_lane_mask(__m256i x, __m256i lo, __m256i hi) {
+    if constexpr (std::is_same_v<T, float>) {
+        const __m256 v = _mm256_castsi256_ps(x);
+        if constexpr (!Range) return _mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_castsi256_ps(lo), _CMP_EQ_OQ));
+        else return _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_castsi256_ps(lo), v, _CMP_LE_OQ),
+                                                     _mm256_cmp_ps(v, _mm256_castsi256_ps(hi), _CMP_LE_OQ)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        const __m256d v = _mm256_castsi256_pd(x);
+        if constexpr (!Range) return _mm256_movemask_pd(_mm256_cmp_pd(v, _mm256_castsi256_pd(lo), _CMP_EQ_OQ));
+        else return _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(_mm256_castsi256_pd(lo), v, _CMP_LE_OQ),
+                                                     _mm256_cmp_pd(v, _mm256_castsi256_pd(hi), _CMP_LE_OQ)));
+    } else {
+        __m256i matches;
+        if constexpr (!Range) matches = avx2_eq<sizeof(T)>(x, lo);
+        else matches = _mm256_andnot_si256(_mm256_or_si256(avx2_gt<sizeof(T)>(lo, x), avx2_gt<sizeof(T)>(x, hi)),
+                                           _mm256_set1_epi32(-1));
+        if constexpr (sizeof(T) == 4) return _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+        else return _mm256_movemask_pd(_mm256_castsi256_pd(matches));
+    }
+}
+
+// Packs the lanes of 'x' set in 'mask' at the start of the vector.
+template<std::size_t Size>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_compress(__m256i x, std::uint32_t mask) {
+    // A 64-bit lane is a pair of 32-bit lanes, so each bit of its mask is doubled.
+    if constexpr (Size == 8) mask = _pdep_u32(mask, 0x55) * 3;
+    const __m256i indices = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(avx2_compress_table[mask])));
+    return _mm256_permutevar8x32_epi32(x, indices);
+}
+
+template<std::size_t Size>
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_store_first(void* p, __m256i x, std::size_t count) {
+    const std::size_t words = count * (Size / 4);
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(avx2_prefix_masks.data() + 8 - words));
+    _mm256_maskstore_epi32(static_cast<int*>(p), mask, x);
+}
+
+template<bool WriteTrue, bool WriteFalse, class T, bool Range>
+STL_EXAMPLES_TARGET_AVX2 std::size_t split_avx2(const T* src, std::size_t n, T* out_true, T* out_false, T lo, T hi) {
+    using S = bits_t<T>;
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    constexpr bool flip = std::is_unsigned_v<T> && Range;
+    const S bias = flip ? sign_bit<S> : S{0};
+    const __m256i vlo = avx2_set1<S>(static_cast<S>(std::bit_cast<S>(lo) ^ bias));
+    const __m256i vhi = avx2_set1<S>(static_cast<S>(std::bit_cast<S>(hi) ^ bias));
+    const __m256i vbias = avx2_set1<S>(bias);
+
+    std::size_t num_true = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const std::uint32_t mask = avx2_lane_mask<T, Range>(flip ? _mm256_xor_si256(x, vbias) : x, vlo, vhi);
+        const std::size_t t = std::popcount(mask);
+        if constexpr (WriteTrue) avx2_store_first<sizeof(T)>(out_true + num_true, avx2_compress<sizeof(T)>(x, mask), t);
+        if constexpr (WriteFalse) {
+            const std::uint32_t others = ~mask & ((1u << lanes) - 1);
+            avx2_store_first<sizeof(T)>(out_false + (i - num_true), avx2_compress<sizeof(T)>(x, others), lanes - t);
+        }
+        num_true += t;
+    }
+    auto pred = [&](T x){ return in_range<T>{lo, Range ? hi : lo}(x); };
+    return num_true + split_scalar<WriteTrue, WriteFalse>(src + i, n - i, WriteTrue ? out_true + num_true : nullptr,
+                                                          WriteFalse ? out_false + (i - num_true) : nullptr, pred);
+}
+
+template<class T, bool Range>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint32_t avx512_lane_mask(__m512i x, __m512i lo, __m512i hi) {
+    if constexpr (std::is_same_v<T, float>) {
+        const __m512 v = _mm512_castsi512_ps(x);
+        if constexpr (!Range) return _mm512_cmp_ps_mask(v, _mm512_castsi512_ps(lo), _CMP_EQ_OQ);
+        else return _mm512_cmp_ps_mask(_mm512_castsi512_ps(lo), v, _CMP_LE_OQ) & _mm512_cmp_ps_mask(v, _mm512_castsi512_ps(hi), _CMP_LE_OQ);
+    } else if constexpr (std::is_same_v<T, double>) {
+        const __m512d v = _mm512_castsi512_pd(x);
+        if constexpr (!Range) return _mm512_cmp_pd_mask(v, _mm512_castsi512_pd(lo), _CMP_EQ_OQ);
+        else return _mm512_cmp_pd_mask(_mm512_castsi512_pd(lo), v, _CMP_LE_OQ) & _mm512_cmp_pd_mask(v, _mm512_castsi512_pd(hi), _CMP_LE_OQ);
+    } else {
+        using S = bits_t<T>;
+        constexpr bool is_unsigned = std::is_unsigned_v<T>;
+        if constexpr (!Range) return static_cast<std::uint32_t>(avx512_cmp<S, is_unsigned, _MM_CMPINT_EQ>(x, lo));
+        else return static_cast<std::uint32_t>(avx512_cmp<S, is_unsigned, _MM_CMPINT_LE>(lo, x) &
+                                               avx512_cmp<S, is_unsigned, _MM_CMPINT_LE>(x, hi));
+    }
+}
+
+// Writes the lanes of 'x' set in 'mask', packed together, to 'p'.
+template<std::size_t Size>
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_compress_store(void* p, __m512i x, std::uint32_t mask) {
+    // A compress into a register, then a masked store: the compressing store
+    // to memory is much slower on some processors.
+    const std::uint32_t first = (1u << std::popcount(mask)) - 1;
+    if constexpr (Size == 4) _mm512_mask_storeu_epi32(p, static_cast<__mmask16>(first), _mm512_maskz_compress_epi32(static_cast<__mmask16>(mask), x));
+    else _mm512_mask_storeu_epi64(p, static_cast<__mmask8>(first), _mm512_maskz_compress_epi64(static_cast<__mmask8>(mask), x));
+}
+
+template<bool WriteTrue, bool WriteFalse, class T, bool Range>
+STL_EXAMPLES_TARGET_AVX512 std::size_t split_avx512(const T* src, std::size_t n, T* out_true, T* out_false, T lo, T hi) {
+    using S = bits_t<T>;
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    const __m512i vlo = avx512_set1<S>(std::bit_cast<S>(lo));
+    const __m512i vhi = avx512_set1<S>(std::bit_cast<S>(hi));
+
+    std::size_t num_true = 0;
+    for (std::size_t i = 0; i < n; i += lanes) {
+        // The last vector is loaded with a mask, and its missing lanes never match.
+        const std::uint32_t valid = n - i >= lanes ? (1u << lanes) - 1 : (1u << (n - i)) - 1;
+        const __m512i x = sizeof(T) == 4 ? _mm512_maskz_loadu_epi32(static_cast<__mmask16>(valid), src + i)
+                                         : _mm512_maskz_loadu_epi64(static_cast<__mmask8>(valid), src + i);
+        const std::uint32_t mask = avx512_lane_mask<T, Range>(x, vlo, vhi) & valid;
+        if constexpr (WriteTrue) avx512_compress_store<sizeof(T)>(out_true + num_true, x, mask);
+        if constexpr (WriteFalse) avx512_compress_store<sizeof(T)>(out_false + (i - num_true), x, ~mask & valid);
+        num_true += std::popcount(mask);
+    }
+    return num_true;
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Dispatches to the best kernel for the current Level.
+template<bool WriteTrue, bool WriteFalse, class T, class Pred>
+std::size_t split(const T* src, std::size_t n, T* out_true, T* out_false, Pred& pred) {
+#if STL_EXAMPLES_SIMD_X86
+    if constexpr (is_compaction_kernel_v<T, Pred>) {
+        using traits = kernel_predicate<Pred>;
+        const T lo = traits::lo(pred);
+        const T hi = traits::hi(pred);
+        switch (level()) {
+            case Level::avx512: return split_avx512<WriteTrue, WriteFalse, T, traits::range>(src, n, out_true, out_false, lo, hi);
+            case Level::avx2: return split_avx2<WriteTrue, WriteFalse, T, traits::range>(src, n, out_true, out_false, lo, hi);
+            case Level::scalar: break;
+        }
+    }
+#endif
+    return split_scalar<WriteTrue, WriteFalse>(src, n, out_true, out_false, pred);
+}
+
+// Moves the elements of [first, first + n) that match before the others, keeping
+// their order, and returns the number that match.
+template<class T, class Pred>
+std::size_t stable_partition(T* first, std::size_t n, Pred& pred) {
+    const std::size_t num_threads = tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    const std::size_t num_blocks = std::min(num_threads * partition_blocks_per_thread, n / min_partition_block_size);
+    const auto buffer = std::make_unique_for_overwrite<T[]>(n);
+    if (num_threads <= 1 || num_blocks <= 1) {
+        const std::size_t num_true = split<true, true>(first, n, first, buffer.get(), pred);
+        std::copy(buffer.get(), buffer.get() + (n - num_true), first + num_true);
+        return num_true;
+    }
+    const auto block_begin = [&](std::size_t b){ return n / num_blocks * b + std::min(b, n % num_blocks); };
+
+    // First pass: the number of elements of each block that match.
+    std::vector<std::size_t> true_before(num_blocks + 1);
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t b) {
+        const std::size_t begin = block_begin(b);
+        true_before[b + 1] = split<false, false, T>(first + begin, block_begin(b + 1) - begin, nullptr, nullptr, pred);
+    });
+    // true_before[b] becomes the number of elements before block b that match.
+    for (std::size_t b = 1; b <= num_blocks; ++b) true_before[b] += true_before[b - 1];
+    const std::size_t num_true = true_before[num_blocks];
+
+    // Second pass: each block writes its elements to their places in the buffer,
+    // then the buffer is copied back.
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t b) {
+        const std::size_t begin = block_begin(b);
+        split<true, true>(first + begin, block_begin(b + 1) - begin, buffer.get() + true_before[b],
+                          buffer.get() + num_true + (begin - true_before[b]), pred);
+    });
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t b) {
+        std::copy(buffer.get() + block_begin(b), buffer.get() + block_begin(b + 1), first + block_begin(b));
+    });
+    return num_true;
+}
+
+} // namespace detail
+
+template<class InIt, class OutIt, class Pred>
+OutIt copy_if(InIt first, InIt last, OutIt d_first, Pred pred) {
+    if constexpr (detail::is_compactable_range_v<InIt, OutIt>) {
+        using T = std::iter_value_t<InIt>;
+        const std::size_t n = last - first;
+        T* out = std::to_address(d_first);
+        return d_first + detail::split<true, false>(std::to_address(first), n, out, static_cast<T*>(nullptr), pred);
+    } else {
+        return std::copy_if(first, last, d_first, pred);
+    }
+}
+
+template<class Iter, class Pred>
+Iter remove_if(Iter first, Iter last, Pred pred) {
+    if constexpr (detail::is_compactable_range_v<Iter, Iter>) {
+        using T = std::iter_value_t<Iter>;
+        const std::size_t n = last - first;
+        T* data = std::to_address(first);
+        return first + (n - detail::split<false, true>(data, n, static_cast<T*>(nullptr), data, pred));
+    } else {
+        return std::remove_if(first, last, pred);
+    }
+}
+
+template<class Iter, class U>
+Iter remove(Iter first, Iter last, const U& value) {
+    using T = std::iter_value_t<Iter>;
+    if constexpr (detail::is_compactable_range_v<Iter, Iter> && (std::is_integral_v<U> || std::is_same_v<U, T>)) {
+        // If converting 'value' to T changes it, no element can compare equal to
+        // it; neither can anything equal a NaN.
+        const T narrowed = static_cast<T>(value);
+        if (!detail::std_equal(narrowed, value)) return last;
+        return simd::remove_if(first, last, equal_to<T>{narrowed});
+    } else {
+        return std::remove(first, last, value);
+    }
+}
+
+template<class Iter, class Pred>
+Iter stable_partition(Iter first, Iter last, Pred pred) {
+    if constexpr (detail::is_compactable_range_v<Iter, Iter>) {
+        return first + detail::stable_partition(std::to_address(first), static_cast<std::size_t>(last - first), pred);
+    } else {
+        return std::stable_partition(first, last, pred);
+    }
+}
+
+// Same as stable_partition: std::partition may leave the elements in any order
+// within each part, including the original one.
+template<class Iter, class Pred>
+Iter partition(Iter first, Iter last, Pred pred) {
+    if constexpr (detail::is_compactable_range_v<Iter, Iter>) {
+        return simd::stable_partition(first, last, pred);
+    } else {
+        return std::partition(first, last, pred);
+    }
+}
+
+template<class Iter, class Pred>
+Iter partition_point(Iter first, Iter last, Pred pred) {
+    if constexpr (std::random_access_iterator<Iter>) {
+        auto n = last - first;
+        if (n == 0) return first;
+        // Invariant: every element before 'first' matches, and the partition
+        // point is within [first, first + n].
+        while (n > 1) {
+            const auto half = n / 2;
+            first = pred(first[half - 1]) ? first + half : first;
+            n -= half;
+        }
+        return first + (pred(*first) ? 1 : 0);
+    } else {
+        return std::partition_point(first, last, pred);
+    }
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_COMPACTION_H
@@ -0,0 +1,239 @@
+#ifndef STL_EXAMPLES_SIMD_COMPARE_H
+#define STL_EXAMPLES_SIMD_COMPARE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "simd_dispatch.h"
+
+// Drop-in replacements for std::mismatch, equal, and lexicographical_compare that
+// compare two ranges 64 (AVX2) or 128 (AVX-512) bytes at a time, as when diffing
+// two snapshots of a buffer:
+//
+//       if (!simd::equal(snapshot.cbegin(), snapshot.cend(), previous.cbegin())) { ... }
+//       const auto [changed, _] = simd::mismatch(snapshot.cbegin(), snapshot.cend(), previous.cbegin());
+//
+// The vectorized path is taken for contiguous ranges of the same integer, float,
+// or double type, compared with == (std::equal_to) or, for lexicographical_compare,
+// with < (std::less). Integers are equal when their bytes are; floats are compared
+// as floats, so that a NaN is never equal, and -0.0 equals 0.0. Any other
+// predicate or range falls back to the std algorithm.
+//
+// lexicographical_compare finds the first element where the ranges differ, and
+// then orders the two elements with < of their own type: char is signed on most
+// platforms, and a memcmp, which orders unsigned bytes, would put '\x80' after 'a'.
+namespace stl_examples::simd {
+
+namespace detail {
+
+template<class T>
+inline constexpr bool is_wide_compare_v = (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8) ||
+                                          std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// True if [Iter1, Iter1) and [Iter2, ...) can be handed to the kernels as T arrays.
+template<class Iter1, class Iter2>
+inline constexpr bool is_wide_compare_range_v =
+        std::contiguous_iterator<Iter1> && std::contiguous_iterator<Iter2> &&
+        std::is_same_v<std::iter_value_t<Iter1>, std::iter_value_t<Iter2>> && is_wide_compare_v<std::iter_value_t<Iter1>>;
+
+template<class Pred, class T>
+inline constexpr bool is_equal_to_v = std::is_same_v<Pred, std::equal_to<>> || std::is_same_v<Pred, std::equal_to<T>>;
+
+template<class Compare, class T>
+inline constexpr bool is_less_v = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+// True if a and b differ: !(a == b) or, with Equivalence, a < b || b < a, as
+// lexicographical_compare tells them apart. The two differ only for NaNs.
+template<bool Equivalence, class T>
+constexpr bool differ(const T& a, const T& b) {
+    if constexpr (Equivalence) return a < b || b < a;
+    else return !(a == b);
+}
+
+template<bool Equivalence, class T>
+std::size_t mismatch_scalar(const T* a, const T* b, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (differ<Equivalence>(a[i], b[i])) return i;
+    }
+    return n;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// One bit per byte of the 32 bytes at 'a' and 'b', set for the bytes of the
+// elements that differ.
+template<bool Equivalence, class T>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_differ(const T* a, const T* b) {
+    constexpr int predicate = Equivalence ? _CMP_NEQ_OQ : _CMP_NEQ_UQ;
+    if constexpr (std::is_same_v<T, float>) {
+        const __m256 x = _mm256_loadu_ps(a);
+        const __m256 y = _mm256_loadu_ps(b);
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(x, y, predicate))));
+    } else if constexpr (std::is_same_v<T, double>) {
+        const __m256d x = _mm256_loadu_pd(a);
+        const __m256d y = _mm256_loadu_pd(b);
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(x, y, predicate))));
+    } else {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    }
+}
+
+template<bool Equivalence, class T>
+STL_EXAMPLES_TARGET_AVX2 std::size_t mismatch_avx2(const T* a, const T* b, std::size_t n) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        const std::uint32_t m0 = avx2_differ<Equivalence>(a + i, b + i);
+        const std::uint32_t m1 = avx2_differ<Equivalence>(a + i + lanes, b + i + lanes);
+        if ((m0 | m1) != 0) return i + (m0 != 0 ? std::countr_zero(m0) : 32 + std::countr_zero(m1)) / sizeof(T);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        const std::uint32_t m = avx2_differ<Equivalence>(a + i, b + i);
+        if (m != 0) return i + std::countr_zero(m) / sizeof(T);
+    }
+    return i + mismatch_scalar<Equivalence>(a + i, b + i, n - i);
+}
+
+// Bits of avx512_differ per element: one per byte for integers, one per lane for floats.
+template<class T>
+inline constexpr std::size_t avx512_bits_per_element = std::is_floating_point_v<T> ? 1 : sizeof(T);
+
+// One bit per byte (or per floating-point lane) of the 64 bytes at 'a' and 'b',
+// set where they differ.
+template<bool Equivalence, class T>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_differ(const T* a, const T* b) {
+    constexpr int predicate = Equivalence ? _CMP_NEQ_OQ : _CMP_NEQ_UQ;
+    if constexpr (std::is_same_v<T, float>) return _mm512_cmp_ps_mask(_mm512_loadu_ps(a), _mm512_loadu_ps(b), predicate);
+    else if constexpr (std::is_same_v<T, double>) return _mm512_cmp_pd_mask(_mm512_loadu_pd(a), _mm512_loadu_pd(b), predicate);
+    else return _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+}
+
+template<bool Equivalence, class T>
+STL_EXAMPLES_TARGET_AVX512 std::size_t mismatch_avx512(const T* a, const T* b, std::size_t n) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    constexpr std::size_t scale = avx512_bits_per_element<T>;
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        const std::uint64_t m0 = avx512_differ<Equivalence>(a + i, b + i);
+        const std::uint64_t m1 = avx512_differ<Equivalence>(a + i + lanes, b + i + lanes);
+        if ((m0 | m1) != 0) return i + (m0 != 0 ? std::countr_zero(m0) / scale : lanes + std::countr_zero(m1) / scale);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        const std::uint64_t m = avx512_differ<Equivalence>(a + i, b + i);
+        if (m != 0) return i + std::countr_zero(m) / scale;
+    }
+    return i + mismatch_scalar<Equivalence>(a + i, b + i, n - i);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Index of the first element where a[0, n) and b[0, n) differ, or n.
+template<bool Equivalence, class T>
+std::size_t mismatch_index(const T* a, const T* b, std::size_t n) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return mismatch_avx512<Equivalence>(a, b, n);
+        case Level::avx2: return mismatch_avx2<Equivalence>(a, b, n);
+        case Level::scalar: break;
+    }
+#endif
+    return mismatch_scalar<Equivalence>(a, b, n);
+}
+
+template<class Iter1, class Iter2>
+std::size_t mismatch_index(Iter1 first1, Iter2 first2, std::size_t n) {
+    return mismatch_index</*Equivalence=*/false>(std::to_address(first1), std::to_address(first2), n);
+}
+
+} // namespace detail
+
+template<class Iter1, class Iter2, class Pred>
+std::pair<Iter1, Iter2> mismatch(Iter1 first1, Iter1 last1, Iter2 first2, Pred pred) {
+    if constexpr (detail::is_wide_compare_range_v<Iter1, Iter2> && detail::is_equal_to_v<Pred, std::iter_value_t<Iter1>>) {
+        const std::size_t i = detail::mismatch_index(first1, first2, static_cast<std::size_t>(last1 - first1));
+        return {first1 + i, first2 + i};
+    } else {
+        return std::mismatch(first1, last1, first2, pred);
+    }
+}
+
+template<class Iter1, class Iter2>
+std::pair<Iter1, Iter2> mismatch(Iter1 first1, Iter1 last1, Iter2 first2) {
+    return simd::mismatch(first1, last1, first2, std::equal_to<>());
+}
+
+template<class Iter1, class Iter2, class Pred>
+std::pair<Iter1, Iter2> mismatch(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, Pred pred) {
+    if constexpr (detail::is_wide_compare_range_v<Iter1, Iter2> && detail::is_equal_to_v<Pred, std::iter_value_t<Iter1>>) {
+        const auto n = std::min(last1 - first1, static_cast<std::iter_difference_t<Iter1>>(last2 - first2));
+        const std::size_t i = detail::mismatch_index(first1, first2, static_cast<std::size_t>(n));
+        return {first1 + i, first2 + i};
+    } else {
+        return std::mismatch(first1, last1, first2, last2, pred);
+    }
+}
+
+template<class Iter1, class Iter2>
+std::pair<Iter1, Iter2> mismatch(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return simd::mismatch(first1, last1, first2, last2, std::equal_to<>());
+}
+
+template<class Iter1, class Iter2, class Pred>
+bool equal(Iter1 first1, Iter1 last1, Iter2 first2, Pred pred) {
+    if constexpr (detail::is_wide_compare_range_v<Iter1, Iter2> && detail::is_equal_to_v<Pred, std::iter_value_t<Iter1>>) {
+        const auto n = static_cast<std::size_t>(last1 - first1);
+        return detail::mismatch_index(first1, first2, n) == n;
+    } else {
+        return std::equal(first1, last1, first2, pred);
+    }
+}
+
+template<class Iter1, class Iter2>
+bool equal(Iter1 first1, Iter1 last1, Iter2 first2) {
+    return simd::equal(first1, last1, first2, std::equal_to<>());
+}
+
+template<class Iter1, class Iter2, class Pred>
+bool equal(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, Pred pred) {
+    if constexpr (detail::is_wide_compare_range_v<Iter1, Iter2> && detail::is_equal_to_v<Pred, std::iter_value_t<Iter1>>) {
+        const auto n = static_cast<std::size_t>(last1 - first1);
+        return n == static_cast<std::size_t>(last2 - first2) && detail::mismatch_index(first1, first2, n) == n;
+    } else {
+        return std::equal(first1, last1, first2, last2, pred);
+    }
+}
+
+template<class Iter1, class Iter2>
+bool equal(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return simd::equal(first1, last1, first2, last2, std::equal_to<>());
+}
+
+template<class Iter1, class Iter2, class Compare>
+bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, Compare comp) {
+    if constexpr (detail::is_wide_compare_range_v<Iter1, Iter2> && detail::is_less_v<Compare, std::iter_value_t<Iter1>>) {
+        const auto n1 = static_cast<std::size_t>(last1 - first1);
+        const auto n2 = static_cast<std::size_t>(last2 - first2);
+        const auto* a = std::to_address(first1);
+        const auto* b = std::to_address(first2);
+        const std::size_t i = detail::mismatch_index</*Equivalence=*/true>(a, b, std::min(n1, n2));
+        return i < std::min(n1, n2) ? a[i] < b[i] : n1 < n2;
+    } else {
+        return std::lexicographical_compare(first1, last1, first2, last2, comp);
+    }
+}
+
+template<class Iter1, class Iter2>
+bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return simd::lexicographical_compare(first1, last1, first2, last2, std::less<>());
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_COMPARE_H
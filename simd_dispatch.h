@@ -0,0 +1,79 @@
+#ifndef STL_EXAMPLES_SIMD_DISPATCH_H
+#define STL_EXAMPLES_SIMD_DISPATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Runtime selection between the AVX-512, AVX2, and scalar versions of the SIMD kernels.
+//
+// The kernels are compiled with per-function target attributes (see
+// STL_EXAMPLES_TARGET_AVX2 and STL_EXAMPLES_TARGET_AVX512), so the rest of the
+// program needs no -mavx flags, and a binary built once runs on any x86-64 CPU.
+#if defined(__x86_64__) || defined(__i386__)
+#define STL_EXAMPLES_SIMD_X86 1
+#include <immintrin.h>
+#define STL_EXAMPLES_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define STL_EXAMPLES_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,bmi,bmi2,popcnt")))
+#else
+#define STL_EXAMPLES_SIMD_X86 0
+#endif
+
+namespace stl_examples::simd {
+
+// Ordered from least to most capable.
+enum class Level { scalar, avx2, avx512 };
+
+// The best level supported by this CPU.
+inline Level detected_level() {
+    static const Level level = [] {
+#if STL_EXAMPLES_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq")) {
+            return Level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) return Level::avx2;
+#endif
+        return Level::scalar;
+    }();
+    return level;
+}
+
+// Every level up to detected_level(), for running each version of a kernel.
+inline std::vector<Level> supported_levels() {
+    std::vector<Level> levels{Level::scalar};
+    if (detected_level() >= Level::avx2) levels.push_back(Level::avx2);
+    if (detected_level() >= Level::avx512) levels.push_back(Level::avx512);
+    return levels;
+}
+
+namespace detail {
+inline std::atomic<Level>& level_cap() {
+    static std::atomic<Level> cap{Level::avx512};
+    return cap;
+}
+} // namespace detail
+
+// The level the kernels currently use: the detected level, lowered by any ScopedLevel.
+inline Level level() {
+    return std::min(detected_level(), detail::level_cap().load(std::memory_order_relaxed));
+}
+
+// Caps the level used by the kernels while in scope, so that the tests and
+// benchmarks can exercise the AVX2 and scalar versions on an AVX-512 machine.
+class ScopedLevel {
+public:
+    explicit ScopedLevel(Level cap) : previous_(detail::level_cap().exchange(cap)) {}
+    ~ScopedLevel() { detail::level_cap().store(previous_); }
+
+    ScopedLevel(const ScopedLevel&) = delete;
+    ScopedLevel& operator=(const ScopedLevel&) = delete;
+
+private:
+    Level previous_;
+};
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_DISPATCH_H
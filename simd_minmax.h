@@ -0,0 +1,438 @@
+#ifndef STL_EXAMPLES_SIMD_MINMAX_H
+#define STL_EXAMPLES_SIMD_MINMAX_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "simd_dispatch.h"
+#include "simd_search.h"
+
+// Drop-in replacements for std::min_element, max_element, and minmax_element that
+// find the extrema of a range in one pass, 32 (AVX2) or 64 (AVX-512) bytes at a
+// time, and a bulk clamp of a range in place:
+//
+//       const auto [lo, hi] = simd::minmax_element(samples.cbegin(), samples.cend());
+//       simd::clamp(samples.begin(), samples.end(), 0.0f, 1.0f);
+//
+// For contiguous ranges of 32- and 64-bit integers, floats, and doubles, each lane
+// keeps the smallest (and largest) element seen in it so far, and the step at
+// which it was seen; the lanes are merged at the end. The ties are broken as by
+// std: min_element and max_element return the first of several equal extrema,
+// minmax_element the first smallest and the last largest. Anything else falls
+// back to the std algorithm.
+//
+// Elements are compared with <, as by std. Since a NaN is unordered, the result
+// of std depends on where the NaNs are: a range with NaNs also falls back to std.
+namespace stl_examples::simd {
+
+// The smallest and largest elements of a non-empty range, and their indices, as
+// found by std::minmax_element.
+template<class T>
+struct extrema_result {
+    T min;
+    T max;
+    std::size_t min_index;
+    std::size_t max_index;
+};
+
+namespace detail {
+
+template<class T>
+inline constexpr bool is_extrema_kernel_v =
+        std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+// True if the extrema of [Iter, Iter) can be found by the kernels.
+template<class Iter>
+inline constexpr bool is_extrema_range_v = std::contiguous_iterator<Iter> && is_extrema_kernel_v<std::iter_value_t<Iter>>;
+
+// The indices of the extrema, as chosen by std::minmax_element (LastMax) or by
+// std::min_element and std::max_element.
+struct extrema_indices {
+    std::size_t min = 0;
+    std::size_t max = 0;
+};
+
+// Merges the candidate extrema at index i into 'best', with the tie-breaks of std.
+template<class T>
+inline void merge_min(const T* data, extrema_indices& best, T min, std::size_t i) {
+    if (min < data[best.min] || (!(data[best.min] < min) && i < best.min)) best.min = i;
+}
+
+template<bool LastMax, class T>
+inline void merge_max(const T* data, extrema_indices& best, T max, std::size_t i) {
+    if (data[best.max] < max || (!(max < data[best.max]) && (LastMax ? i > best.max : i < best.max))) best.max = i;
+}
+
+// Continues the scan of the elements from i on.
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+void extrema_scalar(const T* data, std::size_t i, std::size_t n, extrema_indices& best) {
+    for (; i < n; ++i) {
+        if constexpr (FindMin) {
+            if (data[i] < data[best.min]) best.min = i;
+        }
+        if constexpr (FindMax) {
+            if (LastMax ? !(data[i] < data[best.max]) : data[best.max] < data[i]) best.max = i;
+        }
+    }
+}
+
+template<class T>
+bool has_nan(const T* data, std::size_t n) {
+    if constexpr (std::is_floating_point_v<T>) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (data[i] != data[i]) return true;
+        }
+    }
+    return false;
+}
+
+template<class T>
+void clamp_scalar(T* data, std::size_t n, const T& lo, const T& hi) {
+    for (std::size_t i = 0; i < n; ++i) data[i] = std::clamp(data[i], lo, hi);
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// The integer of the same width as T, to broadcast T as the kernels see it.
+template<class T>
+using bits_of_t = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+// All-ones lanes where a < b.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_less(__m256i a, __m256i b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ));
+    } else if constexpr (std::is_signed_v<T>) {
+        return avx2_gt<sizeof(T)>(b, a);
+    } else {
+        const __m256i bias = avx2_set1(sign_bit<lane_t<T>>);
+        return avx2_gt<sizeof(T)>(_mm256_xor_si256(b, bias), _mm256_xor_si256(a, bias));
+    }
+}
+
+// All-ones lanes that hold a NaN.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_unordered(__m256i x) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(x), _CMP_UNORD_Q));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(x), _CMP_UNORD_Q));
+    } else {
+        return _mm256_setzero_si256();
+    }
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_load(const T* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// The running extrema of one lane set, and the steps at which they were seen.
+struct avx2_extrema {
+    __m256i min;
+    __m256i max;
+    __m256i min_step;
+    __m256i max_step;
+};
+
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_update(avx2_extrema& e, __m256i x, __m256i step) {
+    if constexpr (FindMin) {
+        const __m256i less = avx2_less<T>(x, e.min);
+        e.min = _mm256_blendv_epi8(e.min, x, less);
+        e.min_step = _mm256_blendv_epi8(e.min_step, step, less);
+    }
+    if constexpr (FindMax) {
+        // x >= max, for the last of equal maxima, is !(x < max) without NaNs.
+        if constexpr (LastMax) {
+            const __m256i less = avx2_less<T>(x, e.max);
+            e.max = _mm256_blendv_epi8(x, e.max, less);
+            e.max_step = _mm256_blendv_epi8(step, e.max_step, less);
+        } else {
+            const __m256i greater = avx2_less<T>(e.max, x);
+            e.max = _mm256_blendv_epi8(e.max, x, greater);
+            e.max_step = _mm256_blendv_epi8(e.max_step, step, greater);
+        }
+    }
+}
+
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_merge(const T* data, extrema_indices& best, const avx2_extrema& e,
+                                                std::size_t offset, std::size_t stride) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    using Step = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    std::array<T, lanes> min{}, max{};
+    std::array<Step, lanes> min_step{}, max_step{};
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(min.data()), e.min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(max.data()), e.max);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(min_step.data()), e.min_step);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(max_step.data()), e.max_step);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        if constexpr (FindMin) merge_min(data, best, min[lane], std::size_t{min_step[lane]} * stride + offset + lane);
+        if constexpr (FindMax) merge_max<LastMax>(data, best, max[lane], std::size_t{max_step[lane]} * stride + offset + lane);
+    }
+}
+
+// Returns false, with 'best' unset, if the range holds a NaN.
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX2 bool extrema_avx2(const T* data, std::size_t n, extrema_indices& best) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    // Two sets of lanes, for two vectors per step.
+    constexpr std::size_t stride = 2 * lanes;
+    const __m256i one = sizeof(T) == 4 ? _mm256_set1_epi32(1) : _mm256_set1_epi64x(1);
+    __m256i step = _mm256_setzero_si256();
+    const __m256i x0 = avx2_load(data);
+    const __m256i x1 = avx2_load(data + lanes);
+    avx2_extrema e0{x0, x0, step, step};
+    avx2_extrema e1{x1, x1, step, step};
+    __m256i unordered = _mm256_or_si256(avx2_unordered<T>(x0), avx2_unordered<T>(x1));
+    std::size_t i = stride;
+    for (; i + stride <= n; i += stride) {
+        step = sizeof(T) == 4 ? _mm256_add_epi32(step, one) : _mm256_add_epi64(step, one);
+        const __m256i y0 = avx2_load(data + i);
+        const __m256i y1 = avx2_load(data + i + lanes);
+        unordered = _mm256_or_si256(unordered, _mm256_or_si256(avx2_unordered<T>(y0), avx2_unordered<T>(y1)));
+        avx2_update<FindMin, FindMax, LastMax, T>(e0, y0, step);
+        avx2_update<FindMin, FindMax, LastMax, T>(e1, y1, step);
+    }
+    if (!_mm256_testz_si256(unordered, unordered)) return false;
+    best = {0, 0};
+    avx2_merge<FindMin, FindMax, LastMax>(data, best, e0, 0, stride);
+    avx2_merge<FindMin, FindMax, LastMax>(data, best, e1, lanes, stride);
+    if (has_nan(data + i, n - i)) return false;
+    extrema_scalar<FindMin, FindMax, LastMax>(data, i, n, best);
+    return true;
+}
+
+// Lanes where a < b.
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint32_t avx512_less(__m512i a, __m512i b) {
+    if constexpr (std::is_same_v<T, float>) return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_LT_OQ);
+    else if constexpr (std::is_same_v<T, double>) return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_LT_OQ);
+    else return static_cast<std::uint32_t>(avx512_cmp<lane_t<T>, std::is_unsigned_v<T>, _MM_CMPINT_LT>(a, b));
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint32_t avx512_unordered(__m512i x) {
+    if constexpr (std::is_same_v<T, float>) return _mm512_cmp_ps_mask(_mm512_castsi512_ps(x), _mm512_castsi512_ps(x), _CMP_UNORD_Q);
+    else if constexpr (std::is_same_v<T, double>) return _mm512_cmp_pd_mask(_mm512_castsi512_pd(x), _mm512_castsi512_pd(x), _CMP_UNORD_Q);
+    else return 0;
+}
+
+// b where 'mask' is set, a elsewhere.
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_blend(std::uint32_t mask, __m512i a, __m512i b) {
+    if constexpr (sizeof(T) == 4) return _mm512_mask_blend_epi32(static_cast<__mmask16>(mask), a, b);
+    else return _mm512_mask_blend_epi64(static_cast<__mmask8>(mask), a, b);
+}
+
+struct avx512_extrema {
+    __m512i min;
+    __m512i max;
+    __m512i min_step;
+    __m512i max_step;
+};
+
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_update(avx512_extrema& e, __m512i x, __m512i step) {
+    if constexpr (FindMin) {
+        const std::uint32_t less = avx512_less<T>(x, e.min);
+        e.min = avx512_blend<T>(less, e.min, x);
+        e.min_step = avx512_blend<T>(less, e.min_step, step);
+    }
+    if constexpr (FindMax) {
+        if constexpr (LastMax) {
+            const std::uint32_t less = avx512_less<T>(x, e.max);
+            e.max = avx512_blend<T>(less, x, e.max);
+            e.max_step = avx512_blend<T>(less, step, e.max_step);
+        } else {
+            const std::uint32_t greater = avx512_less<T>(e.max, x);
+            e.max = avx512_blend<T>(greater, e.max, x);
+            e.max_step = avx512_blend<T>(greater, e.max_step, step);
+        }
+    }
+}
+
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_merge(const T* data, extrema_indices& best, const avx512_extrema& e,
+                                                    std::size_t offset, std::size_t stride) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    using Step = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    std::array<T, lanes> min{}, max{};
+    std::array<Step, lanes> min_step{}, max_step{};
+    _mm512_storeu_si512(min.data(), e.min);
+    _mm512_storeu_si512(max.data(), e.max);
+    _mm512_storeu_si512(min_step.data(), e.min_step);
+    _mm512_storeu_si512(max_step.data(), e.max_step);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        if constexpr (FindMin) merge_min(data, best, min[lane], std::size_t{min_step[lane]} * stride + offset + lane);
+        if constexpr (FindMax) merge_max<LastMax>(data, best, max[lane], std::size_t{max_step[lane]} * stride + offset + lane);
+    }
+}
+
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+STL_EXAMPLES_TARGET_AVX512 bool extrema_avx512(const T* data, std::size_t n, extrema_indices& best) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    constexpr std::size_t stride = 2 * lanes;
+    const __m512i one = sizeof(T) == 4 ? _mm512_set1_epi32(1) : _mm512_set1_epi64(1);
+    __m512i step = _mm512_setzero_si512();
+    const __m512i x0 = _mm512_loadu_si512(data);
+    const __m512i x1 = _mm512_loadu_si512(data + lanes);
+    avx512_extrema e0{x0, x0, step, step};
+    avx512_extrema e1{x1, x1, step, step};
+    std::uint32_t unordered = avx512_unordered<T>(x0) | avx512_unordered<T>(x1);
+    std::size_t i = stride;
+    for (; i + stride <= n; i += stride) {
+        step = sizeof(T) == 4 ? _mm512_add_epi32(step, one) : _mm512_add_epi64(step, one);
+        const __m512i y0 = _mm512_loadu_si512(data + i);
+        const __m512i y1 = _mm512_loadu_si512(data + i + lanes);
+        unordered |= avx512_unordered<T>(y0) | avx512_unordered<T>(y1);
+        avx512_update<FindMin, FindMax, LastMax, T>(e0, y0, step);
+        avx512_update<FindMin, FindMax, LastMax, T>(e1, y1, step);
+    }
+    if (unordered != 0) return false;
+    best = {0, 0};
+    avx512_merge<FindMin, FindMax, LastMax>(data, best, e0, 0, stride);
+    avx512_merge<FindMin, FindMax, LastMax>(data, best, e1, lanes, stride);
+    if (has_nan(data + i, n - i)) return false;
+    extrema_scalar<FindMin, FindMax, LastMax>(data, i, n, best);
+    return true;
+}
+
+// Clamps the elements at [p, p + 32 bytes) to [lo, hi], as std::clamp: x < lo
+// gives lo, hi < x gives hi, anything else (a NaN too) is kept.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline void avx2_clamp(T* p, __m256i lo, __m256i hi) {
+    const __m256i x = avx2_load(p);
+    const __m256i y = _mm256_blendv_epi8(x, lo, avx2_less<T>(x, lo));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_blendv_epi8(y, hi, avx2_less<T>(hi, x)));
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 void clamp_avx2(T* data, std::size_t n, const T& lo, const T& hi) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    const __m256i vlo = avx2_set1(std::bit_cast<bits_of_t<T>>(lo));
+    const __m256i vhi = avx2_set1(std::bit_cast<bits_of_t<T>>(hi));
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        avx2_clamp(data + i, vlo, vhi);
+        avx2_clamp(data + i + lanes, vlo, vhi);
+    }
+    for (; i + lanes <= n; i += lanes) avx2_clamp(data + i, vlo, vhi);
+    clamp_scalar(data + i, n - i, lo, hi);
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline void avx512_clamp(T* p, __m512i lo, __m512i hi) {
+    const __m512i x = _mm512_loadu_si512(p);
+    const __m512i y = avx512_blend<T>(avx512_less<T>(x, lo), x, lo);
+    _mm512_storeu_si512(p, avx512_blend<T>(avx512_less<T>(hi, x), y, hi));
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 void clamp_avx512(T* data, std::size_t n, const T& lo, const T& hi) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    const __m512i vlo = avx512_set1(std::bit_cast<bits_of_t<T>>(lo));
+    const __m512i vhi = avx512_set1(std::bit_cast<bits_of_t<T>>(hi));
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        avx512_clamp(data + i, vlo, vhi);
+        avx512_clamp(data + i + lanes, vlo, vhi);
+    }
+    for (; i + lanes <= n; i += lanes) avx512_clamp(data + i, vlo, vhi);
+    clamp_scalar(data + i, n - i, lo, hi);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Finds the extrema of data[0, n) with the kernel for the current Level. Returns
+// false if there is no kernel for it, or if the range holds a NaN.
+template<bool FindMin, bool FindMax, bool LastMax, class T>
+bool find_extrema(const T* data, std::size_t n, extrema_indices& best) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512:
+            return n >= 128 / sizeof(T) && extrema_avx512<FindMin, FindMax, LastMax>(data, n, best);
+        case Level::avx2:
+            return n >= 64 / sizeof(T) && extrema_avx2<FindMin, FindMax, LastMax>(data, n, best);
+        case Level::scalar: break;
+    }
+#endif
+    return false;
+}
+
+template<class T>
+void clamp(T* data, std::size_t n, const T& lo, const T& hi) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return clamp_avx512(data, n, lo, hi);
+        case Level::avx2: return clamp_avx2(data, n, lo, hi);
+        case Level::scalar: break;
+    }
+#endif
+    clamp_scalar(data, n, lo, hi);
+}
+
+} // namespace detail
+
+template<class Iter>
+Iter min_element(Iter first, Iter last) {
+    if constexpr (detail::is_extrema_range_v<Iter>) {
+        detail::extrema_indices best;
+        if (detail::find_extrema<true, false, false>(std::to_address(first), static_cast<std::size_t>(last - first), best)) {
+            return first + best.min;
+        }
+    }
+    return std::min_element(first, last);
+}
+
+template<class Iter>
+Iter max_element(Iter first, Iter last) {
+    if constexpr (detail::is_extrema_range_v<Iter>) {
+        detail::extrema_indices best;
+        if (detail::find_extrema<false, true, false>(std::to_address(first), static_cast<std::size_t>(last - first), best)) {
+            return first + best.max;
+        }
+    }
+    return std::max_element(first, last);
+}
+
+template<class Iter>
+std::pair<Iter, Iter> minmax_element(Iter first, Iter last) {
+    if constexpr (detail::is_extrema_range_v<Iter>) {
+        detail::extrema_indices best;
+        if (detail::find_extrema<true, true, true>(std::to_address(first), static_cast<std::size_t>(last - first), best)) {
+            return {first + best.min, first + best.max};
+        }
+    }
+    return std::minmax_element(first, last);
+}
+
+// The extrema of the non-empty range [first, last), by value and index, in one pass.
+template<class Iter>
+extrema_result<std::iter_value_t<Iter>> extrema(Iter first, Iter last) {
+    const auto [min, max] = simd::minmax_element(first, last);
+    return {*min, *max, static_cast<std::size_t>(std::distance(first, min)), static_cast<std::size_t>(std::distance(first, max))};
+}
+
+// Clamps every element of [first, last) to [lo, hi] in place, as std::clamp would.
+template<class Iter, class T>
+void clamp(Iter first, Iter last, const T& lo, const T& hi) {
+    using V = std::iter_value_t<Iter>;
+    if constexpr (std::contiguous_iterator<Iter> && detail::is_extrema_kernel_v<V> && std::is_same_v<V, T>) {
+        detail::clamp(std::to_address(first), static_cast<std::size_t>(last - first), lo, hi);
+    } else {
+        for (; first != last; ++first) *first = std::clamp<V>(*first, lo, hi);
+    }
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_MINMAX_H
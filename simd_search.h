@@ -0,0 +1,381 @@
+#ifndef STL_EXAMPLES_SIMD_SEARCH_H
+#define STL_EXAMPLES_SIMD_SEARCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "simd_dispatch.h"
+
+// Drop-in replacements for std::find, find_if, find_if_not, count, count_if,
+// any_of, all_of, and none_of that compare 32 (AVX2) or 64 (AVX-512) bytes at a time.
+//
+// The vectorized path is taken for contiguous ranges of integers or chars, when the
+// predicate is one of the two below. Anything else falls back to the std algorithm.
+//
+//       simd::count_if(v.cbegin(), v.cend(), simd::in_range<char>{'a', 'z'});
+namespace stl_examples::simd {
+
+// Matches elements equal to 'value'.
+template<class T>
+struct equal_to {
+    T value;
+    constexpr bool operator()(const T& x) const { return x == value; }
+};
+
+// Matches elements in the closed range [lo, hi].
+template<class T>
+struct in_range {
+    T lo;
+    T hi;
+    constexpr bool operator()(const T& x) const { return lo <= x && x <= hi; }
+};
+
+namespace detail {
+
+template<class T>
+inline constexpr bool is_lane_type_v = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                       (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// True if [Iter, Iter) can be handed to the kernels as a T array.
+template<class Iter, class T>
+inline constexpr bool is_contiguous_range_of_v =
+        std::contiguous_iterator<Iter> && std::is_same_v<std::iter_value_t<Iter>, T> && is_lane_type_v<T>;
+
+// The kernels see every element as a signed integer S of the same width. For
+// unsigned element types, 'Unsigned' selects unsigned comparisons.
+template<class T>
+using lane_t = std::make_signed_t<T>;
+
+// Bits of the element sign, used to order unsigned values with signed compares.
+template<class S>
+inline constexpr S sign_bit = static_cast<S>(std::make_unsigned_t<S>{1} << (sizeof(S) * 8 - 1));
+
+template<class S, bool Unsigned, bool Range>
+constexpr bool matches(S x, S lo, S hi) {
+    if constexpr (!Range) return x == lo;
+    else if constexpr (Unsigned) {
+        using U = std::make_unsigned_t<S>;
+        return static_cast<U>(lo) <= static_cast<U>(x) && static_cast<U>(x) <= static_cast<U>(hi);
+    } else return lo <= x && x <= hi;
+}
+
+// Index of the first element that matches (or, with Negate, does not match), or n.
+template<class S, bool Unsigned, bool Range, bool Negate>
+std::size_t find_scalar(const S* data, std::size_t n, S lo, S hi) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (matches<S, Unsigned, Range>(data[i], lo, hi) != Negate) return i;
+    }
+    return n;
+}
+
+template<class S, bool Unsigned, bool Range>
+std::size_t count_scalar(const S* data, std::size_t n, S lo, S hi) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) count += matches<S, Unsigned, Range>(data[i], lo, hi);
+    return count;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+template<class S>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_set1(S x) {
+    if constexpr (sizeof(S) == 1) return _mm256_set1_epi8(x);
+    else if constexpr (sizeof(S) == 2) return _mm256_set1_epi16(x);
+    else if constexpr (sizeof(S) == 4) return _mm256_set1_epi32(x);
+    else return _mm256_set1_epi64x(x);
+}
+
+template<std::size_t Size>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_eq(__m256i a, __m256i b) {
+    if constexpr (Size == 1) return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (Size == 2) return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (Size == 4) return _mm256_cmpeq_epi32(a, b);
+    else return _mm256_cmpeq_epi64(a, b);
+}
+
+template<std::size_t Size>
+STL_EXAMPLES_TARGET_AVX2 inline __m256i avx2_gt(__m256i a, __m256i b) {
+    if constexpr (Size == 1) return _mm256_cmpgt_epi8(a, b);
+    else if constexpr (Size == 2) return _mm256_cmpgt_epi16(a, b);
+    else if constexpr (Size == 4) return _mm256_cmpgt_epi32(a, b);
+    else return _mm256_cmpgt_epi64(a, b);
+}
+
+// One bit per byte of the 32 bytes at 'p', set for the bytes of matching elements.
+// For unsigned ranges, 'lo', 'hi', and 'bias' have been flipped by sign_bit already.
+// The vectors are taken by reference, since the lambdas of find_avx2 that call
+// this are not compiled for AVX2 and cannot pass them in registers.
+template<class S, bool Unsigned, bool Range>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_match_mask(const S* p, const __m256i& lo, const __m256i& hi, const __m256i& bias) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    if constexpr (!Range) {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(avx2_eq<sizeof(S)>(x, lo)));
+    } else {
+        if constexpr (Unsigned) x = _mm256_xor_si256(x, bias);
+        const __m256i outside = _mm256_or_si256(avx2_gt<sizeof(S)>(lo, x), avx2_gt<sizeof(S)>(x, hi));
+        return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(outside));
+    }
+}
+
+template<class S, bool Unsigned, bool Range, bool Negate>
+STL_EXAMPLES_TARGET_AVX2 std::size_t find_avx2(const S* data, std::size_t n, S lo, S hi) {
+    constexpr std::size_t lanes = 32 / sizeof(S);
+    const S bias = Unsigned && Range ? sign_bit<S> : S{0};
+    const __m256i vlo = avx2_set1<S>(static_cast<S>(lo ^ bias));
+    const __m256i vhi = avx2_set1<S>(static_cast<S>(hi ^ bias));
+    const __m256i vbias = avx2_set1<S>(bias);
+    const auto mask = [&](std::size_t i)->std::uint32_t {
+        const std::uint32_t m = avx2_match_mask<S, Unsigned, Range>(data + i, vlo, vhi, vbias);
+        return Negate ? ~m : m;
+    };
+
+    std::size_t i = 0;
+    // Four vectors per iteration, with a single branch on whether any of them matched.
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        const std::uint32_t m0 = mask(i), m1 = mask(i + lanes), m2 = mask(i + 2 * lanes), m3 = mask(i + 3 * lanes);
+        if ((m0 | m1 | m2 | m3) != 0) {
+            if (m0 != 0) return i + __builtin_ctz(m0) / sizeof(S);
+            if (m1 != 0) return i + lanes + __builtin_ctz(m1) / sizeof(S);
+            if (m2 != 0) return i + 2 * lanes + __builtin_ctz(m2) / sizeof(S);
+            return i + 3 * lanes + __builtin_ctz(m3) / sizeof(S);
+        }
+    }
+    for (; i + lanes <= n; i += lanes) {
+        if (const std::uint32_t m = mask(i); m != 0) return i + __builtin_ctz(m) / sizeof(S);
+    }
+    return i + find_scalar<S, Unsigned, Range, Negate>(data + i, n - i, lo, hi);
+}
+
+template<class S, bool Unsigned, bool Range>
+STL_EXAMPLES_TARGET_AVX2 std::size_t count_avx2(const S* data, std::size_t n, S lo, S hi) {
+    constexpr std::size_t lanes = 32 / sizeof(S);
+    const S bias = Unsigned && Range ? sign_bit<S> : S{0};
+    const __m256i vlo = avx2_set1<S>(static_cast<S>(lo ^ bias));
+    const __m256i vhi = avx2_set1<S>(static_cast<S>(hi ^ bias));
+    const __m256i vbias = avx2_set1<S>(bias);
+
+    // Counts matching bytes, then converts to elements at the end.
+    std::size_t bytes = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        bytes += _mm_popcnt_u32(avx2_match_mask<S, Unsigned, Range>(data + i, vlo, vhi, vbias));
+    }
+    return bytes / sizeof(S) + count_scalar<S, Unsigned, Range>(data + i, n - i, lo, hi);
+}
+
+template<class S>
+STL_EXAMPLES_TARGET_AVX512 inline __m512i avx512_set1(S x) {
+    if constexpr (sizeof(S) == 1) return _mm512_set1_epi8(x);
+    else if constexpr (sizeof(S) == 2) return _mm512_set1_epi16(x);
+    else if constexpr (sizeof(S) == 4) return _mm512_set1_epi32(x);
+    else return _mm512_set1_epi64(x);
+}
+
+// Compares each element of 'a' against 'b' with the _MM_CMPINT_* predicate 'Op'.
+template<class S, bool Unsigned, int Op>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_cmp(__m512i a, __m512i b) {
+    if constexpr (sizeof(S) == 1) return Unsigned ? _mm512_cmp_epu8_mask(a, b, Op) : _mm512_cmp_epi8_mask(a, b, Op);
+    else if constexpr (sizeof(S) == 2) return Unsigned ? _mm512_cmp_epu16_mask(a, b, Op) : _mm512_cmp_epi16_mask(a, b, Op);
+    else if constexpr (sizeof(S) == 4) return Unsigned ? _mm512_cmp_epu32_mask(a, b, Op) : _mm512_cmp_epi32_mask(a, b, Op);
+    else return Unsigned ? _mm512_cmp_epu64_mask(a, b, Op) : _mm512_cmp_epi64_mask(a, b, Op);
+}
+
+// One bit per element of the 64 bytes at 'p', set for matching elements. By
+// reference, as for avx2_match_mask.
+template<class S, bool Unsigned, bool Range>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_match_mask(const S* p, const __m512i& lo, const __m512i& hi) {
+    const __m512i x = _mm512_loadu_si512(p);
+    if constexpr (!Range) return avx512_cmp<S, Unsigned, _MM_CMPINT_EQ>(x, lo);
+    else return avx512_cmp<S, Unsigned, _MM_CMPINT_LE>(lo, x) & avx512_cmp<S, Unsigned, _MM_CMPINT_LE>(x, hi);
+}
+
+template<class S, bool Unsigned, bool Range, bool Negate>
+STL_EXAMPLES_TARGET_AVX512 std::size_t find_avx512(const S* data, std::size_t n, S lo, S hi) {
+    constexpr std::size_t lanes = 64 / sizeof(S);
+    constexpr std::uint64_t all_lanes = lanes == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << lanes) - 1;
+    const __m512i vlo = avx512_set1<S>(lo);
+    const __m512i vhi = avx512_set1<S>(hi);
+    const auto mask = [&](std::size_t i)->std::uint64_t {
+        const std::uint64_t m = avx512_match_mask<S, Unsigned, Range>(data + i, vlo, vhi);
+        return Negate ? ~m & all_lanes : m;
+    };
+
+    std::size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        const std::uint64_t m0 = mask(i), m1 = mask(i + lanes), m2 = mask(i + 2 * lanes), m3 = mask(i + 3 * lanes);
+        if ((m0 | m1 | m2 | m3) != 0) {
+            if (m0 != 0) return i + __builtin_ctzll(m0);
+            if (m1 != 0) return i + lanes + __builtin_ctzll(m1);
+            if (m2 != 0) return i + 2 * lanes + __builtin_ctzll(m2);
+            return i + 3 * lanes + __builtin_ctzll(m3);
+        }
+    }
+    for (; i + lanes <= n; i += lanes) {
+        if (const std::uint64_t m = mask(i); m != 0) return i + __builtin_ctzll(m);
+    }
+    return i + find_scalar<S, Unsigned, Range, Negate>(data + i, n - i, lo, hi);
+}
+
+template<class S, bool Unsigned, bool Range>
+STL_EXAMPLES_TARGET_AVX512 std::size_t count_avx512(const S* data, std::size_t n, S lo, S hi) {
+    constexpr std::size_t lanes = 64 / sizeof(S);
+    const __m512i vlo = avx512_set1<S>(lo);
+    const __m512i vhi = avx512_set1<S>(hi);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) count += _mm_popcnt_u64(avx512_match_mask<S, Unsigned, Range>(data + i, vlo, vhi));
+    return count + count_scalar<S, Unsigned, Range>(data + i, n - i, lo, hi);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Dispatches to the best kernel for the current Level.
+template<class T, bool Range, bool Negate>
+std::size_t find_index(const T* data, std::size_t n, T lo, T hi) {
+    using S = lane_t<T>;
+    constexpr bool is_unsigned = std::is_unsigned_v<T>;
+    const S* p = reinterpret_cast<const S*>(data);
+    const S slo = static_cast<S>(lo);
+    const S shi = static_cast<S>(hi);
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return find_avx512<S, is_unsigned, Range, Negate>(p, n, slo, shi);
+        case Level::avx2: return find_avx2<S, is_unsigned, Range, Negate>(p, n, slo, shi);
+        case Level::scalar: break;
+    }
+#endif
+    return find_scalar<S, is_unsigned, Range, Negate>(p, n, slo, shi);
+}
+
+template<class T, bool Range>
+std::size_t count_matches(const T* data, std::size_t n, T lo, T hi) {
+    using S = lane_t<T>;
+    constexpr bool is_unsigned = std::is_unsigned_v<T>;
+    const S* p = reinterpret_cast<const S*>(data);
+    const S slo = static_cast<S>(lo);
+    const S shi = static_cast<S>(hi);
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return count_avx512<S, is_unsigned, Range>(p, n, slo, shi);
+        case Level::avx2: return count_avx2<S, is_unsigned, Range>(p, n, slo, shi);
+        case Level::scalar: break;
+    }
+#endif
+    return count_scalar<S, is_unsigned, Range>(p, n, slo, shi);
+}
+
+// Compares exactly as 'element == value' does inside std::find, including the
+// usual arithmetic conversions between signed and unsigned types.
+template<class T, class U>
+constexpr bool std_equal(const T& element, const U& value) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+    return element == value;
+#pragma GCC diagnostic pop
+}
+
+template<class Pred>
+struct kernel_predicate : std::false_type {};
+template<class T>
+struct kernel_predicate<equal_to<T>> : std::true_type {
+    static T lo(const equal_to<T>& p) { return p.value; }
+    static T hi(const equal_to<T>& p) { return p.value; }
+    static constexpr bool range = false;
+};
+template<class T>
+struct kernel_predicate<in_range<T>> : std::true_type {
+    static T lo(const in_range<T>& p) { return p.lo; }
+    static T hi(const in_range<T>& p) { return p.hi; }
+    static constexpr bool range = true;
+};
+
+// True if find_if(Iter, Iter, Pred) can use the kernels.
+template<class Iter, class Pred>
+inline constexpr bool is_vectorizable_v = [] {
+    if constexpr (std::contiguous_iterator<Iter> && kernel_predicate<Pred>::value) {
+        return is_contiguous_range_of_v<Iter, decltype(kernel_predicate<Pred>::lo(std::declval<Pred>()))>;
+    } else return false;
+}();
+
+template<bool Negate, class Iter, class Pred>
+Iter find_if(Iter first, Iter last, const Pred& pred) {
+    if constexpr (is_vectorizable_v<Iter, Pred>) {
+        using traits = kernel_predicate<Pred>;
+        const std::size_t n = last - first;
+        return first + find_index<std::iter_value_t<Iter>, traits::range, Negate>(
+                std::to_address(first), n, traits::lo(pred), traits::hi(pred));
+    } else if constexpr (Negate) {
+        return std::find_if_not(first, last, pred);
+    } else {
+        return std::find_if(first, last, pred);
+    }
+}
+
+} // namespace detail
+
+template<class Iter, class Pred>
+Iter find_if(Iter first, Iter last, Pred pred) {
+    return detail::find_if</*Negate=*/false>(first, last, pred);
+}
+
+template<class Iter, class Pred>
+Iter find_if_not(Iter first, Iter last, Pred pred) {
+    return detail::find_if</*Negate=*/true>(first, last, pred);
+}
+
+template<class Iter, class U>
+Iter find(Iter first, Iter last, const U& value) {
+    using T = std::iter_value_t<Iter>;
+    if constexpr (detail::is_contiguous_range_of_v<Iter, T> && std::is_integral_v<U>) {
+        // If converting 'value' to T changes it, no element can compare equal to it.
+        const T narrowed = static_cast<T>(value);
+        if (!detail::std_equal(narrowed, value)) return last;
+        return simd::find_if(first, last, equal_to<T>{narrowed});
+    } else {
+        return std::find(first, last, value);
+    }
+}
+
+template<class Iter, class Pred>
+std::iter_difference_t<Iter> count_if(Iter first, Iter last, Pred pred) {
+    if constexpr (detail::is_vectorizable_v<Iter, Pred>) {
+        using traits = detail::kernel_predicate<Pred>;
+        return static_cast<std::iter_difference_t<Iter>>(detail::count_matches<std::iter_value_t<Iter>, traits::range>(
+                std::to_address(first), last - first, traits::lo(pred), traits::hi(pred)));
+    } else {
+        return std::count_if(first, last, pred);
+    }
+}
+
+template<class Iter, class U>
+std::iter_difference_t<Iter> count(Iter first, Iter last, const U& value) {
+    using T = std::iter_value_t<Iter>;
+    if constexpr (detail::is_contiguous_range_of_v<Iter, T> && std::is_integral_v<U>) {
+        const T narrowed = static_cast<T>(value);
+        if (!detail::std_equal(narrowed, value)) return 0;
+        return simd::count_if(first, last, equal_to<T>{narrowed});
+    } else {
+        return std::count(first, last, value);
+    }
+}
+
+template<class Iter, class Pred>
+bool any_of(Iter first, Iter last, Pred pred) {
+    return simd::find_if(first, last, pred) != last;
+}
+
+template<class Iter, class Pred>
+bool all_of(Iter first, Iter last, Pred pred) {
+    return simd::find_if_not(first, last, pred) == last;
+}
+
+template<class Iter, class Pred>
+bool none_of(Iter first, Iter last, Pred pred) {
+    return simd::find_if(first, last, pred) == last;
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_SEARCH_H
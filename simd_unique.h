@@ -0,0 +1,313 @@
+#ifndef STL_EXAMPLES_SIMD_UNIQUE_H
+#define STL_EXAMPLES_SIMD_UNIQUE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd_compaction.h"
+#include "simd_dispatch.h"
+#include "simd_search.h"
+
+// Drop-in replacements for std::adjacent_find and std::unique that compare each
+// vector of elements with the same vector shifted by one, and a unique + erase
+// that also returns the length of each run of equal elements:
+//
+//       v.erase(simd::unique(v.begin(), v.end()), v.end());
+//       const std::vector<std::size_t> runs = simd::unique_erase(ids);
+//
+// For contiguous ranges of arithmetic types, the equal neighbours of 32 (AVX2) or
+// 64 (AVX-512) bytes of elements are found at once. unique then packs the first
+// element of each run together in place, with the compress of simd_compaction.h,
+// for 32- and 64-bit elements; other arithmetic types use a scalar loop that
+// writes every element and advances by whether it starts a run. Anything else
+// falls back to the std algorithm.
+//
+// Elements are compared with ==, as by the std algorithms: a NaN is never equal
+// to its neighbour, and -0.0 equals 0.0. Comparing each element with the one
+// before it, rather than with the last one kept, gives the same result, since ==
+// is transitive on arithmetic types.
+namespace stl_examples::simd {
+
+namespace detail {
+
+template<class T>
+inline constexpr bool is_unique_kernel_v = is_compactable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+// True if adjacent_find and unique on [Iter, Iter) can use the kernels.
+template<class Iter>
+inline constexpr bool is_unique_range_v =
+        std::contiguous_iterator<Iter> && is_compactable_v<std::iter_value_t<Iter>> && sizeof(std::iter_value_t<Iter>) <= 8;
+
+template<class T>
+std::size_t adjacent_find_scalar(const T* data, std::size_t n) {
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        if (data[i] == data[i + 1]) return i;
+    }
+    return n;
+}
+
+// Continues unique from element i >= 1, with 'kept' elements kept so far, and
+// returns the number kept. With MarkStarts, sets bit i of 'starts' for each
+// element i that is kept.
+template<bool MarkStarts, class T>
+std::size_t unique_scalar(T* data, std::size_t i, std::size_t n, std::size_t kept, std::uint64_t* starts) {
+    T previous = data[i - 1];
+    for (; i < n; ++i) {
+        const T x = data[i];
+        const bool is_start = !(x == previous);
+        data[kept] = x;
+        kept += is_start;
+        if constexpr (MarkStarts) starts[i / 64] |= std::uint64_t{is_start} << (i % 64);
+        previous = x;
+    }
+    return kept;
+}
+
+// Sets the bits of 'mask', one per lane, in 'starts' from bit i on.
+template<std::size_t Lanes>
+inline void mark_starts(std::uint64_t* starts, std::size_t i, std::uint64_t mask) {
+    const std::size_t word = i / 64;
+    const std::size_t bit = i % 64;
+    starts[word] |= mask << bit;
+    if (bit + Lanes > 64) starts[word + 1] |= mask >> (64 - bit);
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// One bit per lane, set where 'a' equals 'b'.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_equal_lanes(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 1) return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    else if constexpr (sizeof(T) == 2) return _pext_u32(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b))), 0x55555555);
+    else return avx2_lane_mask<T, false>(a, b, b);
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_equal_lanes(__m512i a, __m512i b) {
+    if constexpr (sizeof(T) <= 2) return avx512_cmp<lane_t<T>, false, _MM_CMPINT_EQ>(a, b);
+    else return avx512_lane_mask<T, false>(a, b, b);
+}
+
+// One bit per element of the 32 bytes at 'p', set for those equal to the next one.
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_pair_mask(const T* p) {
+    return avx2_equal_lanes<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)));
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_pair_mask(const T* p) {
+    return avx512_equal_lanes<T>(_mm512_loadu_si512(p), _mm512_loadu_si512(p + 1));
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX2 std::size_t adjacent_find_avx2(const T* data, std::size_t n) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    const auto mask = [&](std::size_t i){ return avx2_pair_mask(data + i); };
+
+    std::size_t i = 0;
+    // Four vectors per iteration, with a single branch on whether any of them has a pair.
+    for (; i + 4 * lanes < n; i += 4 * lanes) {
+        const std::uint32_t m0 = mask(i), m1 = mask(i + lanes), m2 = mask(i + 2 * lanes), m3 = mask(i + 3 * lanes);
+        if ((m0 | m1 | m2 | m3) != 0) {
+            if (m0 != 0) return i + std::countr_zero(m0);
+            if (m1 != 0) return i + lanes + std::countr_zero(m1);
+            if (m2 != 0) return i + 2 * lanes + std::countr_zero(m2);
+            return i + 3 * lanes + std::countr_zero(m3);
+        }
+    }
+    for (; i + lanes < n; i += lanes) {
+        if (const std::uint32_t m = mask(i); m != 0) return i + std::countr_zero(m);
+    }
+    return i + adjacent_find_scalar(data + i, n - i);
+}
+
+template<class T>
+STL_EXAMPLES_TARGET_AVX512 std::size_t adjacent_find_avx512(const T* data, std::size_t n) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    const auto mask = [&](std::size_t i){ return avx512_pair_mask(data + i); };
+
+    std::size_t i = 0;
+    for (; i + 4 * lanes < n; i += 4 * lanes) {
+        const std::uint64_t m0 = mask(i), m1 = mask(i + lanes), m2 = mask(i + 2 * lanes), m3 = mask(i + 3 * lanes);
+        if ((m0 | m1 | m2 | m3) != 0) {
+            if (m0 != 0) return i + std::countr_zero(m0);
+            if (m1 != 0) return i + lanes + std::countr_zero(m1);
+            if (m2 != 0) return i + 2 * lanes + std::countr_zero(m2);
+            return i + 3 * lanes + std::countr_zero(m3);
+        }
+    }
+    for (; i + lanes < n; i += lanes) {
+        if (const std::uint64_t m = mask(i); m != 0) return i + std::countr_zero(m);
+    }
+    return i + adjacent_find_scalar(data + i, n - i);
+}
+
+// The element before each vector is read back from 'data' after the previous
+// vector was packed: it has then been overwritten only if every element so far
+// was kept, by itself.
+template<bool MarkStarts, class T>
+STL_EXAMPLES_TARGET_AVX2 std::size_t unique_avx2(T* data, std::size_t n, std::uint64_t* starts) {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    constexpr std::uint32_t all_lanes = (1u << lanes) - 1;
+    std::size_t kept = 1;
+    std::size_t i = 1;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 1));
+        const std::uint32_t mask = ~avx2_equal_lanes<T>(x, previous) & all_lanes;
+        const std::size_t count = std::popcount(mask);
+        avx2_store_first<sizeof(T)>(data + kept, avx2_compress<sizeof(T)>(x, mask), count);
+        kept += count;
+        if constexpr (MarkStarts) mark_starts<lanes>(starts, i, mask);
+    }
+    return unique_scalar<MarkStarts>(data, i, n, kept, starts);
+}
+
+template<bool MarkStarts, class T>
+STL_EXAMPLES_TARGET_AVX512 std::size_t unique_avx512(T* data, std::size_t n, std::uint64_t* starts) {
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    constexpr std::uint32_t all_lanes = (1u << lanes) - 1;
+    std::size_t kept = 1;
+    std::size_t i = 1;
+    for (; i + lanes <= n; i += lanes) {
+        const __m512i x = _mm512_loadu_si512(data + i);
+        const __m512i previous = _mm512_loadu_si512(data + i - 1);
+        const std::uint32_t mask = ~static_cast<std::uint32_t>(avx512_equal_lanes<T>(x, previous)) & all_lanes;
+        avx512_compress_store<sizeof(T)>(data + kept, x, mask);
+        kept += std::popcount(mask);
+        if constexpr (MarkStarts) mark_starts<lanes>(starts, i, mask);
+    }
+    return unique_scalar<MarkStarts>(data, i, n, kept, starts);
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// Index of the first element equal to the next one, or n.
+template<class T>
+std::size_t adjacent_find_index(const T* data, std::size_t n) {
+#if STL_EXAMPLES_SIMD_X86
+    switch (level()) {
+        case Level::avx512: return adjacent_find_avx512(data, n);
+        case Level::avx2: return adjacent_find_avx2(data, n);
+        case Level::scalar: break;
+    }
+#endif
+    return adjacent_find_scalar(data, n);
+}
+
+// Packs the first element of each run of [data, data + n) at the start, and
+// returns their number. With MarkStarts, sets bit i of 'starts', which must be
+// zeroed, for each element i that is kept.
+template<bool MarkStarts, class T>
+std::size_t unique_in_place(T* data, std::size_t n, std::uint64_t* starts) {
+    if (n == 0) return 0;
+    if constexpr (MarkStarts) starts[0] |= 1;
+#if STL_EXAMPLES_SIMD_X86
+    if constexpr (is_unique_kernel_v<T>) {
+        switch (level()) {
+            case Level::avx512: return unique_avx512<MarkStarts>(data, n, starts);
+            case Level::avx2: return unique_avx2<MarkStarts>(data, n, starts);
+            case Level::scalar: break;
+        }
+    }
+#endif
+    return unique_scalar<MarkStarts>(data, 1, n, 1, starts);
+}
+
+// Writes to 'runs' the distances between the set bits of 'starts', the last one
+// to n. 'runs' is resized without being cleared first, so that only the elements
+// beyond its old size are zeroed before being overwritten.
+inline void run_lengths(const std::uint64_t* starts, std::size_t n, std::size_t num_runs, std::vector<std::size_t>& runs) {
+    runs.resize(num_runs);
+    if (num_runs == 0) return;
+    std::size_t run = 0;
+    std::size_t previous = 0;
+    for (std::size_t word = 0; word < (n + 63) / 64; ++word) {
+        // Bit 0 is the start of the first run, which has no run before it.
+        std::uint64_t bits = word == 0 ? starts[0] & ~std::uint64_t{1} : starts[word];
+        for (; bits != 0; bits &= bits - 1) {
+            const std::size_t start = word * 64 + std::countr_zero(bits);
+            runs[run++] = start - previous;
+            previous = start;
+        }
+    }
+    runs[run] = n - previous;
+}
+
+} // namespace detail
+
+template<class Iter>
+Iter adjacent_find(Iter first, Iter last) {
+    if constexpr (detail::is_unique_range_v<Iter>) {
+        return first + detail::adjacent_find_index(std::to_address(first), static_cast<std::size_t>(last - first));
+    } else {
+        return std::adjacent_find(first, last);
+    }
+}
+
+template<class Iter>
+Iter unique(Iter first, Iter last) {
+    if constexpr (detail::is_unique_range_v<Iter>) {
+        // Nothing is written before the first pair of equal elements.
+        const std::size_t n = last - first;
+        const std::size_t pair = detail::adjacent_find_index(std::to_address(first), n);
+        if (pair == n) return last;
+        return first + (pair + detail::unique_in_place<false>(std::to_address(first) + pair, n - pair, nullptr));
+    } else {
+        return std::unique(first, last);
+    }
+}
+
+// Erases the consecutive duplicates of 'c', as c.erase(unique(c.begin(), c.end()), c.end()),
+// and sets 'runs' to the length of the run of equal elements that each remaining
+// one stood for. On a sorted container, these are the number of occurrences of
+// each value.
+//
+// For a batch of a hundred million elements, 'runs' takes most of the time when
+// its memory is new, and has to be zeroed by the operating system: reuse it from
+// one batch to the next.
+template<class Container>
+void unique_erase(Container& c, std::vector<std::size_t>& runs) {
+    using Iter = decltype(std::begin(c));
+    const auto first = std::begin(c);
+    const auto last = std::end(c);
+    if constexpr (detail::is_unique_range_v<Iter>) {
+        const std::size_t n = last - first;
+        std::vector<std::uint64_t> starts((n + 63) / 64);
+        const std::size_t kept = detail::unique_in_place<true>(std::to_address(first), n, starts.data());
+        c.erase(first + kept, last);
+        detail::run_lengths(starts.data(), n, kept, runs);
+    } else {
+        runs.clear();
+        if (first == last) return;
+        auto result = first;
+        runs.push_back(1);
+        for (auto it = std::next(first); it != last; ++it) {
+            if (*result == *it) {
+                ++runs.back();
+            } else {
+                if (++result != it) *result = std::move(*it);
+                runs.push_back(1);
+            }
+        }
+        c.erase(std::next(result), last);
+    }
+}
+
+// Same as above, returning the run lengths.
+template<class Container>
+std::vector<std::size_t> unique_erase(Container& c) {
+    std::vector<std::size_t> runs;
+    unique_erase(c, runs);
+    return runs;
+}
+
+} // namespace stl_examples::simd
+
+#endif // STL_EXAMPLES_SIMD_UNIQUE_H
@@ -0,0 +1,176 @@
+#ifndef STL_EXAMPLES_SORT_BY_KEY_H
+#define STL_EXAMPLES_SORT_BY_KEY_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "radix_sort.h"
+
+// A stable sort for records that are expensive to move, such as ones holding
+// strings or large payloads:
+//
+//       stable_sort_by_key(people.begin(), people.end(), &Person::age);
+//       stable_sort_by_key(people.begin(), people.end(), &Person::name, std::greater<>());
+//
+// std::stable_sort moves every record O(log n) times. Here the keys are sorted
+// instead, and each record is moved a constant number of times: once along a
+// cycle within a cache-sized block, plus one swap into its block for each pass
+// over a larger range (one pass per factor of 256 above 2 MB of records):
+//
+//   1. The key of each record is copied, with its index, into a compact array
+//      of (key, index) pairs. The key function is called once per record.
+//   2. The pairs are sorted: by radix_sort for integer and floating-point keys
+//      ordered by std::less or std::greater, otherwise by std::sort with the
+//      index breaking ties. -0.0 and 0.0 are equal keys; NaN keys, which
+//      std::less does not order, go after +infinity (before -infinity if
+//      negative), as in radix_sort.
+//   3. The permutation is applied in place: the records are swapped
+//      into cache-sized blocks of their destinations, then moved along the
+//      cycles of the permutation within each block (see permute_to).
+//
+// The extra memory is the pairs, typically 8 or 16 bytes per record, then
+// 4 bytes per record for the destinations.
+namespace stl_examples {
+
+namespace detail {
+
+template<class Compare, class Key>
+inline constexpr bool is_less_v = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<Key>>;
+
+template<class Compare, class Key>
+inline constexpr bool is_greater_v = std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<Key>>;
+
+template<class Key, class Index>
+struct KeyIndex {
+    Key key;
+    Index index;
+};
+
+// Records in blocks of this size are permuted by following cycles; the moves
+// are random, but within the L2 or L3 cache.
+inline constexpr std::size_t permutation_block_bytes = std::size_t{1} << 21;
+// Larger ranges are first split into up to this many blocks.
+inline constexpr int permutation_fan_out_bits = 8;
+
+// Moves each record at a position p in [lo, hi) to position dest[p], updating
+// dest along, where dest is a permutation of [lo, hi).
+//
+// Following the cycles of a random permutation directly would make each move a
+// cache miss that depends on the one before. Instead, a large range is first
+// split in place, like an American flag sort, into blocks of consecutive
+// destinations: every record is swapped into the next free slot of its block,
+// so that the writes go to a few hundred sequential streams. The blocks are
+// then permuted the same way until they fit in the cache.
+template<class RandomIt, class Index>
+void permute_to(RandomIt first, Index* dest, std::size_t lo, std::size_t hi) {
+    using std::swap;
+    const std::size_t n = hi - lo;
+    // A single record is in place, even one larger than a block.
+    if (n <= 1) return;
+    if (n * sizeof(std::iter_value_t<RandomIt>) <= permutation_block_bytes) {
+        for (std::size_t start = lo; start < hi; ++start) {
+            std::size_t to = dest[start];
+            if (to == start) continue;
+            auto held = std::move(first[start]);
+            while (to != start) {
+                swap(held, first[to]);
+                const std::size_t next = dest[to];
+                dest[to] = static_cast<Index>(to);
+                to = next;
+            }
+            first[start] = std::move(held);
+            dest[start] = static_cast<Index>(start);
+        }
+        return;
+    }
+
+    const int shift = std::bit_width((n - 1) >> permutation_fan_out_bits);
+    const std::size_t num_blocks = ((n - 1) >> shift) + 1;
+    std::array<std::size_t, std::size_t{1} << permutation_fan_out_bits> next;
+    for (std::size_t b = 0; b < num_blocks; ++b) next[b] = lo + (b << shift);
+    for (std::size_t b = 0; b < num_blocks; ++b) {
+        const std::size_t end = std::min(hi, lo + ((b + 1) << shift));
+        while (next[b] < end) {
+            const std::size_t p = next[b];
+            const std::size_t target = (dest[p] - lo) >> shift;
+            if (target == b) {
+                ++next[b];
+                continue;
+            }
+            const std::size_t q = next[target]++;
+            swap(first[p], first[q]);
+            swap(dest[p], dest[q]);
+        }
+    }
+    for (std::size_t b = 0; b < num_blocks; ++b) {
+        permute_to(first, dest, lo + (b << shift), std::min(hi, lo + ((b + 1) << shift)));
+    }
+}
+
+// The destination of each record, from the sorted (key, index) pairs, which are freed.
+template<class Index, class Entry>
+std::vector<Index> destinations(std::vector<Entry> entries) {
+    std::vector<Index> dest(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) dest[entries[i].index] = static_cast<Index>(i);
+    return dest;
+}
+
+template<class Index, class RandomIt, class KeyFn, class Compare>
+void stable_sort_by_key(RandomIt first, std::size_t n, KeyFn& key, Compare& comp) {
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyFn&, std::iter_reference_t<RandomIt>>>;
+    if constexpr (is_radix_key_v<Key> && (is_less_v<Compare, Key> || is_greater_v<Compare, Key>)) {
+        using Bits = radix_bits_t<Key>;
+        std::vector<KeyIndex<Bits, Index>> entries(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            Key k = std::invoke(key, first[i]);
+            // -0.0 and 0.0 are equal under std::less, so they must keep their order.
+            if constexpr (std::is_floating_point_v<Key>) {
+                if (k == Key{0}) k = Key{0};
+            }
+            const Bits bits = radix_bits<Key>(k);
+            entries[i] = {is_less_v<Compare, Key> ? bits : static_cast<Bits>(~bits), static_cast<Index>(i)};
+        }
+        lsd_radix_sort(entries.begin(), n, [](const KeyIndex<Bits, Index>& e){ return e.key; });
+        std::vector<Index> dest = destinations<Index>(std::move(entries));
+        permute_to(first, dest.data(), 0, n);
+    } else {
+        std::vector<KeyIndex<Key, Index>> entries;
+        entries.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) entries.push_back({std::invoke(key, first[i]), static_cast<Index>(i)});
+        // The indices are distinct, so breaking ties by them makes std::sort stable.
+        std::sort(entries.begin(), entries.end(), [&](const KeyIndex<Key, Index>& a, const KeyIndex<Key, Index>& b) {
+            if (comp(a.key, b.key)) return true;
+            if (comp(b.key, a.key)) return false;
+            return a.index < b.index;
+        });
+        std::vector<Index> dest = destinations<Index>(std::move(entries));
+        permute_to(first, dest.data(), 0, n);
+    }
+}
+
+} // namespace detail
+
+// Sorts [first, last) so that comp(key(a), key(b)) holds for every element a
+// before an element b with a different key, keeping equal keys in their order,
+// like std::stable_sort with the comparison comp(key(a), key(b)).
+template<std::random_access_iterator RandomIt, class KeyFn, class Compare = std::less<>>
+    requires std::invocable<KeyFn&, std::iter_reference_t<RandomIt>>
+void stable_sort_by_key(RandomIt first, RandomIt last, KeyFn key, Compare comp = {}) {
+    const auto n = static_cast<std::size_t>(last - first);
+    // 32-bit indices when they suffice, so that the pairs stay small.
+    if (n <= std::numeric_limits<std::uint32_t>::max()) detail::stable_sort_by_key<std::uint32_t>(first, n, key, comp);
+    else detail::stable_sort_by_key<std::uint64_t>(first, n, key, comp);
+}
+
+} // namespace stl_examples
+
+#endif // STL_EXAMPLES_SORT_BY_KEY_H
@@ -0,0 +1,459 @@
+#ifndef STL_EXAMPLES_SUBSTRING_SEARCH_H
+#define STL_EXAMPLES_SUBSTRING_SEARCH_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "simd_dispatch.h"
+
+// Substring search over byte buffers, such as a log file read into memory:
+//
+//       const auto match = substring::search(log.cbegin(), log.cend(), pattern.cbegin(), pattern.cend());
+//       const auto it = std::search(log.cbegin(), log.cend(), substring::simd_searcher(pattern.cbegin(), pattern.cend()));
+//
+// The searchers follow the protocol of std::boyer_moore_searcher, for std::search:
+//
+//   - horspool_searcher skips ahead by a table of the last position of each byte
+//     in the pattern. Sublinear on text that differs from the pattern, O(n m) at worst.
+//   - two_way_searcher is the two-way algorithm of Crochemore and Perrin: it cuts
+//     the pattern at a critical factorization, matches the right part forward and
+//     the left part backward, and never compares a byte of the text more than
+//     twice. O(n + m) time and O(1) memory, always.
+//   - simd_searcher compares the first and the last byte of the pattern against
+//     32 (AVX2) or 64 (AVX-512) positions of the text at once, and checks the rest
+//     of the pattern only where both match. On text where such pairs are rare, as
+//     in logs, this is the fastest. On text where they are not (a pattern of 'a's
+//     in a text of 'a's), it would be O(n m): when the checks take too much of the
+//     time, it hands the rest of the text to two_way_searcher.
+//
+// search, find_end, and search_n are drop-in replacements for the std algorithms.
+// search uses simd_searcher, and find_end the same filter running backward, for
+// contiguous ranges of bytes (char, signed and unsigned char, char8_t, std::byte);
+// search_n skips ahead by the length of the run it looks for, for any random-access
+// range. (Finding the runs with the kernels of simd_search.h instead is faster only
+// for runs of 2 or 3 of a rare value, and much slower for a frequent one.)
+// Anything else falls back to the std algorithm.
+namespace stl_examples::substring {
+
+namespace detail {
+
+template<class T>
+inline constexpr bool is_byte_v =
+        sizeof(T) == 1 && ((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, std::byte>);
+
+// True if [Iter, Iter) can be searched as an array of bytes.
+template<class Iter>
+inline constexpr bool is_byte_range_v = std::contiguous_iterator<Iter> && is_byte_v<std::iter_value_t<Iter>>;
+
+template<class Iter>
+const unsigned char* bytes(Iter it) {
+    return reinterpret_cast<const unsigned char*>(std::to_address(it));
+}
+
+// The maximal suffix of 'x' for the byte order (or with Reversed, the reverse order),
+// as its start minus one, and its period.
+template<bool Reversed>
+std::pair<std::ptrdiff_t, std::ptrdiff_t> maximal_suffix(const unsigned char* x, std::ptrdiff_t m) {
+    std::ptrdiff_t start = -1;
+    std::ptrdiff_t j = 0;
+    std::ptrdiff_t k = 1;
+    std::ptrdiff_t period = 1;
+    while (j + k < m) {
+        const unsigned char a = x[j + k];
+        const unsigned char b = x[start + k];
+        if (Reversed ? a > b : a < b) {
+            j += k;
+            k = 1;
+            period = j - start;
+        } else if (a == b) {
+            if (k != period) {
+                ++k;
+            } else {
+                j += period;
+                k = 1;
+            }
+        } else {
+            start = j;
+            j = start + 1;
+            k = period = 1;
+        }
+    }
+    return {start, period};
+}
+
+// The critical factorization of a pattern for the two-way algorithm.
+struct factorization {
+    std::ptrdiff_t split = -1; // The left part is [0, split].
+    std::ptrdiff_t period = 1;
+    bool periodic = true;      // Whether the left part repeats with 'period'.
+
+    factorization() = default;
+    factorization(const unsigned char* x, std::ptrdiff_t m) {
+        const auto [start, p] = maximal_suffix<false>(x, m);
+        const auto [reversed_start, q] = maximal_suffix<true>(x, m);
+        split = std::max(start, reversed_start);
+        period = start > reversed_start ? p : q;
+        periodic = split + 1 + period <= m && std::memcmp(x, x + period, static_cast<std::size_t>(split + 1)) == 0;
+        if (!periodic) period = std::max(split + 1, m - split - 1) + 1;
+    }
+};
+
+// The first position of 'x' in [y, y + n), or n.
+inline std::size_t two_way(const unsigned char* x, std::ptrdiff_t m, const factorization& f,
+                           const unsigned char* y, std::ptrdiff_t n) {
+    const std::ptrdiff_t split = f.split;
+    const std::ptrdiff_t period = f.period;
+    std::ptrdiff_t j = 0;
+    if (f.periodic) {
+        // The prefix of the pattern already known to match after a shift by the period.
+        std::ptrdiff_t memory = -1;
+        while (j <= n - m) {
+            std::ptrdiff_t i = std::max(split, memory) + 1;
+            while (i < m && x[i] == y[i + j]) ++i;
+            if (i < m) {
+                j += i - split;
+                memory = -1;
+                continue;
+            }
+            i = split;
+            while (i > memory && x[i] == y[i + j]) --i;
+            if (i <= memory) return static_cast<std::size_t>(j);
+            j += period;
+            memory = m - period - 1;
+        }
+    } else {
+        while (j <= n - m) {
+            std::ptrdiff_t i = split + 1;
+            while (i < m && x[i] == y[i + j]) ++i;
+            if (i < m) {
+                j += i - split;
+                continue;
+            }
+            i = split;
+            while (i >= 0 && x[i] == y[i + j]) --i;
+            if (i < 0) return static_cast<std::size_t>(j);
+            j += period;
+        }
+    }
+    return static_cast<std::size_t>(n);
+}
+
+// Whether the pattern is at y[0], given that its first and last bytes are.
+inline bool matches_inside(const unsigned char* x, std::size_t m, const unsigned char* y) {
+    return m <= 2 || std::memcmp(x + 1, y + 1, m - 2) == 0;
+}
+
+// Candidates checked by simd_searcher, beyond one per this many bytes of text
+// passed, before it hands the rest of the text to the two-way algorithm.
+inline constexpr std::size_t candidates_per_byte_shift = 4;
+inline constexpr std::size_t min_candidates = 256;
+
+// The scalar tail of the filters: the first position in [from, to) of the pattern
+// (or, with Backward, the last one), or 'none'.
+template<bool Backward>
+std::size_t filter_scalar(const unsigned char* x, std::size_t m, const unsigned char* y,
+                          std::size_t from, std::size_t to, std::size_t none) {
+    for (std::size_t k = from; k < to; ++k) {
+        const std::size_t i = Backward ? to - 1 - (k - from) : k;
+        if (y[i] == x[0] && y[i + m - 1] == x[m - 1] && matches_inside(x, m, y + i)) return i;
+    }
+    return none;
+}
+
+#if STL_EXAMPLES_SIMD_X86
+// One bit per position of [y, y + 32), set where the first and last bytes of the pattern match.
+STL_EXAMPLES_TARGET_AVX2 inline std::uint32_t avx2_candidates(const unsigned char* y, std::size_t m, const __m256i& first, const __m256i& last) {
+    const __m256i at_first = _mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y)));
+    const __m256i at_last = _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + m - 1)));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(at_first, at_last)));
+}
+
+STL_EXAMPLES_TARGET_AVX512 inline std::uint64_t avx512_candidates(const unsigned char* y, std::size_t m, const __m512i& first, const __m512i& last) {
+    return _mm512_cmpeq_epi8_mask(first, _mm512_loadu_si512(y)) & _mm512_cmpeq_epi8_mask(last, _mm512_loadu_si512(y + m - 1));
+}
+
+// The first position of the pattern in [y, y + n), or n; or, once the candidates
+// checked exceed the budget, the position 'i' to continue from, as 'stopped'.
+template<class Mask, std::size_t Lanes, class Candidates>
+inline std::size_t filter_forward(const unsigned char* x, std::size_t m, const unsigned char* y, std::size_t n,
+                                  std::size_t& i, bool& stopped, Candidates candidates) {
+    std::size_t checked = 0;
+    for (; i + m - 1 + Lanes <= n; i += Lanes) {
+        for (Mask mask = candidates(y + i); mask != 0; mask &= mask - 1) {
+            const std::size_t at = i + static_cast<std::size_t>(std::countr_zero(mask));
+            if (matches_inside(x, m, y + at)) return at;
+            ++checked;
+        }
+        if (checked > (i >> candidates_per_byte_shift) + min_candidates) {
+            stopped = true;
+            return n;
+        }
+    }
+    return n;
+}
+
+template<class Mask, std::size_t Lanes, class Candidates>
+inline std::size_t filter_backward(const unsigned char* x, std::size_t m, const unsigned char* y, std::size_t n,
+                                   Candidates candidates) {
+    // Positions [0, end) are left to check, from the last one.
+    std::size_t end = n - m + 1;
+    for (; end >= Lanes; end -= Lanes) {
+        for (Mask mask = candidates(y + end - Lanes); mask != 0; ) {
+            const std::size_t bit = Lanes - 1 - static_cast<std::size_t>(std::countl_zero(mask));
+            const std::size_t at = end - Lanes + bit;
+            if (matches_inside(x, m, y + at)) return at;
+            mask &= ~(Mask{1} << bit);
+        }
+    }
+    return filter_scalar<true>(x, m, y, 0, end, n);
+}
+
+STL_EXAMPLES_TARGET_AVX2 inline std::size_t search_avx2(const unsigned char* x, std::size_t m, const unsigned char* y,
+                                                        std::size_t n, std::size_t& i, bool& stopped) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(x[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(x[m - 1]));
+    const std::size_t at = filter_forward<std::uint32_t, 32>(x, m, y, n, i, stopped,
+                                                             [&](const unsigned char* p){ return avx2_candidates(p, m, first, last); });
+    if (at != n || stopped) return at;
+    return filter_scalar<false>(x, m, y, i, n - m + 1, n);
+}
+
+STL_EXAMPLES_TARGET_AVX512 inline std::size_t search_avx512(const unsigned char* x, std::size_t m, const unsigned char* y,
+                                                            std::size_t n, std::size_t& i, bool& stopped) {
+    const __m512i first = _mm512_set1_epi8(static_cast<char>(x[0]));
+    const __m512i last = _mm512_set1_epi8(static_cast<char>(x[m - 1]));
+    const std::size_t at = filter_forward<std::uint64_t, 64>(x, m, y, n, i, stopped,
+                                                             [&](const unsigned char* p){ return avx512_candidates(p, m, first, last); });
+    if (at != n || stopped) return at;
+    return filter_scalar<false>(x, m, y, i, n - m + 1, n);
+}
+
+STL_EXAMPLES_TARGET_AVX2 inline std::size_t find_end_avx2(const unsigned char* x, std::size_t m, const unsigned char* y, std::size_t n) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(x[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(x[m - 1]));
+    return filter_backward<std::uint32_t, 32>(x, m, y, n, [&](const unsigned char* p){ return avx2_candidates(p, m, first, last); });
+}
+
+STL_EXAMPLES_TARGET_AVX512 inline std::size_t find_end_avx512(const unsigned char* x, std::size_t m, const unsigned char* y, std::size_t n) {
+    const __m512i first = _mm512_set1_epi8(static_cast<char>(x[0]));
+    const __m512i last = _mm512_set1_epi8(static_cast<char>(x[m - 1]));
+    return filter_backward<std::uint64_t, 64>(x, m, y, n, [&](const unsigned char* p){ return avx512_candidates(p, m, first, last); });
+}
+#endif // STL_EXAMPLES_SIMD_X86
+
+// The last position of 'x' in [y, y + n), or n, by the Horspool algorithm run
+// backward: the shift is the distance to the first occurrence of the first byte
+// of the window in the pattern.
+inline std::size_t find_end_scalar(const unsigned char* x, std::size_t m, const unsigned char* y, std::size_t n) {
+    std::array<std::size_t, 256> shift;
+    shift.fill(m);
+    for (std::size_t i = m - 1; i > 0; --i) shift[x[i]] = i;
+    std::size_t i = n - m;
+    for (;;) {
+        if (y[i] == x[0] && matches_inside(x, m, y + i) && y[i + m - 1] == x[m - 1]) return i;
+        const std::size_t step = shift[y[i]];
+        if (i < step) return n;
+        i -= step;
+    }
+}
+
+template<class Iter>
+std::pair<Iter, Iter> found(Iter first, Iter last, std::size_t at, std::size_t m) {
+    if (at == static_cast<std::size_t>(last - first)) return {last, last};
+    return {first + at, first + (at + m)};
+}
+
+} // namespace detail
+
+template<class PatternIt>
+class horspool_searcher {
+    static_assert(detail::is_byte_range_v<PatternIt>, "horspool_searcher searches for contiguous ranges of bytes");
+
+public:
+    horspool_searcher(PatternIt pattern_first, PatternIt pattern_last)
+        : pattern_(detail::bytes(pattern_first)), m_(static_cast<std::size_t>(pattern_last - pattern_first)) {
+        shift_.fill(m_);
+        for (std::size_t i = 0; i + 1 < m_; ++i) shift_[pattern_[i]] = m_ - 1 - i;
+    }
+
+    template<class Iter>
+    std::pair<Iter, Iter> operator()(Iter first, Iter last) const {
+        static_assert(detail::is_byte_range_v<Iter>, "horspool_searcher searches contiguous ranges of bytes");
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        const std::size_t m = m_;
+        if (m == 0) return {first, first};
+        if (m > n) return {last, last};
+        const unsigned char* y = detail::bytes(first);
+        // Compares each window from its last byte, which also gives the shift.
+        for (std::size_t i = 0; i <= n - m; i += shift_[y[i + m - 1]]) {
+            for (std::size_t k = m - 1; pattern_[k] == y[i + k]; --k) {
+                if (k == 0) return detail::found(first, last, i, m);
+            }
+        }
+        return {last, last};
+    }
+
+private:
+    const unsigned char* pattern_;
+    std::size_t m_;
+    std::array<std::size_t, 256> shift_;
+};
+
+template<class PatternIt>
+class two_way_searcher {
+    static_assert(detail::is_byte_range_v<PatternIt>, "two_way_searcher searches for contiguous ranges of bytes");
+
+public:
+    two_way_searcher(PatternIt pattern_first, PatternIt pattern_last)
+        : pattern_(detail::bytes(pattern_first)), m_(static_cast<std::size_t>(pattern_last - pattern_first)),
+          factorization_(pattern_, static_cast<std::ptrdiff_t>(m_)) {}
+
+    template<class Iter>
+    std::pair<Iter, Iter> operator()(Iter first, Iter last) const {
+        static_assert(detail::is_byte_range_v<Iter>, "two_way_searcher searches contiguous ranges of bytes");
+        if (m_ == 0) return {first, first};
+        const auto n = last - first;
+        const std::size_t at = detail::two_way(pattern_, static_cast<std::ptrdiff_t>(m_), factorization_, detail::bytes(first), n);
+        return detail::found(first, last, at, m_);
+    }
+
+private:
+    const unsigned char* pattern_;
+    std::size_t m_;
+    detail::factorization factorization_;
+};
+
+template<class PatternIt>
+class simd_searcher {
+    static_assert(detail::is_byte_range_v<PatternIt>, "simd_searcher searches for contiguous ranges of bytes");
+
+public:
+    simd_searcher(PatternIt pattern_first, PatternIt pattern_last)
+        : pattern_(detail::bytes(pattern_first)), m_(static_cast<std::size_t>(pattern_last - pattern_first)),
+          factorization_(pattern_, static_cast<std::ptrdiff_t>(m_)) {}
+
+    template<class Iter>
+    std::pair<Iter, Iter> operator()(Iter first, Iter last) const {
+        static_assert(detail::is_byte_range_v<Iter>, "simd_searcher searches contiguous ranges of bytes");
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        if (m_ == 0) return {first, first};
+        if (m_ > n) return {last, last};
+        const unsigned char* y = detail::bytes(first);
+        if (m_ == 1) {
+            const void* at = std::memchr(y, pattern_[0], n);
+            return detail::found(first, last, at == nullptr ? n : static_cast<std::size_t>(static_cast<const unsigned char*>(at) - y), 1);
+        }
+
+        // Where the filter stopped, if it did.
+        std::size_t i = 0;
+        bool stopped = false;
+#if STL_EXAMPLES_SIMD_X86
+        switch (simd::level()) {
+            case simd::Level::avx512: {
+                const std::size_t at = detail::search_avx512(pattern_, m_, y, n, i, stopped);
+                if (!stopped) return detail::found(first, last, at, m_);
+                break;
+            }
+            case simd::Level::avx2: {
+                const std::size_t at = detail::search_avx2(pattern_, m_, y, n, i, stopped);
+                if (!stopped) return detail::found(first, last, at, m_);
+                break;
+            }
+            case simd::Level::scalar: break;
+        }
+#endif
+        const std::size_t rest = detail::two_way(pattern_, static_cast<std::ptrdiff_t>(m_), factorization_, y + i,
+                                                 static_cast<std::ptrdiff_t>(n - i));
+        return detail::found(first, last, rest == n - i ? n : i + rest, m_);
+    }
+
+private:
+    const unsigned char* pattern_;
+    std::size_t m_;
+    detail::factorization factorization_;
+};
+
+template<class Iter1, class Iter2>
+Iter1 search(Iter1 first, Iter1 last, Iter2 s_first, Iter2 s_last) {
+    if constexpr (detail::is_byte_range_v<Iter1> && detail::is_byte_range_v<Iter2> &&
+                  std::is_same_v<std::iter_value_t<Iter1>, std::iter_value_t<Iter2>>) {
+        return simd_searcher(s_first, s_last)(first, last).first;
+    } else {
+        return std::search(first, last, s_first, s_last);
+    }
+}
+
+// Like std::find_end: the last occurrence of [s_first, s_last), or 'last' if
+// there is none or it is empty.
+template<class Iter1, class Iter2>
+Iter1 find_end(Iter1 first, Iter1 last, Iter2 s_first, Iter2 s_last) {
+    if constexpr (detail::is_byte_range_v<Iter1> && detail::is_byte_range_v<Iter2> &&
+                  std::is_same_v<std::iter_value_t<Iter1>, std::iter_value_t<Iter2>>) {
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        const std::size_t m = static_cast<std::size_t>(s_last - s_first);
+        if (m == 0 || m > n) return last;
+        const unsigned char* x = detail::bytes(s_first);
+        const unsigned char* y = detail::bytes(first);
+#if STL_EXAMPLES_SIMD_X86
+        switch (simd::level()) {
+            case simd::Level::avx512: return first + detail::find_end_avx512(x, m, y, n);
+            case simd::Level::avx2: return first + detail::find_end_avx2(x, m, y, n);
+            case simd::Level::scalar: break;
+        }
+#endif
+        return first + detail::find_end_scalar(x, m, y, n);
+    } else {
+        return std::find_end(first, last, s_first, s_last);
+    }
+}
+
+// Like std::search_n: the first run of 'count' elements equal to 'value' (as
+// pred(element, value)). Checks the last element of each window first: if it
+// does not match, no run of 'count' can start in the window, which is skipped
+// whole.
+template<class Iter, class Size, class T, class BinaryPred>
+Iter search_n(Iter first, Iter last, Size count, const T& value, BinaryPred pred) {
+    if constexpr (std::random_access_iterator<Iter>) {
+        if (count <= 0) return first;
+        const auto n = last - first;
+        const auto length = static_cast<std::iter_difference_t<Iter>>(count);
+        std::iter_difference_t<Iter> i = 0;
+        while (n - i >= length) {
+            // A run has to reach the last element of the window.
+            if (!pred(first[i + length - 1], value)) {
+                i += length;
+                continue;
+            }
+            // It then starts after the last element of the window that does not match.
+            auto start = i + length - 1;
+            while (start > i && pred(first[start - 1], value)) --start;
+            if (start == i) return first + i;
+            // The run ends before the window [start, start + length) does, or fits in it.
+            auto end = i + length;
+            while (end < start + length && end < n && pred(first[end], value)) ++end;
+            if (end == start + length) return first + start;
+            i = end + 1;
+        }
+        return last;
+    } else {
+        return std::search_n(first, last, count, value, pred);
+    }
+}
+
+template<class Iter, class Size, class T>
+Iter search_n(Iter first, Iter last, Size count, const T& value) {
+    return substring::search_n(first, last, count, value, std::equal_to<>());
+}
+
+} // namespace stl_examples::substring
+
+#endif // STL_EXAMPLES_SUBSTRING_SEARCH_H